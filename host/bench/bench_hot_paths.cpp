@@ -0,0 +1,201 @@
+//
+// bench_hot_paths.cpp
+//
+// Host benchmarks of the command and motion hot paths, the same cases as
+// BENCH_CMD measures on the target: decoding of a transfer per opcode,
+// keyframe queue and node allocator, one motion tick for 8 to 128
+// channels, Meccano frame encoding and reply decoding.  The firmware
+// modules are those of the host build, booted on the simulated board.
+//
+//     host_benchmarks --benchmark_out=bench.json --benchmark_out_format=json
+//
+// Two runs are compared with compare.py of Google Benchmark.
+//
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "sim.h"
+#include "protocol.h"
+#include "meccano_protocol.h"
+#include "linked_list_dbl.h"
+extern "C" {
+#include "command.h"
+#include "motion.h"
+}
+
+namespace {
+
+constexpr size_t kPacket = SIM_USB_PACKET;
+
+//*****************************************************************************
+//
+// Decoding of a full packet of one opcode.  The commands answer nothing,
+// a reply would measure the transmit ring as well.
+//
+//*****************************************************************************
+std::vector<uint8_t> decodeCommand(uint8_t opcode)
+{
+    switch(opcode)
+    {
+    case SERVO_DIRECT_CMD:
+        return {SERVO_DIRECT_CMD, 3, 0, 0, 0x0B, 0xB8};
+    case DC_SPEED_CMD:
+        return {DC_SPEED_CMD, 0x10, 0x00, 0x10, 0x00};
+    case MECCANO_SERVO_POS_CMD:
+        return {MECCANO_SERVO_POS_CMD, 0, 0x80};
+    case MECCANO_LED_CMD:
+        return {MECCANO_LED_CMD, 1, 2, 3, 0};
+    case TELEMETRY_CMD:
+        return {TELEMETRY_CMD, 0, 0, 0};
+    case SEQ_CMD:
+        return {SEQ_CMD, 1};
+    default:
+        // SERVO_MVMT_CMD is reserved, decoded and skipped
+        return {SERVO_MVMT_CMD, 0, 0, 0, 0};
+    }
+}
+
+void BM_Decode(benchmark::State &state)
+{
+    std::vector<uint8_t> command = decodeCommand(uint8_t(state.range(0)));
+    std::vector<uint8_t> transfer;
+    size_t commands = kPacket / command.size();
+
+    for(size_t i = 0; i < commands; i++)
+        transfer.insert(transfer.end(), command.begin(), command.end());
+    simBoardInit();
+
+    for(auto _ : state)
+        CommandDeferred(transfer.data(), uint32_t(transfer.size()));
+    state.SetItemsProcessed(int64_t(state.iterations() * commands));
+    state.SetBytesProcessed(int64_t(state.iterations() * transfer.size()));
+}
+BENCHMARK(BM_Decode)
+    ->ArgName("opcode")
+    ->Arg(SERVO_MVMT_CMD)->Arg(SERVO_DIRECT_CMD)->Arg(DC_SPEED_CMD)
+    ->Arg(MECCANO_SERVO_POS_CMD)->Arg(MECCANO_LED_CMD)
+    ->Arg(TELEMETRY_CMD)->Arg(SEQ_CMD);
+
+//*****************************************************************************
+//
+// Keyframe queue: an action appended behind range(0) others and removed.
+//
+//*****************************************************************************
+void BM_ListInsertDelete(benchmark::State &state)
+{
+    struct list_s list = {nullptr, nullptr};
+    uint32_t depth = uint32_t(state.range(0));
+
+    for(uint32_t i = 0; i < depth; i++)
+        Insert(&list, i, i, i, 0);
+    if(listLength(&list) != depth)
+        state.SkipWithError("node store too small");
+
+    uint32_t iteration = 0;
+    for(auto _ : state)
+    {
+        Insert(&list, 0xFFFFFFFF, 0xFFFFFFFF, iteration++, 0);
+        listDelete(&list, false);
+    }
+    Free_list(&list);
+    state.SetItemsProcessed(int64_t(state.iterations()));
+}
+BENCHMARK(BM_ListInsertDelete)
+    ->ArgName("queued")->Arg(0)->Arg(1)->Arg(4)->Arg(16)->Arg(LIST_NODE_MAX - 1);
+
+// Node allocator with range(0) nodes already taken
+void BM_AllocateFree(benchmark::State &state)
+{
+    std::vector<struct list_node_s *> taken;
+
+    for(int64_t i = 0; i < state.range(0); i++)
+        taken.push_back(Allocate_node());
+
+    for(auto _ : state)
+    {
+        struct list_node_s *node_p = Allocate_node();
+
+        benchmark::DoNotOptimize(node_p);
+        Free_node(node_p);
+    }
+    for(struct list_node_s *node_p : taken)
+        Free_node(node_p);
+    state.SetItemsProcessed(int64_t(state.iterations()));
+}
+BENCHMARK(BM_AllocateFree)
+    ->ArgName("taken")->Arg(0)->Arg(8)->Arg(LIST_NODE_MAX - 1);
+
+//*****************************************************************************
+//
+// One motion tick: every channel interpolates an action that never ends.
+//
+//*****************************************************************************
+void BM_MotionTick(benchmark::State &state)
+{
+    size_t channels = size_t(state.range(0));
+    std::vector<struct list_node_s> nodes(channels);
+    std::vector<struct list_s> lists(channels);
+    uint32_t pos = 0;
+    uint32_t now = 0;
+
+    for(size_t i = 0; i < channels; i++)
+    {
+        nodes[i] = {};
+        nodes[i].ms_time_start = 0;
+        nodes[i].ms_time_stop = 0x10000;
+        nodes[i].position = uint32_t(4000 - i * 16);
+        lists[i].h_p = lists[i].t_p = &nodes[i];
+    }
+
+    for(auto _ : state)
+    {
+        for(size_t i = 0; i < channels; i++)
+            motionStep(&lists[i], 0, now & 0xFFFF, uint32_t(i * 64), uint8_t(i), &pos);
+        benchmark::DoNotOptimize(pos);
+        now++;
+    }
+    state.SetItemsProcessed(int64_t(state.iterations() * channels));
+}
+BENCHMARK(BM_MotionTick)->ArgName("channels")->Arg(8)->Arg(32)->Arg(128);
+
+//*****************************************************************************
+//
+// Meccano chain: frame encoding and reply decoding.
+//
+//*****************************************************************************
+void BM_MeccanoFrameEncode(benchmark::State &state)
+{
+    struct meccano_chain chain;
+
+    meccanoChainInit(&chain);
+    for(auto _ : state)
+    {
+        meccanoFrameEncode(&chain);
+        benchmark::DoNotOptimize(chain.frame);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()));
+}
+BENCHMARK(BM_MeccanoFrameEncode);
+
+void BM_MeccanoReplyDecode(benchmark::State &state)
+{
+    struct meccano_chain chain;
+    uint8_t reply = uint8_t(state.range(0));
+
+    meccanoChainInit(&chain);
+    for(auto _ : state)
+    {
+        meccanoReplyDecode(&chain, reply);
+        benchmark::DoNotOptimize(chain.inputByte);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()));
+}
+BENCHMARK(BM_MeccanoReplyDecode)
+    ->ArgName("reply")->Arg(MECCANO_REPLY_NONE)->Arg(MECCANO_REPLY_SERVO)
+    ->Arg(MECCANO_REPLY_PRESENT);
+
+}  // namespace
+
+BENCHMARK_MAIN();
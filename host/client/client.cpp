@@ -0,0 +1,109 @@
+//
+// client.cpp
+//
+// Pipelined client of the bulk protocol, see client.h.
+//
+#include <algorithm>
+
+#include "client.h"
+
+#include "protocol.h"
+#include "command.h"
+#include "telemetry.h"
+
+namespace bulk {
+
+Client::Client(Transport &transport, size_t frameBytes, size_t maxInFlight)
+    : transport_(transport), frameBytes_(frameBytes),
+      maxInFlight_(std::max<size_t>(maxInFlight, 1))
+{
+    transport_.setReceiver([this](const uint8_t *data, size_t size) {
+        stats_.bytesIn += size;
+        decoder_.push(data, size, [this](const Message &message) { dispatch(message); });
+        stats_.skipped = decoder_.skipped();
+    });
+}
+
+void Client::send(const Command &command)
+{
+    // The decoder needs the channels to cut the telemetry packets
+    if((command.size() >= 4) && (command[0] == TELEMETRY_CMD))
+        decoder_.setTelemetryChannels(command[3]);
+
+    if(!frame_.empty() && (frame_.size() + command.size() > frameBytes_))
+        flush();
+    frame_.insert(frame_.end(), command.begin(), command.end());
+    stats_.commands++;
+    if(frame_.size() >= frameBytes_)
+        flush();
+}
+
+uint8_t Client::sendSequenced(const Command &command)
+{
+    Command sequenced = cmd::seq(++seq_);
+
+    sequenced.insert(sequenced.end(), command.begin(), command.end());
+    send(sequenced);
+    return seq_;
+}
+
+void Client::flush()
+{
+    if(frame_.empty())
+        return;
+    frames_.push_back(std::move(frame_));
+    frame_.clear();
+    pump();
+}
+
+void Client::pump()
+{
+    while(!frames_.empty() && (inFlight_ < maxInFlight_))
+    {
+        Command frame = std::move(frames_.front());
+        size_t size = frame.size();
+
+        frames_.pop_front();
+        inFlight_++;
+        stats_.maxInFlight = std::max(stats_.maxInFlight, inFlight_);
+        if(!transport_.submit(std::move(frame), [this](bool ok) {
+               inFlight_--;
+               if(!ok)
+                   stats_.failed++;
+           }))
+        {
+            inFlight_--;
+            stats_.failed++;
+            continue;
+        }
+        stats_.frames++;
+        stats_.bytesOut += size;
+    }
+}
+
+bool Client::poll(int timeoutMs)
+{
+    bool open;
+
+    flush();
+    pump();
+    open = transport_.poll(timeoutMs);
+    pump();
+    return open;
+}
+
+void Client::dispatch(const Message &message)
+{
+    Ack ack;
+    Telemetry telemetry;
+
+    stats_.messages++;
+    if(ack_ && decodeAck(message, ack))
+        ack_(ack);
+    else if(telemetry_ && decodeTelemetry(message, telemetry))
+        telemetry_(telemetry);
+    else if(message_ && (message.opcode != ACK_MSG) && (message.opcode != TELEMETRY_MSG))
+        message_(message);
+}
+
+}  // namespace bulk
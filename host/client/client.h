@@ -0,0 +1,95 @@
+//
+// client.h
+//
+// Pipelined client of the bulk protocol.  Commands are queued with send()
+// and coalesced into frames of at most frameBytes, so that a burst of
+// small commands costs one transfer instead of one each; the firmware
+// executes the commands of a transfer back to back.  Up to maxInFlight
+// frames are submitted without waiting for the previous ones.  The device
+// messages are cut and handed to the callbacks from poll().
+//
+//     bulk::SocketTransport transport("/tmp/usb_emulator.sock");
+//     bulk::Client client(transport);
+//
+//     client.onAck([](const bulk::Ack &ack) { ... });
+//     client.send(bulk::cmd::servoDirect(0, 3000));
+//     client.sendSequenced(bulk::cmd::servoStartMovement(0x03));
+//     while((client.queued() != 0) || (client.inFlight() != 0))
+//         client.poll(10);
+//
+#ifndef BULK_CLIENT_H_
+#define BULK_CLIENT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include "commands.h"
+#include "messages.h"
+#include "transport.h"
+
+namespace bulk {
+
+struct ClientStats {
+    uint64_t commands = 0;
+    uint64_t frames = 0;                // OUT transfers submitted
+    uint64_t bytesOut = 0;
+    uint64_t bytesIn = 0;
+    uint64_t messages = 0;
+    uint64_t skipped = 0;               // bytes that started no message
+    uint64_t failed = 0;                // transfers not completed
+    size_t maxInFlight = 0;
+};
+
+class Client {
+public:
+    // One full-speed packet per frame, four frames in flight
+    explicit Client(Transport &transport, size_t frameBytes = 64,
+                    size_t maxInFlight = 4);
+
+    void onAck(std::function<void(const Ack &)> callback) { ack_ = std::move(callback); }
+    void onTelemetry(std::function<void(const Telemetry &)> callback) { telemetry_ = std::move(callback); }
+    // Replies and the other messages: trace, log, event
+    void onMessage(std::function<void(const Message &)> callback) { message_ = std::move(callback); }
+
+    // Queues a command in the frame being filled.  A command longer than
+    // a frame goes alone in a transfer of its own.
+    void send(const Command &command);
+    // Same, preceded by SEQ_CMD; returns its sequence number
+    uint8_t sendSequenced(const Command &command);
+
+    // Closes the frame being filled, it is submitted as soon as there is
+    // room in flight
+    void flush();
+
+    // flush(), submits what it can and runs the transport for timeoutMs;
+    // false once the transport is closed
+    bool poll(int timeoutMs);
+
+    size_t inFlight() const { return inFlight_; }
+    size_t queued() const { return frames_.size() + (frame_.empty() ? 0 : 1); }
+    const ClientStats &stats() const { return stats_; }
+
+private:
+    void pump();
+    void dispatch(const Message &message);
+
+    Transport &transport_;
+    size_t frameBytes_;
+    size_t maxInFlight_;
+    Command frame_;
+    std::deque<Command> frames_;
+    size_t inFlight_ = 0;
+    uint8_t seq_ = 0;
+    Decoder decoder_;
+    ClientStats stats_;
+    std::function<void(const Ack &)> ack_;
+    std::function<void(const Telemetry &)> telemetry_;
+    std::function<void(const Message &)> message_;
+};
+
+}  // namespace bulk
+
+#endif /* BULK_CLIENT_H_ */
@@ -0,0 +1,330 @@
+//
+// commands.cpp
+//
+// Encoders of the commands, see commands.h and the parsing of each opcode
+// in command.c.
+//
+#include <stdexcept>
+#include <string>
+
+#include "commands.h"
+
+#include "protocol.h"
+#include "schedule.h"
+
+namespace bulk {
+
+namespace {
+
+void put16(Command &c, uint32_t value)
+{
+    c.push_back(uint8_t(value >> 8));
+    c.push_back(uint8_t(value));
+}
+
+void put32(Command &c, uint32_t value)
+{
+    put16(c, value >> 16);
+    put16(c, value);
+}
+
+void put64(Command &c, uint64_t value)
+{
+    put32(c, uint32_t(value >> 32));
+    put32(c, uint32_t(value));
+}
+
+uint8_t count(size_t size, const char *what)
+{
+    if(size > 0xFF)
+        throw std::invalid_argument(std::string(what) + ": more than 255 keyframes");
+    return uint8_t(size);
+}
+
+Command charge(uint8_t opcode, const std::vector<Keyframe> &keyframes)
+{
+    Command c = {opcode, count(keyframes.size(), "charge movement")};
+
+    for(const Keyframe &k : keyframes)
+    {
+        c.push_back(k.channel);
+        put32(c, k.startMs);
+        put32(c, k.stopMs);
+        put32(c, k.value);
+    }
+    return c;
+}
+
+}  // namespace
+
+
+namespace cmd {
+
+Command dcDirect(uint8_t rightDirection, uint32_t rightMatch,
+                 uint8_t leftDirection, uint32_t leftMatch)
+{
+    Command c = {DC_DIRECT_CMD, rightDirection};
+
+    put32(c, rightMatch);
+    c.push_back(leftDirection);
+    put32(c, leftMatch);
+    return c;
+}
+
+Command dcMovement(int32_t leftSpeed, int32_t rightSpeed,
+                   uint16_t rampMs, uint32_t cruiseMs)
+{
+    Command c = {DC_MVMT_CMD};
+
+    put32(c, uint32_t(leftSpeed));
+    put32(c, uint32_t(rightSpeed));
+    put16(c, rampMs);
+    put32(c, cruiseMs);
+    return c;
+}
+
+Command dcStartMovement(uint8_t mask)
+{
+    return {DC_START_MVMT_CMD, mask};
+}
+
+Command dcChargeMovement(const std::vector<Keyframe> &keyframes)
+{
+    return charge(DC_CHARGE_MVMT_CMD, keyframes);
+}
+
+Command dcGetPosition()
+{
+    return {DC_GET_POSITION_CMD};
+}
+
+Command dcPid(bool closedLoop, uint16_t kp, uint16_t ki, uint16_t kd,
+              uint16_t velocityMax)
+{
+    Command c = {DC_PID_CMD, uint8_t(closedLoop ? 1 : 0)};
+
+    put16(c, kp);
+    put16(c, ki);
+    put16(c, kd);
+    put16(c, velocityMax);
+    return c;
+}
+
+Command driveVelocity(int16_t v, int16_t omega)
+{
+    Command c = {DRIVE_VELOCITY_CMD};
+
+    put16(c, uint16_t(v));
+    put16(c, uint16_t(omega));
+    return c;
+}
+
+Command drivePose(int16_t dx, int16_t dy, int16_t dtheta, int16_t vmax)
+{
+    Command c = {DRIVE_POSE_CMD};
+
+    put16(c, uint16_t(dx));
+    put16(c, uint16_t(dy));
+    put16(c, uint16_t(dtheta));
+    put16(c, uint16_t(vmax));
+    return c;
+}
+
+Command driveOdometryReset()
+{
+    return {DRIVE_ODOMETRY_RESET_CMD};
+}
+
+Command dcSpeed(int16_t left, int16_t right)
+{
+    Command c = {DC_SPEED_CMD};
+
+    put16(c, uint16_t(left));
+    put16(c, uint16_t(right));
+    return c;
+}
+
+Command dcPwm(uint32_t frequency, uint8_t bits, uint8_t decay)
+{
+    Command c = {DC_PWM_CMD};
+
+    put32(c, frequency);
+    c.push_back(bits);
+    c.push_back(decay);
+    return c;
+}
+
+Command servoDirect(uint8_t output, uint32_t width)
+{
+    Command c = {SERVO_DIRECT_CMD, output};
+
+    put32(c, width);
+    return c;
+}
+
+Command servoStartMovement(uint8_t mask)
+{
+    return {SERVO_START_MVMT_CMD, mask};
+}
+
+Command servoChargeMovement(const std::vector<Keyframe> &keyframes)
+{
+    return charge(SERVO_CHARGE_MVMT_CMD, keyframes);
+}
+
+Command meccanoServoPosition(uint8_t servo, uint8_t position)
+{
+    return {MECCANO_SERVO_POS_CMD, servo, position};
+}
+
+Command meccanoServoLed(uint8_t servo, uint8_t colour)
+{
+    return {MECCANO_SERVO_LED_CMD, servo, colour};
+}
+
+Command meccanoLed(uint8_t red, uint8_t green, uint8_t blue, uint8_t time)
+{
+    return {MECCANO_LED_CMD, red, green, blue, time};
+}
+
+Command meccanoLedSequence(uint8_t loops, const std::vector<LedKeyframe> &keyframes)
+{
+    Command c = {MECCANO_LED_SEQ_CMD, loops, count(keyframes.size(), "LED sequence")};
+
+    for(const LedKeyframe &k : keyframes)
+    {
+        c.insert(c.end(), {k.red, k.green, k.blue, k.time});
+        put16(c, k.holdMs);
+    }
+    return c;
+}
+
+Command meccanoServoLedSequence(uint8_t servo, uint8_t loops,
+                                const std::vector<ColourKeyframe> &keyframes)
+{
+    Command c = {MECCANO_SERVO_LED_SEQ_CMD, servo, loops,
+                 count(keyframes.size(), "servo LED sequence")};
+
+    for(const ColourKeyframe &k : keyframes)
+    {
+        c.push_back(k.colour);
+        put16(c, k.holdMs);
+    }
+    return c;
+}
+
+Command meccanoRecord(uint8_t servoMask, uint8_t tolerance)
+{
+    return {MECCANO_RECORD_CMD, servoMask, tolerance};
+}
+
+Command meccanoGetRecord(uint8_t kind, uint16_t offset)
+{
+    Command c = {MECCANO_GET_RECORD_CMD, kind};
+
+    put16(c, offset);
+    return c;
+}
+
+Command meccanoReplay()
+{
+    return {MECCANO_REPLAY_CMD};
+}
+
+Command meccanoGetErrors(bool clear)
+{
+    return {MECCANO_GET_ERRORS_CMD, uint8_t(clear ? 1 : 0)};
+}
+
+Command telemetry(uint16_t periodMs, uint8_t channels)
+{
+    Command c = {TELEMETRY_CMD};
+
+    put16(c, periodMs);
+    c.push_back(channels);
+    return c;
+}
+
+Command currentLimit(uint16_t dcMilliAmp, uint16_t servoMilliAmp)
+{
+    Command c = {CURRENT_LIMIT_CMD};
+
+    put16(c, dcMilliAmp);
+    put16(c, servoMilliAmp);
+    return c;
+}
+
+Command profile(uint8_t handler, bool clear)
+{
+    return {PROFILE_CMD, handler, uint8_t(clear ? 1 : 0)};
+}
+
+Command trace(uint8_t categories)
+{
+    return {TRACE_CMD, categories};
+}
+
+Command log(uint8_t level)
+{
+    return {LOG_CMD, level};
+}
+
+Command metrics()
+{
+    return {METRICS_CMD};
+}
+
+Command bench(uint8_t benchmark, uint8_t param, uint16_t iterations)
+{
+    Command c = {BENCH_CMD, benchmark, param};
+
+    put16(c, iterations);
+    return c;
+}
+
+Command ping(uint64_t stamp)
+{
+    Command c = {PING_CMD};
+
+    put64(c, stamp);
+    return c;
+}
+
+Command latency(uint8_t channel, bool clear)
+{
+    return {LATENCY_CMD, channel, uint8_t(clear ? 1 : 0)};
+}
+
+Command seq(uint8_t number)
+{
+    return {SEQ_CMD, number};
+}
+
+Command event(uint8_t mask)
+{
+    return {EVENT_CMD, mask};
+}
+
+Command time(uint64_t stamp)
+{
+    Command c = {TIME_CMD};
+
+    put64(c, stamp);
+    return c;
+}
+
+Command at(uint32_t ms, const Command &commands)
+{
+    Command c = {AT_CMD};
+
+    if(commands.size() > SCHED_CMD_MAX)
+        throw std::invalid_argument("at: more than SCHED_CMD_MAX bytes of commands");
+    put32(c, ms);
+    c.push_back(uint8_t(commands.size()));
+    c.insert(c.end(), commands.begin(), commands.end());
+    return c;
+}
+
+}  // namespace cmd
+
+}  // namespace bulk
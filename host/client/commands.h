@@ -0,0 +1,98 @@
+//
+// commands.h
+//
+// Typed encoders of the commands of protocol.h, one per opcode the
+// firmware executes.  Each returns the bytes of the command, ready to be
+// queued on a Client or written as they are; values are sent most
+// significant byte first.  Arguments that cannot be encoded, such as
+// more keyframes than a count byte holds, throw std::invalid_argument.
+//
+// SERVO_MVMT_CMD and SERVO_GET_POSITION_CMD are not implemented by the
+// firmware and have no encoder.
+//
+#ifndef BULK_COMMANDS_H_
+#define BULK_COMMANDS_H_
+
+#include <cstdint>
+#include <vector>
+
+namespace bulk {
+
+using Command = std::vector<uint8_t>;
+
+// Keyframe of DC_CHARGE_MVMT_CMD and SERVO_CHARGE_MVMT_CMD: value reached
+// at stopMs, a signed speed for the DC motors, a width or a Meccano
+// position for the servos
+struct Keyframe {
+    uint8_t channel;
+    uint32_t startMs;
+    uint32_t stopMs;
+    uint32_t value;
+};
+
+struct LedKeyframe {
+    uint8_t red, green, blue;
+    uint8_t time;                       // fade, Meccano units
+    uint16_t holdMs;
+};
+
+struct ColourKeyframe {
+    uint8_t colour;                     // MECCANO_SERVO_*
+    uint16_t holdMs;
+};
+
+namespace cmd {
+
+// DC motors and drive
+Command dcDirect(uint8_t rightDirection, uint32_t rightMatch,
+                 uint8_t leftDirection, uint32_t leftMatch);
+Command dcMovement(int32_t leftSpeed, int32_t rightSpeed,
+                   uint16_t rampMs, uint32_t cruiseMs);
+Command dcStartMovement(uint8_t mask);
+Command dcChargeMovement(const std::vector<Keyframe> &keyframes);
+Command dcGetPosition();
+Command dcPid(bool closedLoop, uint16_t kp, uint16_t ki, uint16_t kd,
+              uint16_t velocityMax);
+Command driveVelocity(int16_t v, int16_t omega);
+Command drivePose(int16_t dx, int16_t dy, int16_t dtheta, int16_t vmax);
+Command driveOdometryReset();
+Command dcSpeed(int16_t left, int16_t right);
+Command dcPwm(uint32_t frequency, uint8_t bits, uint8_t decay);
+
+// PWM servos
+Command servoDirect(uint8_t output, uint32_t width);
+Command servoStartMovement(uint8_t mask);
+Command servoChargeMovement(const std::vector<Keyframe> &keyframes);
+
+// Meccano chain
+Command meccanoServoPosition(uint8_t servo, uint8_t position);
+Command meccanoServoLed(uint8_t servo, uint8_t colour);
+Command meccanoLed(uint8_t red, uint8_t green, uint8_t blue, uint8_t time);
+Command meccanoLedSequence(uint8_t loops, const std::vector<LedKeyframe> &keyframes);
+Command meccanoServoLedSequence(uint8_t servo, uint8_t loops,
+                                const std::vector<ColourKeyframe> &keyframes);
+Command meccanoRecord(uint8_t servoMask, uint8_t tolerance);
+Command meccanoGetRecord(uint8_t kind, uint16_t offset);
+Command meccanoReplay();
+Command meccanoGetErrors(bool clear);
+
+// Instrumentation and control of the link
+Command telemetry(uint16_t periodMs, uint8_t channels);
+Command currentLimit(uint16_t dcMilliAmp, uint16_t servoMilliAmp);
+Command profile(uint8_t handler, bool clear);
+Command trace(uint8_t categories);
+Command log(uint8_t level);
+Command metrics();
+Command bench(uint8_t benchmark, uint8_t param, uint16_t iterations);
+Command ping(uint64_t stamp);
+Command latency(uint8_t channel, bool clear);
+Command seq(uint8_t number);
+Command event(uint8_t mask);
+Command time(uint64_t stamp);
+Command at(uint32_t ms, const Command &commands);
+
+}  // namespace cmd
+
+}  // namespace bulk
+
+#endif /* BULK_COMMANDS_H_ */
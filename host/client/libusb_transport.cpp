@@ -0,0 +1,142 @@
+//
+// libusb_transport.cpp
+//
+// Transport on the board through libusb-1.0, see libusb_transport.h.
+//
+#include <stdexcept>
+#include <string>
+
+#include <libusb.h>
+
+#include "libusb_transport.h"
+
+namespace bulk {
+
+//*****************************************************************************
+//
+// Completions, run by libusb from poll().  The IN transfers are submitted
+// again until the transport closes; each OUT transfer is freed with its
+// data once done.
+//
+//*****************************************************************************
+struct LibusbCallbacks {
+    struct Out {
+        LibusbTransport *self;
+        std::vector<uint8_t> data;
+        Transport::Done done;
+    };
+
+    static void LIBUSB_CALL outDone(libusb_transfer *transfer)
+    {
+        Out *out = static_cast<Out *>(transfer->user_data);
+        bool ok = (transfer->status == LIBUSB_TRANSFER_COMPLETED) &&
+                  (transfer->actual_length == transfer->length);
+
+        if(transfer->status == LIBUSB_TRANSFER_NO_DEVICE)
+            out->self->closed_ = true;
+        out->self->pending_--;
+        if(out->done)
+            out->done(ok);
+        delete out;
+        libusb_free_transfer(transfer);
+    }
+
+    static void LIBUSB_CALL inDone(libusb_transfer *transfer)
+    {
+        LibusbTransport *self = static_cast<LibusbTransport *>(transfer->user_data);
+
+        if((transfer->status == LIBUSB_TRANSFER_COMPLETED) &&
+           (transfer->actual_length > 0) && self->receiver_)
+            self->receiver_(transfer->buffer, size_t(transfer->actual_length));
+        if((transfer->status == LIBUSB_TRANSFER_NO_DEVICE) ||
+           (transfer->status == LIBUSB_TRANSFER_ERROR))
+            self->closed_ = true;
+        if(self->closed_ || (transfer->status == LIBUSB_TRANSFER_CANCELLED) ||
+           (libusb_submit_transfer(transfer) != 0))
+            self->pending_--;
+    }
+};
+
+
+LibusbTransport::LibusbTransport(uint16_t vendor, uint16_t product,
+                                 int inTransfers, int inSize)
+{
+    if(libusb_init(&context_) != 0)
+        throw std::runtime_error("libusb: cannot initialise");
+    handle_ = libusb_open_device_with_vid_pid(context_, vendor, product);
+    if(handle_ == nullptr)
+    {
+        libusb_exit(context_);
+        throw std::runtime_error("libusb: no board found");
+    }
+    libusb_set_auto_detach_kernel_driver(handle_, 1);
+    if(libusb_claim_interface(handle_, 0) != 0)
+    {
+        libusb_close(handle_);
+        libusb_exit(context_);
+        throw std::runtime_error("libusb: interface busy");
+    }
+
+    inBuffers_.assign(size_t(inTransfers), std::vector<uint8_t>(size_t(inSize)));
+    for(std::vector<uint8_t> &buffer : inBuffers_)
+    {
+        libusb_transfer *transfer = libusb_alloc_transfer(0);
+
+        libusb_fill_bulk_transfer(transfer, handle_, kEndpointIn, buffer.data(),
+                                  int(buffer.size()), LibusbCallbacks::inDone, this, 0);
+        in_.push_back(transfer);
+        if(libusb_submit_transfer(transfer) == 0)
+            pending_++;
+    }
+}
+
+LibusbTransport::~LibusbTransport()
+{
+    closed_ = true;
+    for(libusb_transfer *transfer : in_)
+        libusb_cancel_transfer(transfer);
+    while(pending_ > 0)
+    {
+        if(libusb_handle_events(context_) != 0)
+            break;
+    }
+    for(libusb_transfer *transfer : in_)
+        libusb_free_transfer(transfer);
+    libusb_release_interface(handle_, 0);
+    libusb_close(handle_);
+    libusb_exit(context_);
+}
+
+bool LibusbTransport::submit(std::vector<uint8_t> data, Done done)
+{
+    libusb_transfer *transfer;
+    LibusbCallbacks::Out *out;
+
+    if(closed_)
+        return false;
+    transfer = libusb_alloc_transfer(0);
+    out = new LibusbCallbacks::Out{this, std::move(data), std::move(done)};
+    libusb_fill_bulk_transfer(transfer, handle_, kEndpointOut, out->data.data(),
+                              int(out->data.size()), LibusbCallbacks::outDone, out, 1000);
+    if(libusb_submit_transfer(transfer) != 0)
+    {
+        delete out;
+        libusb_free_transfer(transfer);
+        return false;
+    }
+    pending_++;
+    return true;
+}
+
+bool LibusbTransport::poll(int timeoutMs)
+{
+    timeval timeout = {timeoutMs / 1000, (timeoutMs % 1000) * 1000};
+
+    if(closed_)
+        return false;
+    if(libusb_handle_events_timeout_completed(context_, &timeout, nullptr) != 0)
+        closed_ = true;
+    return !closed_;
+}
+
+}  // namespace bulk
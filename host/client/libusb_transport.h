@@ -0,0 +1,55 @@
+//
+// libusb_transport.h
+//
+// Transport on the board through the asynchronous API of libusb-1.0: the
+// OUT transfers are submitted as they come, and a few IN transfers are
+// kept queued on the bulk IN endpoint so that the device never waits for
+// the host to read.  Built when libusb-1.0 is found (HAVE_LIBUSB).
+//
+#ifndef BULK_LIBUSB_TRANSPORT_H_
+#define BULK_LIBUSB_TRANSPORT_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "transport.h"
+
+struct libusb_context;
+struct libusb_device_handle;
+struct libusb_transfer;
+
+namespace bulk {
+
+class LibusbTransport : public Transport {
+public:
+    // TivaWare generic bulk device
+    static constexpr uint16_t kVendor = 0x1CBE;
+    static constexpr uint16_t kProduct = 0x0003;
+    static constexpr uint8_t kEndpointOut = 0x01;
+    static constexpr uint8_t kEndpointIn = 0x81;
+
+    // Throws std::runtime_error when no board can be opened
+    explicit LibusbTransport(uint16_t vendor = kVendor, uint16_t product = kProduct,
+                             int inTransfers = 4, int inSize = 512);
+    ~LibusbTransport() override;
+
+    LibusbTransport(const LibusbTransport &) = delete;
+    LibusbTransport &operator=(const LibusbTransport &) = delete;
+
+    bool submit(std::vector<uint8_t> data, Done done) override;
+    bool poll(int timeoutMs) override;
+
+private:
+    friend struct LibusbCallbacks;
+
+    libusb_context *context_ = nullptr;
+    libusb_device_handle *handle_ = nullptr;
+    std::vector<libusb_transfer *> in_;
+    std::vector<std::vector<uint8_t>> inBuffers_;
+    int pending_ = 0;                   // transfers libusb still owns
+    bool closed_ = false;
+};
+
+}  // namespace bulk
+
+#endif /* BULK_LIBUSB_TRANSPORT_H_ */
@@ -0,0 +1,226 @@
+//
+// messages.cpp
+//
+// Sizes and decoding of the device messages, see messages.h.  The layouts
+// are those of the firmware headers and of the replies of command.c.
+//
+#include "messages.h"
+
+#include "protocol.h"
+#include "command.h"
+#include "telemetry.h"
+#include "trace.h"
+#include "log.h"
+#include "event.h"
+#include "profile.h"
+#include "latency.h"
+#include "metrics.h"
+#include "meccano_protocol.h"
+
+namespace bulk {
+
+namespace {
+
+constexpr size_t kDcMotors = 2;         // left and right wheels
+constexpr size_t kArmServos = 4;        // per arm, in the metrics queue depths
+
+// Size once the whole message is there
+size_t sized(size_t size, size_t total)
+{
+    return (size < total) ? 0 : total;
+}
+
+size_t telemetrySize(const uint8_t *data, size_t size, uint8_t channels)
+{
+    size_t at = 5;
+
+    for(uint8_t bit = TELEMETRY_ODOMETRY; bit <= TELEMETRY_MEMORY; bit <<= 1)
+    {
+        if((channels & bit) == 0)
+            continue;
+        if(size < at + 2)
+            return 0;
+        if(data[at] != bit)
+            return kUnknown;
+        at += 2 + data[at + 1];
+    }
+    return (size < at) ? 0 : at;
+}
+
+}  // namespace
+
+
+size_t messageSize(const uint8_t *data, size_t size, uint8_t telemetryChannels)
+{
+    if(size == 0)
+        return 0;
+
+    switch(data[0])
+    {
+    case ACK_MSG:
+        return sized(size, 7);
+    case TELEMETRY_MSG:
+        if(size < 5)
+            return 0;
+        return telemetrySize(data, size, telemetryChannels);
+    case TRACE_MSG:
+    case EVENT_MSG:
+        // count, lost (2 bytes), then 8-byte events
+        return (size < 4) ? 0 : sized(size, 4 + 8 * size_t(data[1]));
+    case LOG_MSG:
+        return (size < 4) ? 0 : sized(size, 4 + 14 * size_t(data[1]));
+    case DC_PWM_CMD:
+        return sized(size, 9);
+    case DC_GET_POSITION_CMD:
+        return sized(size, 5 + 8 * kDcMotors);
+    case MECCANO_GET_RECORD_CMD:
+        if(size < 7)
+            return 0;
+        return sized(size, 7 + size_t(data[6]) * ((data[1] == 0) ? 6 : 10));
+    case MECCANO_GET_ERRORS_CMD:
+        return sized(size, 9 + 13 * MECCANO_MODULE_NBR);
+    case PROFILE_CMD:
+        if(size < 2)
+            return 0;
+        return sized(size, (data[1] < PROFILE_ISR_NBR) ?
+                           22 + 2 * PROFILE_HIST_BINS : 11);
+    case METRICS_CMD:
+        if(size < 6)
+            return 0;
+        return sized(size, 6 + 5 * size_t(data[5]) +
+                           2 * kArmServos + MECCANO_MODULE_NBR + kDcMotors +
+                           2 * METRICS_OPCODE_NBR);
+    case BENCH_CMD:
+        return sized(size, 22);
+    case PING_CMD:
+        return sized(size, 25);
+    case LATENCY_CMD:
+        if(size < 2)
+            return 0;
+        return sized(size, (data[1] < LATENCY_CHANNEL_NBR) ?
+                           22 + 2 * LATENCY_HIST_BINS : 2);
+    case TIME_CMD:
+        return sized(size, 23);
+    default:
+        return kUnknown;
+    }
+}
+
+
+uint16_t get16(const uint8_t *p)
+{
+    return uint16_t((p[0] << 8) | p[1]);
+}
+
+uint32_t get32(const uint8_t *p)
+{
+    return (uint32_t(get16(p)) << 16) | get16(p + 2);
+}
+
+uint64_t get64(const uint8_t *p)
+{
+    return (uint64_t(get32(p)) << 32) | get32(p + 4);
+}
+
+
+bool decodeAck(const Message &message, Ack &ack)
+{
+    const uint8_t *p = message.data.data();
+
+    if((message.opcode != ACK_MSG) || (message.data.size() < 7))
+        return false;
+    ack.seq = p[1];
+    ack.status = p[2];
+    ack.rxFree = get16(&p[3]);
+    ack.nodesFree = get16(&p[5]);
+    return true;
+}
+
+bool decodeTelemetry(const Message &message, Telemetry &telemetry)
+{
+    const std::vector<uint8_t> &d = message.data;
+    size_t at = 5;
+
+    if((message.opcode != TELEMETRY_MSG) || (d.size() < 5))
+        return false;
+    telemetry = Telemetry();
+    telemetry.ms = get32(&d[1]);
+    while(at + 2 <= d.size())
+    {
+        const uint8_t *p = &d[at + 2];
+        size_t length = d[at + 1];
+
+        if(at + 2 + length > d.size())
+            return false;
+        if((d[at] == TELEMETRY_ODOMETRY) && (length >= 16))
+        {
+            telemetry.hasOdometry = true;
+            telemetry.x = int32_t(get32(&p[0]));
+            telemetry.y = int32_t(get32(&p[4]));
+            telemetry.theta = int32_t(get32(&p[8]));
+            telemetry.v = int16_t(get16(&p[12]));
+            telemetry.omega = int16_t(get16(&p[14]));
+        }
+        else if((d[at] == TELEMETRY_CURRENT) && (length >= 12))
+        {
+            telemetry.hasCurrent = true;
+            for(int i = 0; i < 3; i++)
+            {
+                telemetry.milliAmp[i] = get16(&p[2 * i]);
+                telemetry.trips[i] = get16(&p[6 + 2 * i]);
+            }
+        }
+        else if((d[at] == TELEMETRY_MEMORY) && (length >= 14))
+        {
+            telemetry.hasMemory = true;
+            for(int i = 0; i < 7; i++)
+                telemetry.memory[i] = get16(&p[2 * i]);
+        }
+        at += 2 + length;
+    }
+    return true;
+}
+
+bool decodePing(const Message &message, Ping &ping)
+{
+    const uint8_t *p = message.data.data();
+
+    if((message.opcode != PING_CMD) || (message.data.size() < 25))
+        return false;
+    ping.stamp = get64(&p[1]);
+    ping.ms = get32(&p[9]);
+    ping.rxCycles = get32(&p[13]);
+    ping.execCycles = get32(&p[17]);
+    ping.sysClock = get32(&p[21]);
+    return true;
+}
+
+
+void Decoder::push(const uint8_t *data, size_t size, const Sink &sink)
+{
+    size_t at = 0;
+
+    pending_.insert(pending_.end(), data, data + size);
+    while(at < pending_.size())
+    {
+        size_t length = messageSize(&pending_[at], pending_.size() - at,
+                                    telemetryChannels_);
+
+        if(length == 0)
+            break;
+        if(length == kUnknown)
+        {
+            skipped_++;
+            at++;
+            continue;
+        }
+        Message message = {pending_[at],
+                           std::vector<uint8_t>(pending_.begin() + at,
+                                                pending_.begin() + at + length)};
+        at += length;
+        sink(message);
+    }
+    pending_.erase(pending_.begin(), pending_.begin() + at);
+}
+
+}  // namespace bulk
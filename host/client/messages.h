@@ -0,0 +1,90 @@
+//
+// messages.h
+//
+// What the firmware sends on the bulk IN endpoint, cut into messages: the
+// replies, which start with the opcode they answer, and the messages sent
+// without being asked for, from PROTOCOL_ASYNC_FIRST on.  The stream may
+// be split anywhere, the decoder keeps the start of a message until the
+// rest has come.
+//
+#ifndef BULK_MESSAGES_H_
+#define BULK_MESSAGES_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace bulk {
+
+struct Message {
+    uint8_t opcode;
+    std::vector<uint8_t> data;          // whole message, opcode included
+};
+
+struct Ack {
+    uint8_t seq;
+    uint8_t status;                     // ACK_OK ... ACK_NO_ROOM
+    uint16_t rxFree;                    // bytes
+    uint16_t nodesFree;                 // keyframe nodes
+};
+
+struct Telemetry {
+    uint32_t ms;
+    bool hasOdometry = false;
+    int32_t x = 0, y = 0;               // mm
+    int32_t theta = 0;                  // mrad
+    int16_t v = 0;                      // mm/s
+    int16_t omega = 0;                  // mrad/s
+    bool hasCurrent = false;
+    uint16_t milliAmp[3] = {};          // left, right, servos
+    uint16_t trips[3] = {};
+    bool hasMemory = false;
+    uint16_t memory[7] = {};            // see TELEMETRY_MEMORY
+};
+
+struct Ping {
+    uint64_t stamp;
+    uint32_t ms;
+    uint32_t rxCycles;
+    uint32_t execCycles;
+    uint32_t sysClock;                  // Hz
+};
+
+// Size of the message at data, 0 while it is not complete, kUnknown when
+// the first byte starts no message.  The channels of TELEMETRY_MSG are
+// those enabled by the last TELEMETRY_CMD.
+constexpr size_t kUnknown = ~size_t(0);
+size_t messageSize(const uint8_t *data, size_t size, uint8_t telemetryChannels);
+
+uint16_t get16(const uint8_t *p);
+uint32_t get32(const uint8_t *p);
+uint64_t get64(const uint8_t *p);
+
+// False when the message is not of that kind or too short
+bool decodeAck(const Message &message, Ack &ack);
+bool decodeTelemetry(const Message &message, Telemetry &telemetry);
+bool decodePing(const Message &message, Ping &ping);
+
+class Decoder {
+public:
+    using Sink = std::function<void(const Message &)>;
+
+    void setTelemetryChannels(uint8_t channels) { telemetryChannels_ = channels; }
+    uint8_t telemetryChannels() const { return telemetryChannels_; }
+
+    // Appends the bytes received and gives every message completed
+    void push(const uint8_t *data, size_t size, const Sink &sink);
+
+    // Bytes that started no message, dropped one at a time to resync
+    uint64_t skipped() const { return skipped_; }
+
+private:
+    std::vector<uint8_t> pending_;
+    uint8_t telemetryChannels_ = 0;
+    uint64_t skipped_ = 0;
+};
+
+}  // namespace bulk
+
+#endif /* BULK_MESSAGES_H_ */
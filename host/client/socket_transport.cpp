@@ -0,0 +1,137 @@
+//
+// socket_transport.cpp
+//
+// Transport on the Unix socket of usb_emulator, see transport.h.
+//
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "transport.h"
+
+namespace bulk {
+
+SocketTransport::SocketTransport(const std::string &path)
+{
+    sockaddr_un address = {};
+
+    if(path.size() >= sizeof(address.sun_path))
+        throw std::runtime_error(path + ": socket path too long");
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, path.c_str());
+
+    fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if((fd_ < 0) ||
+       (::connect(fd_, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0))
+    {
+        std::string error = path + ": " + std::strerror(errno);
+
+        if(fd_ >= 0)
+            ::close(fd_);
+        throw std::runtime_error(error);
+    }
+    ::fcntl(fd_, F_SETFL, ::fcntl(fd_, F_GETFL) | O_NONBLOCK);
+}
+
+SocketTransport::~SocketTransport()
+{
+    if(fd_ >= 0)
+        ::close(fd_);
+}
+
+bool SocketTransport::submit(std::vector<uint8_t> data, Done done)
+{
+    if(fd_ < 0)
+        return false;
+    out_.push_back({std::move(data), 0, std::move(done)});
+    return true;
+}
+
+// As much of the waiting transfers as the socket takes
+bool SocketTransport::write()
+{
+    while(!out_.empty())
+    {
+        Out &out = out_.front();
+        ssize_t n = ::send(fd_, &out.data[out.sent], out.data.size() - out.sent,
+                           MSG_NOSIGNAL);
+
+        if(n < 0)
+            return (errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR);
+        out.sent += size_t(n);
+        if(out.sent == out.data.size())
+        {
+            Done done = std::move(out.done);
+
+            out_.pop_front();
+            if(done)
+                done(true);
+        }
+    }
+    return true;
+}
+
+void SocketTransport::fail()
+{
+    ::close(fd_);
+    fd_ = -1;
+    while(!out_.empty())
+    {
+        Done done = std::move(out_.front().done);
+
+        out_.pop_front();
+        if(done)
+            done(false);
+    }
+}
+
+bool SocketTransport::poll(int timeoutMs)
+{
+    if(fd_ < 0)
+        return false;
+    if(!write())
+    {
+        fail();
+        return false;
+    }
+
+    pollfd pfd = {fd_, short(POLLIN | (out_.empty() ? 0 : POLLOUT)), 0};
+
+    if(::poll(&pfd, 1, timeoutMs) < 0)
+        return errno == EINTR;
+    if(pfd.revents & POLLIN)
+    {
+        uint8_t buffer[4096];
+        ssize_t n;
+
+        while((n = ::recv(fd_, buffer, sizeof(buffer), 0)) > 0)
+        {
+            if(receiver_)
+                receiver_(buffer, size_t(n));
+        }
+        if((n == 0) || ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR)))
+        {
+            fail();
+            return false;
+        }
+    }
+    else if(pfd.revents & (POLLHUP | POLLERR))
+    {
+        fail();
+        return false;
+    }
+    if(!write())
+    {
+        fail();
+        return false;
+    }
+    return true;
+}
+
+}  // namespace bulk
@@ -0,0 +1,79 @@
+//
+// transport.h
+//
+// Bulk pipe of the device as the client sees it: OUT transfers submitted
+// without waiting, several of them in flight, and the IN data handed over
+// as it comes.  Completions and receptions run from poll(), on the thread
+// of the caller.
+//
+// SocketTransport talks to usb_emulator; LibusbTransport (libusb_transport.h,
+// built when libusb-1.0 is found) to the board.
+//
+#ifndef BULK_TRANSPORT_H_
+#define BULK_TRANSPORT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bulk {
+
+class Transport {
+public:
+    using Receiver = std::function<void(const uint8_t *data, size_t size)>;
+    using Done = std::function<void(bool ok)>;
+
+    virtual ~Transport() = default;
+
+    void setReceiver(Receiver receiver) { receiver_ = std::move(receiver); }
+
+    // Starts an OUT transfer, done is called from poll() once it is out
+    virtual bool submit(std::vector<uint8_t> data, Done done) = 0;
+
+    // Runs the completions and the receptions due, waiting at most
+    // timeoutMs for the first one; false once the pipe is closed
+    virtual bool poll(int timeoutMs) = 0;
+
+protected:
+    Receiver receiver_;
+};
+
+//*****************************************************************************
+//
+// Unix socket of usb_emulator.  A transfer is complete once the socket
+// has taken all of it.
+//
+//*****************************************************************************
+class SocketTransport : public Transport {
+public:
+    // Throws std::runtime_error when the emulator cannot be reached
+    explicit SocketTransport(const std::string &path);
+    ~SocketTransport() override;
+
+    SocketTransport(const SocketTransport &) = delete;
+    SocketTransport &operator=(const SocketTransport &) = delete;
+
+    bool submit(std::vector<uint8_t> data, Done done) override;
+    bool poll(int timeoutMs) override;
+
+private:
+    struct Out {
+        std::vector<uint8_t> data;
+        size_t sent;
+        Done done;
+    };
+
+    bool write();
+    void fail();
+
+    int fd_;
+    std::deque<Out> out_;
+};
+
+}  // namespace bulk
+
+#endif /* BULK_TRANSPORT_H_ */
@@ -0,0 +1,178 @@
+/*
+ * dc_plant.c
+ *
+ * Purpose:  DC wheel motors of the simulated board, see dc_plant.h.  The
+ *           model is integrated every SIM_PLANT_STEP_US from the mean
+ *           duty of the legs, the PWM ripple is not modelled.
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "inc/hw_memmap.h"
+#include "driverlib/qei.h"
+
+#include "dc_motor.h"
+#include "dc_encoder.h"
+#include "sim.h"
+#include "dc_plant.h"
+
+struct plant_state {
+   struct sim_dc_plant model;
+   double velocity;						// counts/s
+   double fraction;						// part of a count not sent yet
+   int64_t position;						// counts sent to the encoder
+};
+
+static struct plant_state plants[DC_MOTOR_NBR];
+static struct sim_event stepEvent;
+static uint8_t rightPhase;					// A in bit 1, B in bit 0
+
+// Forward order of the right encoder phases, see dc_encoder.c
+static const uint8_t rightGray[4] = {0, 1, 3, 2};
+
+static const uint32_t legBase[DC_MOTOR_NBR][2] = {{LEFT_F_BASE, LEFT_B_BASE},
+												  {RIGHT_F_BASE, RIGHT_B_BASE}};
+static const uint32_t legTimer[DC_MOTOR_NBR][2] = {{LEFT_F_TIMER, LEFT_B_TIMER},
+												   {RIGHT_F_TIMER, RIGHT_B_TIMER}};
+
+
+//*****************************************************************************
+//
+// Part of the period a leg is high: from the load value down to the
+// match value, bits 16 to 23 in the prescalers.
+//
+//*****************************************************************************
+static double legDuty(uint32_t motor, uint32_t leg)
+{
+	uint32_t base = legBase[motor][leg];
+	uint32_t timer = legTimer[motor][leg];
+	uint32_t load = (TimerPrescaleGet(base, timer) << 16) | TimerLoadGet(base, timer);
+	uint32_t match = (TimerPrescaleMatchGet(base, timer) << 16) | TimerMatchGet(base, timer);
+
+	if((load == 0) || (match >= load))
+		return 0.0;
+	return (double)(load - match) / load;
+}
+
+
+double simPlantDuty(uint32_t motor)
+{
+	// In brake mode both legs are high during the off time, the
+	// difference is the drive in both modes
+	return legDuty(motor, 0) - legDuty(motor, 1);
+}
+
+
+//*****************************************************************************
+//
+// Moves the right encoder phases one count at a time.
+//
+//*****************************************************************************
+static void rightMove(int32_t counts)
+{
+	uint8_t pins;
+
+	while(counts != 0)
+	{
+		rightPhase = (counts > 0) ? (rightPhase + 1) & 3 : (rightPhase - 1) & 3;
+		counts += (counts > 0) ? -1 : 1;
+		pins = ((rightGray[rightPhase] & 2) ? ENCODER_RIGHT_PIN_A : 0) |
+			   ((rightGray[rightPhase] & 1) ? ENCODER_RIGHT_PIN_B : 0);
+		simPinDrive(ENCODER_RIGHT_BASE, ENCODER_RIGHT_PIN_A | ENCODER_RIGHT_PIN_B, pins);
+	}
+}
+
+
+static void plantStep(struct sim_event *event_p)
+{
+	const double dt = SIM_PLANT_STEP_US / 1e6;
+	struct plant_state *plant_p;
+	double duty;
+	double target;
+	int32_t counts;
+	int i;
+
+	for(i = 0; i < DC_MOTOR_NBR; i++)
+	{
+		plant_p = &plants[i];
+		duty = simPlantDuty(i);
+
+		// Static friction holds a wheel at rest
+		if((fabs(duty) < plant_p->model.stiction) && (fabs(plant_p->velocity) < 1.0))
+			target = 0.0;
+		else
+			target = duty * plant_p->model.freeSpeed;
+		if(target > plant_p->model.load)
+			target -= plant_p->model.load;
+		else if(target < -plant_p->model.load)
+			target += plant_p->model.load;
+		else
+			target = 0.0;
+
+		plant_p->velocity += (target - plant_p->velocity) * dt / plant_p->model.timeConstant;
+		plant_p->fraction += plant_p->velocity * dt;
+		counts = (int32_t)plant_p->fraction;
+		if(counts == 0)
+			continue;
+		plant_p->fraction -= counts;
+		plant_p->position += counts;
+		if(i == DC_LEFT)
+			simQeiMove(QEI0_BASE, counts);
+		else
+			rightMove(counts);
+	}
+	simSchedule(event_p, event_p->time + SIM_PLANT_STEP_US * SIM_CYCLES_PER_US);
+}
+
+
+//*****************************************************************************
+//
+// Puts both wheels at rest with the default model, after simInit().
+//
+//*****************************************************************************
+void simPlantInit(void)
+{
+	const struct sim_dc_plant model = SIM_PLANT_DEFAULT;
+	int i;
+
+	for(i = 0; i < DC_MOTOR_NBR; i++)
+	{
+		plants[i].model = model;
+		plants[i].velocity = 0.0;
+		plants[i].fraction = 0.0;
+		plants[i].position = 0;
+	}
+	rightPhase = 0;
+	simPinDrive(ENCODER_RIGHT_BASE, ENCODER_RIGHT_PIN_A | ENCODER_RIGHT_PIN_B, 0);
+	stepEvent.queued = false;
+	stepEvent.fire = plantStep;
+	simSchedule(&stepEvent, simCycles + SIM_PLANT_STEP_US * SIM_CYCLES_PER_US);
+}
+
+
+//*****************************************************************************
+//
+// Changes the model of a wheel, at any time: a load step, a weaker motor.
+//
+//*****************************************************************************
+void simPlantSet(uint32_t motor, const struct sim_dc_plant *plant_p)
+{
+	if(motor < DC_MOTOR_NBR)
+		plants[motor].model = *plant_p;
+}
+
+
+double simPlantVelocity(uint32_t motor)
+{
+	return (motor < DC_MOTOR_NBR) ? plants[motor].velocity : 0.0;
+}
+
+
+int64_t simPlantPosition(uint32_t motor)
+{
+	return (motor < DC_MOTOR_NBR) ? plants[motor].position : 0;
+}
@@ -0,0 +1,51 @@
+/*
+ * dc_plant.h
+ *
+ * Purpose:  Model of the two DC wheel motors of the simulated board.  The
+ *           duty is read from the PWM legs of Timer1 and Timer2, the
+ *           wheels turn the encoders: QEI0 for the left one, the GPIO
+ *           phases decoded by dc_encoder.c for the right one.
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+
+#ifndef DC_PLANT_H_
+#define DC_PLANT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#define SIM_PLANT_STEP_US		100		// integration step
+
+//*****************************************************************************
+//
+// First order motor with friction: the velocity goes to the duty times
+// the free speed with the mechanical time constant, less the load, and
+// stays at 0 below the static friction duty.
+//
+//*****************************************************************************
+struct sim_dc_plant {
+   double freeSpeed;						// counts/s at full duty, no load
+   double timeConstant;					// s
+   double stiction;						// duty the wheel needs to start, 0 - 1
+   double load;							// counts/s lost to the load torque
+};
+
+#define SIM_PLANT_DEFAULT		{3000.0, 0.05, 0.05, 0.0}
+
+void simPlantInit(void);
+void simPlantSet(uint32_t motor, const struct sim_dc_plant *plant_p);
+double simPlantDuty(uint32_t motor);
+double simPlantVelocity(uint32_t motor);
+int64_t simPlantPosition(uint32_t motor);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif /* DC_PLANT_H_ */
@@ -0,0 +1,862 @@
+/*
+ * driverlib.c
+ *
+ * Purpose:  Simulated peripherals behind the driverlib calls of the
+ *           firmware: GPIO ports with their edge interrupts, the general
+ *           purpose timers, the PWM outputs and the QEI.  The ADC and the
+ *           uDMA keep their configuration and never convert.
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "inc/hw_ints.h"
+#include "inc/hw_memmap.h"
+#include "driverlib/adc.h"
+#include "driverlib/gpio.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/pwm.h"
+#include "driverlib/qei.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/timer.h"
+#include "driverlib/udma.h"
+
+#include "sim.h"
+
+#define SIM_PORT_NBR			15		// A to Q, one 4 KB page each
+#define SIM_WATCHER_NBR			8
+#define SIM_TIMER_NBR			6
+#define SIM_PWM_OUT_NBR			8
+
+//*****************************************************************************
+//
+// GPIO ports.
+//
+//*****************************************************************************
+struct sim_port {
+   uint8_t dir;								// 1 for an output
+   uint8_t data;							// output latch
+   uint8_t input;							// level driven from outside
+   uint8_t level;
+   uint8_t ris;								// edges seen
+   uint8_t im;								// interrupts enabled
+   uint8_t ibe;								// both edges
+   uint8_t iev;								// rising edge
+   void (*handler)(void);
+};
+
+struct sim_watcher {
+   uint32_t port;
+   uint8_t pins;
+   sim_pin_watcher watcher;
+   void *context;
+};
+
+// A, B, C, D, E, F, G, H, J, K, L, M, N, P, Q
+static const uint8_t portInterrupt[SIM_PORT_NBR] = {
+	16, 17, 18, 19, 20, 46, 47, 48, 67, 68, 69, 88, 89, 92, 100
+};
+
+static struct sim_port ports[SIM_PORT_NBR];
+static struct sim_watcher watchers[SIM_WATCHER_NBR];
+static uint32_t watcherNbr;
+
+//*****************************************************************************
+//
+// General purpose timers.  Only the full width periodic and one-shot
+// modes count, a timer in PWM mode keeps its load and match values for
+// the tests.
+//
+//*****************************************************************************
+struct sim_timer {
+   uint32_t config;
+   uint32_t load[2];						// A, B
+   uint32_t match[2];
+   uint32_t prescale[2];
+   uint32_t prescaleMatch[2];
+   bool enabled[2];
+   uint32_t im;
+   uint32_t ris;
+   uint64_t start;							// cycle of the last reload
+   struct sim_event timeout;
+};
+
+static const uint8_t timerInterrupt[SIM_TIMER_NBR] = {
+	INT_TIMER0A, INT_TIMER1A, INT_TIMER2A, INT_TIMER3A, INT_TIMER4A, INT_TIMER5A
+};
+
+static struct sim_timer timers[SIM_TIMER_NBR];
+
+static uint32_t pwmWidth[SIM_PWM_OUT_NBR];
+static uint32_t pwmPeriod[4];
+static uint32_t pwmOutputs;
+static uint32_t qeiPosition;
+static uint32_t qeiMax;
+
+
+//*****************************************************************************
+//
+// Resets every peripheral.
+//
+//*****************************************************************************
+void simPeripheralInit(void)
+{
+	int i;
+
+	for(i = 0; i < SIM_PORT_NBR; i++)
+	{
+		ports[i].dir = ports[i].data = ports[i].input = ports[i].level = 0;
+		ports[i].ris = ports[i].im = ports[i].ibe = ports[i].iev = 0;
+		ports[i].handler = NULL;
+	}
+	watcherNbr = 0;
+	for(i = 0; i < SIM_TIMER_NBR; i++)
+	{
+		timers[i].config = 0;
+		timers[i].load[0] = timers[i].load[1] = 0xFFFFFFFF;
+		timers[i].match[0] = timers[i].match[1] = 0;
+		timers[i].prescale[0] = timers[i].prescale[1] = 0;
+		timers[i].prescaleMatch[0] = timers[i].prescaleMatch[1] = 0;
+		timers[i].enabled[0] = timers[i].enabled[1] = false;
+		timers[i].im = timers[i].ris = 0;
+		timers[i].timeout.queued = false;
+		timers[i].timeout.context = &timers[i];
+	}
+	for(i = 0; i < SIM_PWM_OUT_NBR; i++)
+		pwmWidth[i] = 0;
+	for(i = 0; i < 4; i++)
+		pwmPeriod[i] = 0;
+	pwmOutputs = 0;
+	qeiPosition = 0;
+	qeiMax = 0xFFFFFFFF;
+}
+
+
+//*****************************************************************************
+//
+// GPIO.
+//
+//*****************************************************************************
+static struct sim_port *portGet(uint32_t base)
+{
+	uint32_t index = (base - GPIO_PORTA_BASE) >> 12;
+
+	if((base < GPIO_PORTA_BASE) || (index >= SIM_PORT_NBR))
+	{
+		fprintf(stderr, "sim: no GPIO port at 0x%08x\n", base);
+		return &ports[0];
+	}
+	return &ports[index];
+}
+
+
+static uint32_t portBase(const struct sim_port *port_p)
+{
+	return GPIO_PORTA_BASE + ((uint32_t)(port_p - ports) << 12);
+}
+
+
+static void portLine(struct sim_port *port_p)
+{
+	simInterruptLine(portInterrupt[port_p - ports],
+					 (port_p->ris & port_p->im) && (port_p->handler != NULL));
+}
+
+
+//*****************************************************************************
+//
+// Works out the level of the pins after a change of direction, latch or
+// outside drive, latches the edges and tells the watchers.
+//
+//*****************************************************************************
+static void portUpdate(struct sim_port *port_p)
+{
+	uint8_t level = (port_p->dir & port_p->data) | (~port_p->dir & port_p->input);
+	uint8_t rising = level & ~port_p->level;
+	uint8_t falling = port_p->level & ~level;
+	uint32_t base;
+	uint32_t i;
+
+	if((rising | falling) == 0)
+		return;
+	port_p->level = level;
+	port_p->ris |= (rising & (port_p->iev | port_p->ibe)) |
+				   (falling & (~port_p->iev | port_p->ibe));
+	portLine(port_p);
+
+	base = portBase(port_p);
+	for(i = 0; i < watcherNbr; i++)
+	{
+		if((watchers[i].port == base) && (watchers[i].pins & (rising | falling)))
+			watchers[i].watcher(base, watchers[i].pins, level & watchers[i].pins,
+								watchers[i].context);
+	}
+	simInterruptService();
+}
+
+
+void GPIOPinTypeGPIOInput(uint32_t ui32Port, uint8_t ui8Pins)
+{
+	struct sim_port *port_p = portGet(ui32Port);
+
+	port_p->dir &= ~ui8Pins;
+	portUpdate(port_p);
+}
+
+
+void GPIOPinTypeGPIOOutput(uint32_t ui32Port, uint8_t ui8Pins)
+{
+	struct sim_port *port_p = portGet(ui32Port);
+
+	port_p->dir |= ui8Pins;
+	portUpdate(port_p);
+}
+
+
+void GPIOPinTypePWM(uint32_t ui32Port, uint8_t ui8Pins)
+{
+}
+
+
+void GPIOPinTypeTimer(uint32_t ui32Port, uint8_t ui8Pins)
+{
+}
+
+
+void GPIOPinTypeQEI(uint32_t ui32Port, uint8_t ui8Pins)
+{
+}
+
+
+void GPIOPinTypeADC(uint32_t ui32Port, uint8_t ui8Pins)
+{
+}
+
+
+void GPIOPinConfigure(uint32_t ui32PinConfig)
+{
+}
+
+
+void GPIOPadConfigSet(uint32_t ui32Port, uint8_t ui8Pins,
+                      uint32_t ui32Strength, uint32_t ui32PadType)
+{
+}
+
+
+int32_t GPIOPinRead(uint32_t ui32Port, uint8_t ui8Pins)
+{
+	return portGet(ui32Port)->level & ui8Pins;
+}
+
+
+void GPIOPinWrite(uint32_t ui32Port, uint8_t ui8Pins, uint8_t ui8Val)
+{
+	struct sim_port *port_p = portGet(ui32Port);
+
+	port_p->data = (port_p->data & ~ui8Pins) | (ui8Val & ui8Pins);
+	portUpdate(port_p);
+}
+
+
+void GPIOIntTypeSet(uint32_t ui32Port, uint8_t ui8Pins, uint32_t ui32IntType)
+{
+	struct sim_port *port_p = portGet(ui32Port);
+
+	port_p->ibe = (ui32IntType & 1) ? (port_p->ibe | ui8Pins) : (port_p->ibe & ~ui8Pins);
+	port_p->iev = (ui32IntType & 4) ? (port_p->iev | ui8Pins) : (port_p->iev & ~ui8Pins);
+}
+
+
+void GPIOIntEnable(uint32_t ui32Port, uint32_t ui32IntFlags)
+{
+	struct sim_port *port_p = portGet(ui32Port);
+
+	port_p->im |= ui32IntFlags;
+	portLine(port_p);
+	simInterruptService();
+}
+
+
+void GPIOIntDisable(uint32_t ui32Port, uint32_t ui32IntFlags)
+{
+	struct sim_port *port_p = portGet(ui32Port);
+
+	port_p->im &= ~ui32IntFlags;
+	portLine(port_p);
+}
+
+
+uint32_t GPIOIntStatus(uint32_t ui32Port, bool bMasked)
+{
+	struct sim_port *port_p = portGet(ui32Port);
+
+	return bMasked ? (port_p->ris & port_p->im) : port_p->ris;
+}
+
+
+void GPIOIntClear(uint32_t ui32Port, uint32_t ui32IntFlags)
+{
+	struct sim_port *port_p = portGet(ui32Port);
+
+	port_p->ris &= ~ui32IntFlags;
+	portLine(port_p);
+}
+
+
+void GPIOIntRegister(uint32_t ui32Port, void (*pfnIntHandler)(void))
+{
+	struct sim_port *port_p = portGet(ui32Port);
+
+	port_p->handler = pfnIntHandler;
+	simVectorSet(portInterrupt[port_p - ports], pfnIntHandler);
+	IntEnable(portInterrupt[port_p - ports]);
+}
+
+
+//*****************************************************************************
+//
+// Outside world of the pins.
+//
+//*****************************************************************************
+void simPinDrive(uint32_t port, uint8_t pins, uint8_t value)
+{
+	struct sim_port *port_p = portGet(port);
+
+	port_p->input = (port_p->input & ~pins) | (value & pins);
+	portUpdate(port_p);
+}
+
+
+uint8_t simPinLevel(uint32_t port, uint8_t pins)
+{
+	return portGet(port)->level & pins;
+}
+
+
+bool simPinWatch(uint32_t port, uint8_t pins, sim_pin_watcher watcher,
+				 void *context)
+{
+	if(watcherNbr == SIM_WATCHER_NBR)
+		return false;
+	watchers[watcherNbr].port = port;
+	watchers[watcherNbr].pins = pins;
+	watchers[watcherNbr].watcher = watcher;
+	watchers[watcherNbr].context = context;
+	watcherNbr++;
+	return true;
+}
+
+
+//*****************************************************************************
+//
+// Timers.
+//
+//*****************************************************************************
+static struct sim_timer *timerGet(uint32_t base)
+{
+	uint32_t index = (base - TIMER0_BASE) >> 12;
+
+	if((base < TIMER0_BASE) || (index >= SIM_TIMER_NBR))
+	{
+		fprintf(stderr, "sim: no timer at 0x%08x\n", base);
+		return &timers[0];
+	}
+	return &timers[index];
+}
+
+
+static bool timerCounts(const struct sim_timer *timer_p)
+{
+	return ((timer_p->config & TIMER_CFG_SPLIT_PAIR) == 0) &&
+		   ((timer_p->config & 0xFF) != TIMER_CFG_A_PWM);
+}
+
+
+static void timerLine(struct sim_timer *timer_p)
+{
+	simInterruptLine(timerInterrupt[timer_p - timers],
+					 (timer_p->ris & timer_p->im) != 0);
+}
+
+
+//*****************************************************************************
+//
+// Reloads the count: the timeout comes load + 1 cycles later.
+//
+//*****************************************************************************
+static void timerReload(struct sim_timer *timer_p)
+{
+	timer_p->start = simCycles;
+	simSchedule(&timer_p->timeout, simCycles + (uint64_t)timer_p->load[0] + 1);
+}
+
+
+static void timerTimeout(struct sim_event *event_p)
+{
+	struct sim_timer *timer_p = event_p->context;
+
+	timer_p->ris |= TIMER_TIMA_TIMEOUT;
+	timerLine(timer_p);
+	if((timer_p->config & 0xFF) == TIMER_CFG_PERIODIC)
+		timerReload(timer_p);
+	else
+		timer_p->enabled[0] = false;
+}
+
+
+void TimerConfigure(uint32_t ui32Base, uint32_t ui32Config)
+{
+	struct sim_timer *timer_p = timerGet(ui32Base);
+
+	simCancel(&timer_p->timeout);
+	timer_p->enabled[0] = timer_p->enabled[1] = false;
+	timer_p->config = ui32Config;
+	timer_p->timeout.fire = timerTimeout;
+}
+
+
+void TimerEnable(uint32_t ui32Base, uint32_t ui32Timer)
+{
+	struct sim_timer *timer_p = timerGet(ui32Base);
+
+	if((ui32Timer & TIMER_A) && !timer_p->enabled[0])
+	{
+		timer_p->enabled[0] = true;
+		if(timerCounts(timer_p))
+			timerReload(timer_p);
+	}
+	if(ui32Timer & TIMER_B)
+		timer_p->enabled[1] = true;
+}
+
+
+void TimerDisable(uint32_t ui32Base, uint32_t ui32Timer)
+{
+	struct sim_timer *timer_p = timerGet(ui32Base);
+
+	if(ui32Timer & TIMER_A)
+	{
+		timer_p->enabled[0] = false;
+		simCancel(&timer_p->timeout);
+	}
+	if(ui32Timer & TIMER_B)
+		timer_p->enabled[1] = false;
+}
+
+
+void TimerControlLevel(uint32_t ui32Base, uint32_t ui32Timer, bool bInvert)
+{
+}
+
+
+void TimerControlTrigger(uint32_t ui32Base, uint32_t ui32Timer, bool bEnable)
+{
+}
+
+
+void TimerADCEventSet(uint32_t ui32Base, uint32_t ui32ADCEvent)
+{
+}
+
+
+void TimerPrescaleSet(uint32_t ui32Base, uint32_t ui32Timer, uint32_t ui32Value)
+{
+	struct sim_timer *timer_p = timerGet(ui32Base);
+
+	if(ui32Timer & TIMER_A)
+		timer_p->prescale[0] = ui32Value;
+	if(ui32Timer & TIMER_B)
+		timer_p->prescale[1] = ui32Value;
+}
+
+
+uint32_t TimerPrescaleGet(uint32_t ui32Base, uint32_t ui32Timer)
+{
+	return timerGet(ui32Base)->prescale[(ui32Timer == TIMER_B) ? 1 : 0];
+}
+
+
+void TimerPrescaleMatchSet(uint32_t ui32Base, uint32_t ui32Timer,
+                           uint32_t ui32Value)
+{
+	struct sim_timer *timer_p = timerGet(ui32Base);
+
+	if(ui32Timer & TIMER_A)
+		timer_p->prescaleMatch[0] = ui32Value;
+	if(ui32Timer & TIMER_B)
+		timer_p->prescaleMatch[1] = ui32Value;
+}
+
+
+uint32_t TimerPrescaleMatchGet(uint32_t ui32Base, uint32_t ui32Timer)
+{
+	return timerGet(ui32Base)->prescaleMatch[(ui32Timer == TIMER_B) ? 1 : 0];
+}
+
+
+//*****************************************************************************
+//
+// A new load value of a running timer is counted from at once, as with
+// the TAILD bit clear.
+//
+//*****************************************************************************
+void TimerLoadSet(uint32_t ui32Base, uint32_t ui32Timer, uint32_t ui32Value)
+{
+	struct sim_timer *timer_p = timerGet(ui32Base);
+
+	if(ui32Timer & TIMER_A)
+	{
+		timer_p->load[0] = ui32Value;
+		if(timer_p->enabled[0] && timerCounts(timer_p))
+			timerReload(timer_p);
+	}
+	if(ui32Timer & TIMER_B)
+		timer_p->load[1] = ui32Value;
+}
+
+
+uint32_t TimerLoadGet(uint32_t ui32Base, uint32_t ui32Timer)
+{
+	return timerGet(ui32Base)->load[(ui32Timer == TIMER_B) ? 1 : 0];
+}
+
+
+uint32_t TimerValueGet(uint32_t ui32Base, uint32_t ui32Timer)
+{
+	struct sim_timer *timer_p = timerGet(ui32Base);
+	uint64_t elapsed;
+
+	if((ui32Timer == TIMER_B) || !timer_p->enabled[0] || !timerCounts(timer_p))
+		return timer_p->load[(ui32Timer == TIMER_B) ? 1 : 0];
+	elapsed = (simCycles - timer_p->start) % ((uint64_t)timer_p->load[0] + 1);
+	return timer_p->load[0] - (uint32_t)elapsed;
+}
+
+
+void TimerMatchSet(uint32_t ui32Base, uint32_t ui32Timer, uint32_t ui32Value)
+{
+	struct sim_timer *timer_p = timerGet(ui32Base);
+
+	if(ui32Timer & TIMER_A)
+		timer_p->match[0] = ui32Value;
+	if(ui32Timer & TIMER_B)
+		timer_p->match[1] = ui32Value;
+}
+
+
+uint32_t TimerMatchGet(uint32_t ui32Base, uint32_t ui32Timer)
+{
+	return timerGet(ui32Base)->match[(ui32Timer == TIMER_B) ? 1 : 0];
+}
+
+
+void TimerIntEnable(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+	struct sim_timer *timer_p = timerGet(ui32Base);
+
+	timer_p->im |= ui32IntFlags;
+	timerLine(timer_p);
+	simInterruptService();
+}
+
+
+void TimerIntDisable(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+	struct sim_timer *timer_p = timerGet(ui32Base);
+
+	timer_p->im &= ~ui32IntFlags;
+	timerLine(timer_p);
+}
+
+
+uint32_t TimerIntStatus(uint32_t ui32Base, bool bMasked)
+{
+	struct sim_timer *timer_p = timerGet(ui32Base);
+
+	return bMasked ? (timer_p->ris & timer_p->im) : timer_p->ris;
+}
+
+
+void TimerIntClear(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+	struct sim_timer *timer_p = timerGet(ui32Base);
+
+	timer_p->ris &= ~ui32IntFlags;
+	timerLine(timer_p);
+}
+
+
+//*****************************************************************************
+//
+// PWM.  Output n belongs to generator n / 2, the low bits of the output
+// IDs give n.
+//
+//*****************************************************************************
+void PWMGenConfigure(uint32_t ui32Base, uint32_t ui32Gen, uint32_t ui32Config)
+{
+}
+
+
+void PWMGenPeriodSet(uint32_t ui32Base, uint32_t ui32Gen, uint32_t ui32Period)
+{
+	pwmPeriod[(ui32Gen >> 6) - 1] = ui32Period;
+}
+
+
+uint32_t PWMGenPeriodGet(uint32_t ui32Base, uint32_t ui32Gen)
+{
+	return pwmPeriod[(ui32Gen >> 6) - 1];
+}
+
+
+void PWMGenEnable(uint32_t ui32Base, uint32_t ui32Gen)
+{
+}
+
+
+void PWMGenDisable(uint32_t ui32Base, uint32_t ui32Gen)
+{
+}
+
+
+void PWMPulseWidthSet(uint32_t ui32Base, uint32_t ui32PWMOut, uint32_t ui32Width)
+{
+	pwmWidth[ui32PWMOut & 7] = ui32Width;
+}
+
+
+uint32_t PWMPulseWidthGet(uint32_t ui32Base, uint32_t ui32PWMOut)
+{
+	return pwmWidth[ui32PWMOut & 7];
+}
+
+
+void PWMOutputState(uint32_t ui32Base, uint32_t ui32PWMOutBits, bool bEnable)
+{
+	if(bEnable)
+		pwmOutputs |= ui32PWMOutBits;
+	else
+		pwmOutputs &= ~ui32PWMOutBits;
+}
+
+
+void PWMClockSet(uint32_t ui32Base, uint32_t ui32Config)
+{
+}
+
+
+//*****************************************************************************
+//
+// QEI, moved by the wheel models with simQeiMove().
+//
+//*****************************************************************************
+void QEIEnable(uint32_t ui32Base)
+{
+}
+
+
+void QEIDisable(uint32_t ui32Base)
+{
+}
+
+
+void QEIConfigure(uint32_t ui32Base, uint32_t ui32Config, uint32_t ui32MaxPosition)
+{
+	qeiMax = ui32MaxPosition;
+}
+
+
+uint32_t QEIPositionGet(uint32_t ui32Base)
+{
+	return qeiPosition;
+}
+
+
+void QEIPositionSet(uint32_t ui32Base, uint32_t ui32Position)
+{
+	qeiPosition = ui32Position;
+}
+
+
+void simQeiMove(uint32_t base, int32_t counts)
+{
+	qeiPosition += (uint32_t)counts;
+	if((qeiMax != 0xFFFFFFFF) && (qeiPosition > qeiMax))
+		qeiPosition = (counts < 0) ? qeiMax : 0;
+}
+
+
+//*****************************************************************************
+//
+// System control.
+//
+//*****************************************************************************
+void SysCtlPeripheralEnable(uint32_t ui32Peripheral)
+{
+}
+
+
+bool SysCtlPeripheralReady(uint32_t ui32Peripheral)
+{
+	return true;
+}
+
+
+uint32_t SysCtlClockGet(void)
+{
+	return SIM_CLOCK_HZ;
+}
+
+
+uint32_t SysCtlClockFreqSet(uint32_t ui32Config, uint32_t ui32SysClock)
+{
+	return SIM_CLOCK_HZ;
+}
+
+
+uint32_t SysCtlVCOGet(uint32_t ui32Crystal, uint32_t *pui32VCOFrequency)
+{
+	*pui32VCOFrequency = 480000000;
+	return 0;
+}
+
+
+//*****************************************************************************
+//
+// ADC and uDMA: configuration only.
+//
+//*****************************************************************************
+void ADCSequenceConfigure(uint32_t ui32Base, uint32_t ui32SequenceNum,
+                          uint32_t ui32Trigger, uint32_t ui32Priority)
+{
+}
+
+
+void ADCSequenceStepConfigure(uint32_t ui32Base, uint32_t ui32SequenceNum,
+                              uint32_t ui32Step, uint32_t ui32Config)
+{
+}
+
+
+void ADCSequenceEnable(uint32_t ui32Base, uint32_t ui32SequenceNum)
+{
+}
+
+
+void ADCSequenceDMAEnable(uint32_t ui32Base, uint32_t ui32SequenceNum)
+{
+}
+
+
+void ADCIntEnableEx(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+}
+
+
+uint32_t ADCIntStatusEx(uint32_t ui32Base, bool bMasked)
+{
+	return 0;
+}
+
+
+void ADCIntClearEx(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+}
+
+
+void ADCComparatorConfigure(uint32_t ui32Base, uint32_t ui32Comp,
+                            uint32_t ui32Config)
+{
+}
+
+
+void ADCComparatorRegionSet(uint32_t ui32Base, uint32_t ui32Comp,
+                            uint32_t ui32LowRef, uint32_t ui32HighRef)
+{
+}
+
+
+void ADCComparatorReset(uint32_t ui32Base, uint32_t ui32Comp,
+                        bool bTrigger, bool bInterrupt)
+{
+}
+
+
+void ADCComparatorIntEnable(uint32_t ui32Base, uint32_t ui32SequenceNum)
+{
+}
+
+
+uint32_t ADCComparatorIntStatus(uint32_t ui32Base)
+{
+	return 0;
+}
+
+
+void ADCComparatorIntClear(uint32_t ui32Base, uint32_t ui32Status)
+{
+}
+
+
+void ADCClockConfigSet(uint32_t ui32Base, uint32_t ui32Config,
+                       uint32_t ui32ClockDiv)
+{
+}
+
+
+void ADCHardwareOversampleConfigure(uint32_t ui32Base, uint32_t ui32Factor)
+{
+}
+
+
+void uDMAEnable(void)
+{
+}
+
+
+void uDMAControlBaseSet(void *psControlTable)
+{
+}
+
+
+void uDMAChannelAssign(uint32_t ui32Mapping)
+{
+}
+
+
+void uDMAChannelAttributeEnable(uint32_t ui32ChannelNum, uint32_t ui32Attr)
+{
+}
+
+
+void uDMAChannelAttributeDisable(uint32_t ui32ChannelNum, uint32_t ui32Attr)
+{
+}
+
+
+void uDMAChannelControlSet(uint32_t ui32ChannelStructIndex, uint32_t ui32Control)
+{
+}
+
+
+void uDMAChannelTransferSet(uint32_t ui32ChannelStructIndex, uint32_t ui32Mode,
+                            void *pvSrcAddr, void *pvDstAddr,
+                            uint32_t ui32TransferSize)
+{
+}
+
+
+void uDMAChannelEnable(uint32_t ui32ChannelNum)
+{
+}
+
+
+uint32_t uDMAChannelModeGet(uint32_t ui32ChannelStructIndex)
+{
+	return UDMA_MODE_PINGPONG;
+}
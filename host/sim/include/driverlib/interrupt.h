@@ -0,0 +1,28 @@
+//*****************************************************************************
+//
+// interrupt.h - Simulated NVIC, same calls as the TivaWare driverlib.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_INTERRUPT_H__
+#define __DRIVERLIB_INTERRUPT_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+extern bool IntMasterEnable(void);
+extern bool IntMasterDisable(void);
+extern void IntEnable(uint32_t ui32Interrupt);
+extern void IntDisable(uint32_t ui32Interrupt);
+extern uint32_t IntIsEnabled(uint32_t ui32Interrupt);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __DRIVERLIB_INTERRUPT_H__
@@ -0,0 +1,27 @@
+//*****************************************************************************
+//
+// pin_map.h - Alternate functions of the pins used by the firmware.  The
+// simulation ignores the pin muxing, the values only have to differ.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_PIN_MAP_H__
+#define __DRIVERLIB_PIN_MAP_H__
+
+#define GPIO_PA2_T1CCP0         0x00000803
+#define GPIO_PA3_T1CCP1         0x00000C03
+#define GPIO_PA4_T2CCP0         0x00001003
+#define GPIO_PA5_T2CCP1         0x00001403
+#define GPIO_PD4_T3CCP0         0x00031003
+#define GPIO_PF0_M0PWM0         0x00050006
+#define GPIO_PF1_M0PWM1         0x00050406
+#define GPIO_PF2_M0PWM2         0x00050806
+#define GPIO_PF3_M0PWM3         0x00050C06
+#define GPIO_PG0_M0PWM4         0x00060006
+#define GPIO_PG1_M0PWM5         0x00060406
+#define GPIO_PK4_M0PWM6         0x00091006
+#define GPIO_PK5_M0PWM7         0x00091406
+#define GPIO_PL1_PHA0           0x000A0406
+#define GPIO_PL2_PHB0           0x000A0806
+
+#endif // __DRIVERLIB_PIN_MAP_H__
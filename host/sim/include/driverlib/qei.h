@@ -0,0 +1,38 @@
+//*****************************************************************************
+//
+// qei.h - Simulated quadrature encoder interface, same calls as the
+// TivaWare driverlib.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_QEI_H__
+#define __DRIVERLIB_QEI_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define QEI_CONFIG_CAPTURE_A    0x00000000
+#define QEI_CONFIG_CAPTURE_A_B  0x00000008
+#define QEI_CONFIG_NO_RESET     0x00000000
+#define QEI_CONFIG_RESET_IDX    0x00000010
+#define QEI_CONFIG_QUADRATURE   0x00000000
+#define QEI_CONFIG_CLOCK_DIR    0x00000004
+#define QEI_CONFIG_NO_SWAP      0x00000000
+#define QEI_CONFIG_SWAP         0x00000002
+
+extern void QEIEnable(uint32_t ui32Base);
+extern void QEIDisable(uint32_t ui32Base);
+extern void QEIConfigure(uint32_t ui32Base, uint32_t ui32Config,
+                         uint32_t ui32MaxPosition);
+extern uint32_t QEIPositionGet(uint32_t ui32Base);
+extern void QEIPositionSet(uint32_t ui32Base, uint32_t ui32Position);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __DRIVERLIB_QEI_H__
@@ -0,0 +1,25 @@
+//*****************************************************************************
+//
+// rom.h - The ROM calls of the firmware go to the simulated driverlib.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_ROM_H__
+#define __DRIVERLIB_ROM_H__
+
+#include "driverlib/interrupt.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/timer.h"
+
+#define ROM_IntEnable                   IntEnable
+#define ROM_IntMasterEnable             IntMasterEnable
+#define ROM_IntMasterDisable            IntMasterDisable
+#define ROM_SysCtlPeripheralEnable      SysCtlPeripheralEnable
+#define ROM_TimerConfigure              TimerConfigure
+#define ROM_TimerEnable                 TimerEnable
+#define ROM_TimerIntClear               TimerIntClear
+#define ROM_TimerIntEnable              TimerIntEnable
+#define ROM_TimerIntStatus              TimerIntStatus
+#define ROM_TimerLoadSet                TimerLoadSet
+
+#endif // __DRIVERLIB_ROM_H__
@@ -0,0 +1,13 @@
+//*****************************************************************************
+//
+// rom_map.h - The mapped calls of the firmware go to the simulated
+// driverlib.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_ROM_MAP_H__
+#define __DRIVERLIB_ROM_MAP_H__
+
+#define MAP_SysCtlClockFreqSet          SysCtlClockFreqSet
+
+#endif // __DRIVERLIB_ROM_MAP_H__
@@ -0,0 +1,54 @@
+//*****************************************************************************
+//
+// sysctl.h - Simulated system control, same calls as the TivaWare
+// driverlib.  The clock is always the 120 MHz of the firmware.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_SYSCTL_H__
+#define __DRIVERLIB_SYSCTL_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define SYSCTL_PERIPH_ADC0      0xf0003800
+#define SYSCTL_PERIPH_GPIOA     0xf0000800
+#define SYSCTL_PERIPH_GPIOE     0xf0000804
+#define SYSCTL_PERIPH_GPIOF     0xf0000805
+#define SYSCTL_PERIPH_GPIOG     0xf0000806
+#define SYSCTL_PERIPH_GPIOK     0xf0000809
+#define SYSCTL_PERIPH_GPIOL     0xf000080a
+#define SYSCTL_PERIPH_GPIOP     0xf000080d
+#define SYSCTL_PERIPH_PWM0      0xf0004000
+#define SYSCTL_PERIPH_QEI0      0xf0004400
+#define SYSCTL_PERIPH_TIMER0    0xf0000400
+#define SYSCTL_PERIPH_TIMER1    0xf0000401
+#define SYSCTL_PERIPH_TIMER2    0xf0000402
+#define SYSCTL_PERIPH_TIMER3    0xf0000403
+#define SYSCTL_PERIPH_TIMER4    0xf0000404
+#define SYSCTL_PERIPH_TIMER5    0xf0000405
+#define SYSCTL_PERIPH_UART0     0xf0001800
+#define SYSCTL_PERIPH_UDMA      0xf0000c00
+
+#define SYSCTL_XTAL_25MHZ       0x00000680
+#define SYSCTL_OSC_MAIN         0x00000000
+#define SYSCTL_USE_PLL          0x00000000
+#define SYSCTL_CFG_VCO_480      0xF1000000
+
+extern void SysCtlPeripheralEnable(uint32_t ui32Peripheral);
+extern bool SysCtlPeripheralReady(uint32_t ui32Peripheral);
+extern uint32_t SysCtlClockGet(void);
+extern uint32_t SysCtlClockFreqSet(uint32_t ui32Config, uint32_t ui32SysClock);
+extern uint32_t SysCtlVCOGet(uint32_t ui32Crystal, uint32_t *pui32VCOFrequency);
+extern void SysCtlDelay(uint32_t ui32Count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __DRIVERLIB_SYSCTL_H__
@@ -0,0 +1,71 @@
+//*****************************************************************************
+//
+// timer.h - Simulated general purpose timers, same calls as the TivaWare
+// driverlib.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_TIMER_H__
+#define __DRIVERLIB_TIMER_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define TIMER_CFG_ONE_SHOT      0x00000021
+#define TIMER_CFG_PERIODIC      0x00000022
+#define TIMER_CFG_SPLIT_PAIR    0x04000000
+#define TIMER_CFG_A_ONE_SHOT    0x00000021
+#define TIMER_CFG_A_PERIODIC    0x00000022
+#define TIMER_CFG_A_PWM         0x0000000A
+#define TIMER_CFG_B_ONE_SHOT    0x00002100
+#define TIMER_CFG_B_PERIODIC    0x00002200
+#define TIMER_CFG_B_PWM         0x00000A00
+
+#define TIMER_TIMA_TIMEOUT      0x00000001
+#define TIMER_CAPA_MATCH        0x00000002
+#define TIMER_TIMB_TIMEOUT      0x00000100
+#define TIMER_CAPB_MATCH        0x00000200
+
+#define TIMER_A                 0x000000FF
+#define TIMER_B                 0x0000FF00
+#define TIMER_BOTH              0x0000FFFF
+
+#define TIMER_ADC_TIMEOUT_A     0x00000001
+#define TIMER_ADC_TIMEOUT_B     0x00000100
+
+extern void TimerEnable(uint32_t ui32Base, uint32_t ui32Timer);
+extern void TimerDisable(uint32_t ui32Base, uint32_t ui32Timer);
+extern void TimerConfigure(uint32_t ui32Base, uint32_t ui32Config);
+extern void TimerControlLevel(uint32_t ui32Base, uint32_t ui32Timer,
+                              bool bInvert);
+extern void TimerControlTrigger(uint32_t ui32Base, uint32_t ui32Timer,
+                                bool bEnable);
+extern void TimerADCEventSet(uint32_t ui32Base, uint32_t ui32ADCEvent);
+extern void TimerPrescaleSet(uint32_t ui32Base, uint32_t ui32Timer,
+                             uint32_t ui32Value);
+extern uint32_t TimerPrescaleGet(uint32_t ui32Base, uint32_t ui32Timer);
+extern void TimerPrescaleMatchSet(uint32_t ui32Base, uint32_t ui32Timer,
+                                  uint32_t ui32Value);
+extern uint32_t TimerPrescaleMatchGet(uint32_t ui32Base, uint32_t ui32Timer);
+extern void TimerLoadSet(uint32_t ui32Base, uint32_t ui32Timer,
+                         uint32_t ui32Value);
+extern uint32_t TimerLoadGet(uint32_t ui32Base, uint32_t ui32Timer);
+extern uint32_t TimerValueGet(uint32_t ui32Base, uint32_t ui32Timer);
+extern void TimerMatchSet(uint32_t ui32Base, uint32_t ui32Timer,
+                          uint32_t ui32Value);
+extern uint32_t TimerMatchGet(uint32_t ui32Base, uint32_t ui32Timer);
+extern void TimerIntEnable(uint32_t ui32Base, uint32_t ui32IntFlags);
+extern void TimerIntDisable(uint32_t ui32Base, uint32_t ui32IntFlags);
+extern uint32_t TimerIntStatus(uint32_t ui32Base, bool bMasked);
+extern void TimerIntClear(uint32_t ui32Base, uint32_t ui32IntFlags);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __DRIVERLIB_TIMER_H__
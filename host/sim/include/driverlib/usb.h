@@ -0,0 +1,24 @@
+//*****************************************************************************
+//
+// usb.h - Simulated USB controller, only the frame counter is read by the
+// firmware.
+//
+//*****************************************************************************
+
+#ifndef __DRIVERLIB_USB_H__
+#define __DRIVERLIB_USB_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+extern uint32_t USBFrameNumberGet(uint32_t ui32Base);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __DRIVERLIB_USB_H__
@@ -0,0 +1,12 @@
+//*****************************************************************************
+//
+// hw_adc.h - ADC register offsets used by the firmware.
+//
+//*****************************************************************************
+
+#ifndef __HW_ADC_H__
+#define __HW_ADC_H__
+
+#define ADC_O_SSFIFO0           0x00000048  // ADC Sample Sequence Result FIFO 0
+
+#endif // __HW_ADC_H__
@@ -0,0 +1,30 @@
+//*****************************************************************************
+//
+// hw_ints.h - Interrupt numbers of the TM4C1294 used by the firmware.
+//
+//*****************************************************************************
+
+#ifndef __HW_INTS_H__
+#define __HW_INTS_H__
+
+#define INT_GPIOA               16
+#define INT_GPIOE               20
+#define INT_UART0               21
+#define INT_QEI0                29
+#define INT_ADC0SS0             30
+#define INT_TIMER0A             35
+#define INT_TIMER1A             37
+#define INT_TIMER2A             39
+#define INT_GPIOF               46
+#define INT_GPIOG               47
+#define INT_TIMER3A             51
+#define INT_USB0                58
+#define INT_UDMAERR             61
+#define INT_GPIOK               68
+#define INT_GPIOL               69
+#define INT_TIMER4A             79
+#define INT_TIMER5A             81
+#define INT_GPIOP0              92
+#define NUM_INTERRUPTS          129
+
+#endif // __HW_INTS_H__
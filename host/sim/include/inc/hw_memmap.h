@@ -0,0 +1,39 @@
+//*****************************************************************************
+//
+// hw_memmap.h - Base addresses of the peripherals simulated on the host.
+// The values are the ones of the TM4C1294, the simulation only uses them
+// to tell the peripherals apart.
+//
+//*****************************************************************************
+
+#ifndef __HW_MEMMAP_H__
+#define __HW_MEMMAP_H__
+
+#define GPIO_PORTA_BASE         0x40058000
+#define GPIO_PORTB_BASE         0x40059000
+#define GPIO_PORTC_BASE         0x4005A000
+#define GPIO_PORTD_BASE         0x4005B000
+#define GPIO_PORTE_BASE         0x4005C000
+#define GPIO_PORTF_BASE         0x4005D000
+#define GPIO_PORTG_BASE         0x4005E000
+#define GPIO_PORTH_BASE         0x4005F000
+#define GPIO_PORTJ_BASE         0x40060000
+#define GPIO_PORTK_BASE         0x40061000
+#define GPIO_PORTL_BASE         0x40062000
+#define GPIO_PORTM_BASE         0x40063000
+#define GPIO_PORTN_BASE         0x40064000
+#define GPIO_PORTP_BASE         0x40065000
+#define GPIO_PORTQ_BASE         0x40066000
+#define UART0_BASE              0x4000C000
+#define PWM0_BASE               0x40028000
+#define QEI0_BASE               0x4002C000
+#define TIMER0_BASE             0x40030000
+#define TIMER1_BASE             0x40031000
+#define TIMER2_BASE             0x40032000
+#define TIMER3_BASE             0x40033000
+#define TIMER4_BASE             0x40034000
+#define TIMER5_BASE             0x40035000
+#define ADC0_BASE               0x40038000
+#define USB0_BASE               0x40050000
+
+#endif // __HW_MEMMAP_H__
@@ -0,0 +1,10 @@
+//*****************************************************************************
+//
+// hw_nvic.h - The firmware uses the NVIC through driverlib only.
+//
+//*****************************************************************************
+
+#ifndef __HW_NVIC_H__
+#define __HW_NVIC_H__
+
+#endif // __HW_NVIC_H__
@@ -0,0 +1,11 @@
+//*****************************************************************************
+//
+// hw_timer.h - The firmware uses the timer registers through driverlib
+// only.
+//
+//*****************************************************************************
+
+#ifndef __HW_TIMER_H__
+#define __HW_TIMER_H__
+
+#endif // __HW_TIMER_H__
@@ -0,0 +1,13 @@
+//*****************************************************************************
+//
+// hw_types.h - Common types and macros of the simulated peripherals.
+//
+//*****************************************************************************
+
+#ifndef __HW_TYPES_H__
+#define __HW_TYPES_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#endif // __HW_TYPES_H__
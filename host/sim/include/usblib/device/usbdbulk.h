@@ -0,0 +1,37 @@
+//*****************************************************************************
+//
+// usbdbulk.h - Type of the bulk device seen by the firmware modules.
+//
+//*****************************************************************************
+
+#ifndef __USBDBULK_H__
+#define __USBDBULK_H__
+
+#include <stdint.h>
+#include "usblib/usblib.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef struct
+{
+    const uint16_t ui16VID;
+    const uint16_t ui16PID;
+    const uint16_t ui16MaxPowermA;
+    const uint8_t ui8PwrAttributes;
+    const tUSBCallback pfnRxCallback;
+    void * const pvRxCBData;
+    const tUSBCallback pfnTxCallback;
+    void * const pvTxCBData;
+    const uint8_t * const *ppui8StringDescriptors;
+    const uint32_t ui32NumStringDescriptors;
+}
+tUSBDBulkDevice;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __USBDBULK_H__
@@ -0,0 +1,10 @@
+//*****************************************************************************
+//
+// usbdevice.h - The USB device of the host simulation is host/sim/sim_usb.c.
+//
+//*****************************************************************************
+
+#ifndef __USBDEVICE_H__
+#define __USBDEVICE_H__
+
+#endif // __USBDEVICE_H__
@@ -0,0 +1,13 @@
+//*****************************************************************************
+//
+// usb-ids.h - Vendor and product IDs of the bulk device.
+//
+//*****************************************************************************
+
+#ifndef __USBIDS_H__
+#define __USBIDS_H__
+
+#define USB_VID_TI_1CBE         0x1CBE
+#define USB_PID_BULK            0x0003
+
+#endif // __USBIDS_H__
@@ -0,0 +1,56 @@
+//*****************************************************************************
+//
+// usblib.h - Types of the USB library seen by the firmware modules.  The
+// host simulation replaces the USB device with host/sim/sim_usb.c, only
+// the declarations of usb_bulk_structs.h have to compile.
+//
+//*****************************************************************************
+
+#ifndef __USBLIB_H__
+#define __USBLIB_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define USB_EVENT_CONNECTED     0x0005
+#define USB_EVENT_DISCONNECTED  0x0006
+#define USB_EVENT_RX_AVAILABLE  0x0007
+#define USB_EVENT_TX_COMPLETE   0x000A
+#define USB_EVENT_SUSPEND       0x000C
+#define USB_EVENT_RESUME        0x000D
+
+typedef uint32_t (* tUSBCallback)(void *pvCBData, uint32_t ui32Event,
+                                  uint32_t ui32MsgParam, void *pvMsgData);
+
+typedef struct
+{
+    uint32_t ui32Size;
+    volatile uint32_t ui32WriteIndex;
+    volatile uint32_t ui32ReadIndex;
+    uint8_t *pui8Buffer;
+}
+tUSBRingBufObject;
+
+typedef struct
+{
+    bool bTransmitBuffer;
+    tUSBCallback pfnCallback;
+    void *pvCBData;
+    void *pfnTransfer;
+    void *pfnAvailable;
+    void *pvHandle;
+    uint8_t *pui8Buffer;
+    uint32_t ui32BufferSize;
+}
+tUSBBuffer;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __USBLIB_H__
@@ -0,0 +1,25 @@
+//*****************************************************************************
+//
+// uartstdio.h - Console of the host simulation, see simUartEcho.
+//
+//*****************************************************************************
+
+#ifndef __UARTSTDIO_H__
+#define __UARTSTDIO_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+extern void UARTStdioConfig(uint32_t ui32PortNum, uint32_t ui32Baud,
+                            uint32_t ui32SrcClock);
+extern void UARTprintf(const char *pcString, ...);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __UARTSTDIO_H__
@@ -0,0 +1,339 @@
+/*
+ * meccano_wire.c
+ *
+ * Purpose:  Virtual Meccano smart modules, see meccano_wire.h.  The frame
+ *           is sampled in the middle of every bit like a UART: the header
+ *           is found by its first 1 after the start bit, every other byte
+ *           by the falling edge of its start bit.  A frame with a wrong
+ *           checksum gets no reply.
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "linked_list_dbl.h"
+#include "Meccano.h"
+#include "sim.h"
+#include "meccano_wire.h"
+
+#define WIRE_BIT_CYCLES		((uint64_t)TIMER_LOADVALUE_417US + 1)
+#define WIRE_BYTE_BITS		10			// data and stop bits sampled
+
+//*****************************************************************************
+//
+// What the modules are listening for.
+//
+//*****************************************************************************
+#define WIRE_IDLE			0			// header, its first 1
+#define WIRE_BYTE			1			// sampling a byte
+#define WIRE_GAP			2			// start bit of the next byte
+#define WIRE_REPLY			3			// a module drives the line
+
+static uint32_t wirePort;
+static uint8_t wirePin;
+static uint32_t wireState;
+
+static struct sim_meccano_module modules[MECCANO_MODULE_NBR];
+static uint32_t moduleNbr;
+static uint8_t corruptMask;
+static struct sim_meccano_stats stats;
+
+static uint8_t frame[MECCANO_FRAME_SIZE];
+static uint32_t byteIndex;
+static uint32_t bitIndex;
+static uint32_t byteValue;
+static uint64_t byteStart;
+static struct sim_event sampleEvent;
+
+static uint8_t replyByte;
+static uint32_t replyEdge;				// 2 per bit, rise then fall
+static struct sim_event replyEvent;
+
+
+//*****************************************************************************
+//
+// A module takes its byte of the frame.
+//
+//*****************************************************************************
+static void moduleTake(struct sim_meccano_module *module_p, uint8_t data)
+{
+	if((data == MECCANO_DISCOVER) || (data == MECCANO_IDENTIFY))
+		return;
+	if(module_p->type == MECCANO_REPLY_LED)
+	{
+		module_p->led[(data & 0x40) ? 1 : 0] = data;
+		return;
+	}
+	if(data == MECCANO_LIM)
+		module_p->lim = true;
+	else if((data & 0xF8) == 0xF0)
+		module_p->color = data;
+	else if(data <= 0xEF)
+	{
+		module_p->lim = false;
+		if(data < MECCANO_SERVO_POS_MIN)
+			data = MECCANO_SERVO_POS_MIN;
+		if(data > MECCANO_SERVO_POS_MAX)
+			data = MECCANO_SERVO_POS_MAX;
+		module_p->position = data;
+	}
+}
+
+
+static uint8_t moduleReply(struct sim_meccano_module *module_p, uint8_t data)
+{
+	if(data == MECCANO_DISCOVER)
+		return MECCANO_REPLY_PRESENT;
+	if(data == MECCANO_IDENTIFY)
+		return module_p->type;
+	if(module_p->type == MECCANO_REPLY_LED)
+		return MECCANO_REPLY_LED;
+	return module_p->position;
+}
+
+
+//*****************************************************************************
+//
+// Reply on the line, one edge per event.
+//
+//*****************************************************************************
+static void replyFire(struct sim_event *event_p)
+{
+	uint32_t bit = replyEdge / 2;
+	uint64_t high;
+
+	if((replyEdge & 1) == 0)
+	{
+		simPinDrive(wirePort, wirePin, wirePin);
+		high = (replyByte & (1 << bit)) ? SIM_MECCANO_REPLY_ONE_US : SIM_MECCANO_REPLY_ZERO_US;
+		simSchedule(event_p, simCycles + high * SIM_CYCLES_PER_US);
+	}
+	else
+	{
+		simPinDrive(wirePort, wirePin, 0);
+		if(bit == 7)
+		{
+			wireState = WIRE_IDLE;
+			replyEdge = 0;
+			return;
+		}
+		high = (replyByte & (1 << bit)) ? SIM_MECCANO_REPLY_ONE_US : SIM_MECCANO_REPLY_ZERO_US;
+		simSchedule(event_p, simCycles + (SIM_MECCANO_REPLY_BIT_US - high) * SIM_CYCLES_PER_US);
+	}
+	replyEdge++;
+}
+
+
+//*****************************************************************************
+//
+// Whole frame received: every module takes its byte, the one addressed
+// replies.  Past the end of the chain the last module says 0x00.
+//
+//*****************************************************************************
+static void frameDone(void)
+{
+	uint8_t num = frame[5] & 0x0F;
+	uint32_t i;
+	struct sim_meccano_module *module_p;
+
+	stats.lastFrameCycle = simCycles;
+	if((frame[0] != MECCANO_HEADER) || (num >= MECCANO_MODULE_NBR) ||
+	   (meccanoCheckSum(&frame[1], num) != frame[5]))
+	{
+		stats.badFrames++;
+		wireState = WIRE_IDLE;
+		return;
+	}
+	stats.frames++;
+
+	for(i = 0; i < moduleNbr; i++)
+		moduleTake(&modules[i], frame[1 + i]);
+
+	wireState = WIRE_IDLE;
+	if(moduleNbr == 0)
+		return;
+	if(num >= moduleNbr)
+	{
+		module_p = &modules[moduleNbr - 1];
+		replyByte = MECCANO_REPLY_NONE;
+	}
+	else
+	{
+		module_p = &modules[num];
+		module_p->frames++;
+		replyByte = moduleReply(module_p, frame[1 + num]);
+	}
+	if(module_p->muted)
+		return;
+	module_p->replies++;
+	stats.replies++;
+	replyByte ^= corruptMask;
+	corruptMask = 0;
+
+	wireState = WIRE_REPLY;
+	replyEdge = 0;
+	replyEvent.fire = replyFire;
+	simSchedule(&replyEvent, simCycles + SIM_MECCANO_REPLY_DELAY_US * SIM_CYCLES_PER_US);
+}
+
+
+//*****************************************************************************
+//
+// Samples a bit in its middle: 8 data bits LSB first, then 2 stop bits
+// that have to be high.
+//
+//*****************************************************************************
+static void sampleFire(struct sim_event *event_p)
+{
+	bool high = (simPinLevel(wirePort, wirePin) != 0);
+
+	if((byteIndex == 0) && (bitIndex == 0) && !high)
+	{
+		// Only a glitch: the pin is made an output with the stop bit
+		// level still latched, then written low
+		wireState = WIRE_IDLE;
+		return;
+	}
+	if(bitIndex < 8)
+	{
+		if(high)
+			byteValue |= 1 << bitIndex;
+	}
+	else if(!high)
+	{
+		stats.badFrames++;
+		wireState = WIRE_IDLE;
+		return;
+	}
+
+	bitIndex++;
+	if(bitIndex < WIRE_BYTE_BITS)
+	{
+		simSchedule(event_p, byteStart + (bitIndex * 2 + 3) * WIRE_BIT_CYCLES / 2);
+		return;
+	}
+
+	frame[byteIndex++] = (uint8_t)byteValue;
+	if(byteIndex == MECCANO_FRAME_SIZE)
+		frameDone();
+	else
+		wireState = WIRE_GAP;
+}
+
+
+static void byteBegin(uint64_t start)
+{
+	byteStart = start;
+	byteValue = 0;
+	bitIndex = 0;
+	wireState = WIRE_BYTE;
+	sampleEvent.fire = sampleFire;
+	simSchedule(&sampleEvent, byteStart + 3 * WIRE_BIT_CYCLES / 2);
+}
+
+
+static void wireWatch(uint32_t port, uint8_t pins, uint8_t level, void *context)
+{
+	if((wireState == WIRE_IDLE) && (level != 0))
+	{
+		// First 1 of the header, the start bit was just before
+		byteIndex = 0;
+		byteBegin(simCycles - WIRE_BIT_CYCLES);
+	}
+	else if((wireState == WIRE_GAP) && (level == 0))
+		byteBegin(simCycles);
+}
+
+
+//*****************************************************************************
+//
+// Attaches an empty chain to a pin, after simInit().
+//
+//*****************************************************************************
+void simMeccanoInit(uint32_t port, uint8_t pin)
+{
+	wirePort = port;
+	wirePin = pin;
+	wireState = WIRE_IDLE;
+	moduleNbr = 0;
+	corruptMask = 0;
+	stats.frames = 0;
+	stats.badFrames = 0;
+	stats.replies = 0;
+	stats.lastFrameCycle = 0;
+	sampleEvent.queued = false;
+	replyEvent.queued = false;
+	simPinDrive(port, pin, 0);
+	simPinWatch(port, pin, wireWatch, NULL);
+}
+
+
+//*****************************************************************************
+//
+// Plugs a module at the end of the chain, returns its position or -1 when
+// the chain is full.
+//
+//*****************************************************************************
+int simMeccanoPlug(uint8_t type)
+{
+	struct sim_meccano_module *module_p;
+
+	if(moduleNbr == MECCANO_MODULE_NBR)
+		return -1;
+	module_p = &modules[moduleNbr];
+	module_p->type = type;
+	module_p->position = MECCANO_SERVO_POS_MID;
+	module_p->color = 0;
+	module_p->lim = false;
+	module_p->led[0] = 0;
+	module_p->led[1] = 0;
+	module_p->muted = false;
+	module_p->frames = 0;
+	module_p->replies = 0;
+	return moduleNbr++;
+}
+
+
+//*****************************************************************************
+//
+// Pulls a module out: the ones after it go with it, as they were
+// connected through it.
+//
+//*****************************************************************************
+void simMeccanoUnplug(uint32_t position)
+{
+	if(position < moduleNbr)
+		moduleNbr = position;
+}
+
+
+uint32_t simMeccanoCount(void)
+{
+	return moduleNbr;
+}
+
+
+struct sim_meccano_module *simMeccanoModule(uint32_t position)
+{
+	return (position < moduleNbr) ? &modules[position] : NULL;
+}
+
+
+//*****************************************************************************
+//
+// Flips bits of the next reply, as a glitch on the line would.
+//
+//*****************************************************************************
+void simMeccanoCorrupt(uint8_t xorMask)
+{
+	corruptMask = xorMask;
+}
+
+
+const struct sim_meccano_stats *simMeccanoStats(void)
+{
+	return &stats;
+}
@@ -0,0 +1,65 @@
+/*
+ * meccano_wire.h
+ *
+ * Purpose:  Chain of virtual Meccano smart modules on the wire of the
+ *           simulated board.  They decode the frames bit by bit from the
+ *           pin levels and answer in the timing of the real modules, so
+ *           that Meccano.c runs unchanged.
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+
+#ifndef MECCANO_WIRE_H_
+#define MECCANO_WIRE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+//*****************************************************************************
+//
+// Timing of the modules: one reply bit every 1200 us, the line high for
+// 800 us for a 1 and 200 us for a 0, the first one 1 ms after the last
+// stop bit of the frame.
+//
+//*****************************************************************************
+#define SIM_MECCANO_REPLY_DELAY_US	1000
+#define SIM_MECCANO_REPLY_BIT_US	1200
+#define SIM_MECCANO_REPLY_ONE_US	800
+#define SIM_MECCANO_REPLY_ZERO_US	200
+
+struct sim_meccano_module {
+   uint8_t type;							// MECCANO_REPLY_SERVO or _LED
+   uint8_t position;						// servo, moved by hand in LIM
+   uint8_t color;							// servo colour, 0xF0 - 0xF7
+   bool lim;								// servo not driven, reports its position
+   uint8_t led[2];							// LED colour bytes
+   bool muted;								// never replies
+   uint32_t frames;							// frames it was asked to reply to
+   uint32_t replies;
+};
+
+struct sim_meccano_stats {
+   uint32_t frames;							// frames decoded
+   uint32_t badFrames;						// framing or checksum errors
+   uint32_t replies;
+   uint64_t lastFrameCycle;					// end of the last frame decoded
+};
+
+void simMeccanoInit(uint32_t port, uint8_t pin);
+int simMeccanoPlug(uint8_t type);
+void simMeccanoUnplug(uint32_t position);
+uint32_t simMeccanoCount(void);
+struct sim_meccano_module *simMeccanoModule(uint32_t position);
+void simMeccanoCorrupt(uint8_t xorMask);
+const struct sim_meccano_stats *simMeccanoStats(void);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif /* MECCANO_WIRE_H_ */
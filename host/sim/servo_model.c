@@ -0,0 +1,82 @@
+/*
+ * servo_model.c
+ *
+ * Purpose:  Rate-limited servo shafts, see servo_model.h.
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "inc/hw_memmap.h"
+#include "driverlib/pwm.h"
+
+#include "sim.h"
+#include "servo_model.h"
+
+static const uint32_t servoOutput[SIM_SERVO_NBR] = {
+	PWM_OUT_0, PWM_OUT_1, PWM_OUT_2, PWM_OUT_3,
+	PWM_OUT_4, PWM_OUT_5, PWM_OUT_6, PWM_OUT_7
+};
+
+static double position[SIM_SERVO_NBR];
+static double servoRate;
+static struct sim_event stepEvent;
+
+
+static void servoStep(struct sim_event *event_p)
+{
+	double target;
+	int i;
+
+	for(i = 0; i < SIM_SERVO_NBR; i++)
+	{
+		target = PWMPulseWidthGet(PWM0_BASE, servoOutput[i]);
+		if(target > position[i] + servoRate)
+			position[i] += servoRate;
+		else if(target < position[i] - servoRate)
+			position[i] -= servoRate;
+		else
+			position[i] = target;
+	}
+	simSchedule(event_p, event_p->time + SIM_SERVO_STEP_US * SIM_CYCLES_PER_US);
+}
+
+
+//*****************************************************************************
+//
+// Puts the shafts where the outputs are, after initPWM().  Rate in PWM
+// counts per ms.
+//
+//*****************************************************************************
+void simServoInit(double rate)
+{
+	int i;
+
+	servoRate = rate;
+	for(i = 0; i < SIM_SERVO_NBR; i++)
+		position[i] = PWMPulseWidthGet(PWM0_BASE, servoOutput[i]);
+	stepEvent.queued = false;
+	stepEvent.fire = servoStep;
+	simSchedule(&stepEvent, simCycles + SIM_SERVO_STEP_US * SIM_CYCLES_PER_US);
+}
+
+
+double simServoPosition(uint32_t output)
+{
+	return (output < SIM_SERVO_NBR) ? position[output] : 0.0;
+}
+
+
+bool simServoSettled(void)
+{
+	int i;
+
+	for(i = 0; i < SIM_SERVO_NBR; i++)
+	{
+		if(position[i] != PWMPulseWidthGet(PWM0_BASE, servoOutput[i]))
+			return false;
+	}
+	return true;
+}
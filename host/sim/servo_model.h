@@ -0,0 +1,37 @@
+/*
+ * servo_model.h
+ *
+ * Purpose:  Shafts of the eight PWM servos of the simulated board.  Each
+ *           one follows the pulse width of its output at a limited rate,
+ *           as a hobby servo does, so that the host sees how far behind
+ *           the command the arm really is.
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+
+#ifndef SERVO_MODEL_H_
+#define SERVO_MODEL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#define SIM_SERVO_NBR			8
+#define SIM_SERVO_STEP_US		1000
+
+// 60 degrees in 150 ms: 600 us of pulse, PWM clock at system clock / 64
+#define SIM_SERVO_RATE_DEFAULT	7.5		// PWM counts per ms
+
+void simServoInit(double rate);
+double simServoPosition(uint32_t output);	// PWM counts
+bool simServoSettled(void);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif /* SERVO_MODEL_H_ */
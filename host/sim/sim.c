@@ -0,0 +1,317 @@
+/*
+ * sim.c
+ *
+ * Purpose:  Clock, events and NVIC of the host simulation.  Time only
+ *           moves in simRunUntil(): the events due are fired in time
+ *           order and the interrupt handlers they make pending run right
+ *           after, one at a time.  The main loop is an event too, it
+ *           runs every SIM_MAIN_LOOP_US.
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdio.h>
+
+#include "inc/hw_ints.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/sysctl.h"
+#include "utils/uartstdio.h"
+
+#include "sim.h"
+
+#define SIM_LINE_WORDS			((NUM_INTERRUPTS + 31) / 32)
+#define SIM_SERVICE_MAX			1000	// handlers in a row before the simulation gives up
+
+uint64_t simCycles;
+bool simUartEcho = false;
+
+// Cortex-M4 debug registers, see profile.h
+volatile uint32_t simDwtCtrl;
+volatile uint32_t simDwtCyccnt;
+volatile uint32_t simDemcr;
+
+static struct sim_event *eventHead_p;
+static struct sim_event mainLoopEvent;
+static void (*mainLoop)(void);
+
+static void (*vectors[NUM_INTERRUPTS])(void);
+static uint32_t lines[SIM_LINE_WORDS];			// asserted by the peripherals
+static uint32_t enabled[SIM_LINE_WORDS];		// IntEnable()
+static bool masterDisabled;
+static bool inHandler;
+
+
+//*****************************************************************************
+//
+// Moves the clock forward, the cycle counter with it once enabled.
+//
+//*****************************************************************************
+static void clockAdvance(uint64_t time)
+{
+	if(time <= simCycles)
+		return;
+	if((simDemcr & 0x01000000) && (simDwtCtrl & 0x00000001))
+		simDwtCyccnt += (uint32_t)(time - simCycles);
+	simCycles = time;
+}
+
+
+static void mainLoopFire(struct sim_event *event_p)
+{
+	mainLoop();
+	simSchedule(event_p, event_p->time + SIM_MAIN_LOOP_US * SIM_CYCLES_PER_US);
+}
+
+
+//*****************************************************************************
+//
+// Resets the clock, the events, the NVIC and the peripherals.
+//
+//*****************************************************************************
+void simInit(void)
+{
+	int i;
+
+	simCycles = 0;
+	simDwtCtrl = 0;
+	simDwtCyccnt = 0;
+	simDemcr = 0;
+	eventHead_p = NULL;
+	mainLoop = NULL;
+	mainLoopEvent.queued = false;
+	for(i = 0; i < NUM_INTERRUPTS; i++)
+		vectors[i] = NULL;
+	for(i = 0; i < SIM_LINE_WORDS; i++)
+	{
+		lines[i] = 0;
+		enabled[i] = 0;
+	}
+	masterDisabled = true;
+	inHandler = false;
+	simPeripheralInit();
+}
+
+
+//*****************************************************************************
+//
+// Queues an event, after the ones already due at the same time.
+//
+//*****************************************************************************
+void simSchedule(struct sim_event *event_p, uint64_t time)
+{
+	struct sim_event **pp;
+
+	if(event_p->queued)
+		simCancel(event_p);
+	event_p->time = time;
+	for(pp = &eventHead_p; (*pp != NULL) && ((*pp)->time <= time); pp = &(*pp)->next_p)
+		;
+	event_p->next_p = *pp;
+	*pp = event_p;
+	event_p->queued = true;
+}
+
+
+void simCancel(struct sim_event *event_p)
+{
+	struct sim_event **pp;
+
+	if(!event_p->queued)
+		return;
+	for(pp = &eventHead_p; *pp != NULL; pp = &(*pp)->next_p)
+	{
+		if(*pp == event_p)
+		{
+			*pp = event_p->next_p;
+			break;
+		}
+	}
+	event_p->queued = false;
+}
+
+
+//*****************************************************************************
+//
+// Fires the events due up to a time, then leaves the clock there.
+//
+//*****************************************************************************
+void simRunUntil(uint64_t time)
+{
+	struct sim_event *event_p;
+
+	while((eventHead_p != NULL) && (eventHead_p->time <= time))
+	{
+		event_p = eventHead_p;
+		eventHead_p = event_p->next_p;
+		event_p->queued = false;
+		clockAdvance(event_p->time);
+		event_p->fire(event_p);
+		simInterruptService();
+	}
+	clockAdvance(time);
+}
+
+
+void simRunUs(uint64_t us)
+{
+	simRunUntil(simCycles + us * SIM_CYCLES_PER_US);
+}
+
+
+void simRunMs(uint32_t ms)
+{
+	simRunUs((uint64_t)ms * 1000);
+}
+
+
+//*****************************************************************************
+//
+// Sets the main loop pass, run every SIM_MAIN_LOOP_US from now on.
+//
+//*****************************************************************************
+void simMainLoop(void (*loop)(void))
+{
+	mainLoop = loop;
+	mainLoopEvent.fire = mainLoopFire;
+	simSchedule(&mainLoopEvent, simCycles);
+}
+
+
+//*****************************************************************************
+//
+// NVIC.
+//
+//*****************************************************************************
+void simVectorSet(uint32_t interrupt, void (*handler)(void))
+{
+	vectors[interrupt] = handler;
+}
+
+
+void simInterruptLine(uint32_t interrupt, bool asserted)
+{
+	if(asserted)
+		lines[interrupt / 32] |= 1u << (interrupt % 32);
+	else
+		lines[interrupt / 32] &= ~(1u << (interrupt % 32));
+}
+
+
+//*****************************************************************************
+//
+// Runs the handlers of the interrupts pending, lowest number first as
+// they all have the same priority.  Does nothing inside a handler or
+// while the interrupts are masked, they run when that ends.
+//
+//*****************************************************************************
+void simInterruptService(void)
+{
+	uint32_t pending;
+	uint32_t interrupt;
+	int word;
+	int count;
+
+	if(inHandler || masterDisabled)
+		return;
+
+	inHandler = true;
+	for(count = 0; count < SIM_SERVICE_MAX; count++)
+	{
+		for(word = 0; word < SIM_LINE_WORDS; word++)
+		{
+			pending = lines[word] & enabled[word];
+			if(pending != 0)
+				break;
+		}
+		if(word == SIM_LINE_WORDS)
+			break;
+		interrupt = word * 32 + __builtin_ctz(pending);
+		if(vectors[interrupt] == NULL)
+		{
+			fprintf(stderr, "sim: interrupt %u has no handler\n", interrupt);
+			enabled[word] &= ~(1u << (interrupt % 32));
+			continue;
+		}
+		vectors[interrupt]();
+	}
+	if(count == SIM_SERVICE_MAX)
+		fprintf(stderr, "sim: interrupt %u is never cleared\n", interrupt);
+	inHandler = false;
+}
+
+
+bool IntMasterEnable(void)
+{
+	bool wasDisabled = masterDisabled;
+
+	masterDisabled = false;
+	simInterruptService();
+	return wasDisabled;
+}
+
+
+bool IntMasterDisable(void)
+{
+	bool wasDisabled = masterDisabled;
+
+	masterDisabled = true;
+	return wasDisabled;
+}
+
+
+void IntEnable(uint32_t ui32Interrupt)
+{
+	enabled[ui32Interrupt / 32] |= 1u << (ui32Interrupt % 32);
+	simInterruptService();
+}
+
+
+void IntDisable(uint32_t ui32Interrupt)
+{
+	enabled[ui32Interrupt / 32] &= ~(1u << (ui32Interrupt % 32));
+}
+
+
+uint32_t IntIsEnabled(uint32_t ui32Interrupt)
+{
+	return enabled[ui32Interrupt / 32] & (1u << (ui32Interrupt % 32));
+}
+
+
+//*****************************************************************************
+//
+// Three cycles per count.  The clock moves, the events due meanwhile are
+// fired on the next simRunUntil().
+//
+//*****************************************************************************
+void SysCtlDelay(uint32_t ui32Count)
+{
+	clockAdvance(simCycles + (uint64_t)ui32Count * 3);
+}
+
+
+//*****************************************************************************
+//
+// Console.
+//
+//*****************************************************************************
+void UARTStdioConfig(uint32_t ui32PortNum, uint32_t ui32Baud,
+                     uint32_t ui32SrcClock)
+{
+}
+
+
+void UARTprintf(const char *pcString, ...)
+{
+	va_list args;
+
+	if(!simUartEcho)
+		return;
+	va_start(args, pcString);
+	vfprintf(stderr, pcString, args);
+	va_end(args);
+}
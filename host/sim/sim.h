@@ -0,0 +1,111 @@
+/*
+ * sim.h
+ *
+ * Purpose:  Host simulation of the TM4C1294 running the firmware: a
+ *           cycle clock, the events due on it, the NVIC and the test
+ *           access to the simulated peripherals.
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+
+#ifndef SIM_H_
+#define SIM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#define SIM_CLOCK_HZ			120000000
+#define SIM_CYCLES_PER_US		(SIM_CLOCK_HZ / 1000000)
+#define SIM_MAIN_LOOP_US		10		// period of the main loop passes
+
+//*****************************************************************************
+//
+// Events of the simulated clock.  Handlers run one at a time, at the
+// same priority, as on the board; the code takes no simulated time.
+//
+//*****************************************************************************
+struct sim_event {
+   uint64_t time;							// cycles
+   void (*fire)(struct sim_event *event_p);
+   void *context;
+   struct sim_event *next_p;
+   bool queued;
+};
+
+extern uint64_t simCycles;					// since simInit()
+extern bool simUartEcho;					// UARTprintf() to stderr
+
+void simInit(void);
+void simSchedule(struct sim_event *event_p, uint64_t time);
+void simCancel(struct sim_event *event_p);
+void simRunUntil(uint64_t time);
+void simRunUs(uint64_t us);
+void simRunMs(uint32_t ms);
+void simMainLoop(void (*loop)(void));
+
+//*****************************************************************************
+//
+// NVIC: the peripherals drive the interrupt lines, simInterruptService()
+// runs the handlers of the lines enabled and asserted.
+//
+//*****************************************************************************
+void simVectorSet(uint32_t interrupt, void (*handler)(void));
+void simInterruptLine(uint32_t interrupt, bool asserted);
+void simInterruptService(void);
+
+//*****************************************************************************
+//
+// Outside world of the pins.  A pin configured as an input reads the
+// level driven here, a watcher is called on every change of the level of
+// its pins, whoever drives them.
+//
+//*****************************************************************************
+typedef void (*sim_pin_watcher)(uint32_t port, uint8_t pins, uint8_t level,
+								void *context);
+
+void simPinDrive(uint32_t port, uint8_t pins, uint8_t value);
+uint8_t simPinLevel(uint32_t port, uint8_t pins);
+bool simPinWatch(uint32_t port, uint8_t pins, sim_pin_watcher watcher,
+				 void *context);
+void simQeiMove(uint32_t base, int32_t counts);
+
+//*****************************************************************************
+//
+// USB bulk pipe seen from the host.  Both directions move once per
+// full-speed frame, SIM_USB_PACKETS packets at most.
+//
+//*****************************************************************************
+#define SIM_USB_FRAME_US		1000
+#define SIM_USB_PACKET			64
+#define SIM_USB_PACKETS			19
+
+void simUsbInit(void);
+void simUsbConnect(bool connected);
+void simUsbWrite(const uint8_t *data_p, uint32_t size);
+uint32_t simUsbRead(uint8_t *data_p, uint32_t size);
+uint32_t simUsbReadable(void);
+
+//*****************************************************************************
+//
+// Board: boots the firmware on the simulation and starts its main loop.
+//
+//*****************************************************************************
+void simBoardInit(void);
+
+//*****************************************************************************
+//
+// Peripherals, reset by simInit().
+//
+//*****************************************************************************
+void simPeripheralInit(void);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif /* SIM_H_ */
@@ -0,0 +1,101 @@
+/*
+ * sim_board.c
+ *
+ * Purpose:  Board of the host simulation: the vector table of
+ *           startup_ccs.c, the clock set by main() and the start-up of
+ *           the firmware.  The stack measurement of memory.c needs the
+ *           linker symbols of the board, it reports nothing here.
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "inc/hw_ints.h"
+#include "driverlib/sysctl.h"
+
+#include "linked_list_dbl.h"
+#include "servo.h"
+#include "dc_motor.h"
+#include "Meccano.h"
+#include "memory.h"
+#include "app.h"
+#include "sim.h"
+
+extern void Timer0AIntHandler(void);
+extern void Timer4AIntHandler(void);
+extern void Timer5AIntHandler(void);
+extern void CurrentSenseIntHandler(void);
+
+extern struct list_s left_arm_list[4];
+extern struct list_s right_arm_list[4];
+
+uint32_t ui32SysClock;
+
+uint32_t stackSize = 0;
+uint32_t stackPeak = 0;
+uint32_t heapSize = 0;
+
+static bool booted = false;
+
+
+void memoryInit(void)
+{
+}
+
+
+void memoryUpdate(void)
+{
+}
+
+
+//*****************************************************************************
+//
+// Gives back the nodes of the lists of a previous boot, so that a test
+// program can boot the firmware again.
+//
+//*****************************************************************************
+static void listsFree(void)
+{
+	int i;
+
+	for(i = 0; i < 4; i++)
+	{
+		Free_list(&left_arm_list[i]);
+		Free_list(&right_arm_list[i]);
+	}
+	for(i = 0; i < MECCANO_MODULE_NBR; i++)
+		Free_list(&meccano_servo_list[i]);
+	for(i = 0; i < DC_MOTOR_NBR; i++)
+		Free_list(&dc_motor_list[i]);
+}
+
+
+//*****************************************************************************
+//
+// Powers the board up: the firmware starts as from main() with the host
+// connected, the main loop runs with the simulated time.
+//
+//*****************************************************************************
+void simBoardInit(void)
+{
+	if(booted)
+		listsFree();
+	booted = true;
+
+	simInit();
+	simVectorSet(INT_TIMER0A, Timer0AIntHandler);
+	simVectorSet(INT_TIMER4A, Timer4AIntHandler);
+	simVectorSet(INT_TIMER5A, Timer5AIntHandler);
+	simVectorSet(INT_ADC0SS0, CurrentSenseIntHandler);
+
+	memoryInit();
+	ui32SysClock = SysCtlClockFreqSet((SYSCTL_XTAL_25MHZ | SYSCTL_OSC_MAIN |
+									   SYSCTL_USE_PLL | SYSCTL_CFG_VCO_480),
+									  120000000);
+	simUsbInit();
+	appInit();
+	simMainLoop(appProcess);
+}
@@ -0,0 +1,243 @@
+/*
+ * sim_usb.c
+ *
+ * Purpose:  USB bulk device of the host simulation, in place of the
+ *           USB library and of the transport of usb_dev_bulk.c.  Every
+ *           frame the host takes what the firmware queued and delivers
+ *           what it has written, the commands are decoded in the USB
+ *           handler straight from the receive ring as on the board.
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "inc/hw_ints.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/usb.h"
+#include "usblib/usblib.h"
+#include "usblib/device/usbdbulk.h"
+
+#include "usb_bulk_structs.h"
+#include "command.h"
+#include "profile.h"
+#include "sim.h"
+
+//*****************************************************************************
+//
+// Byte queue of the host side, grows as needed.
+//
+//*****************************************************************************
+struct sim_queue {
+   uint8_t *data_p;
+   uint32_t size;
+   uint32_t head;							// next byte read
+   uint32_t tail;							// next byte written
+};
+
+volatile uint32_t g_ui32TxCount = 0;
+volatile uint32_t g_ui32RxCount = 0;
+
+static bool configured;
+static uint32_t frame;
+static struct sim_event frameEvent;
+
+static uint8_t txRing[BULK_BUFFER_SIZE];	// firmware to host
+static uint32_t txRead, txCount;
+static uint8_t rxRing[BULK_BUFFER_SIZE];	// host to firmware
+static uint32_t rxRead, rxCount;
+
+static struct sim_queue hostOut;			// written by the host, not delivered yet
+static struct sim_queue hostIn;				// received by the host, not read yet
+
+
+static void queuePut(struct sim_queue *queue_p, const uint8_t *data_p, uint32_t size)
+{
+	if(queue_p->head == queue_p->tail)
+		queue_p->head = queue_p->tail = 0;
+	if(queue_p->tail + size > queue_p->size)
+	{
+		memmove(queue_p->data_p, queue_p->data_p + queue_p->head, queue_p->tail - queue_p->head);
+		queue_p->tail -= queue_p->head;
+		queue_p->head = 0;
+		if(queue_p->tail + size > queue_p->size)
+		{
+			queue_p->size = 2 * (queue_p->tail + size);
+			queue_p->data_p = realloc(queue_p->data_p, queue_p->size);
+		}
+	}
+	memcpy(queue_p->data_p + queue_p->tail, data_p, size);
+	queue_p->tail += size;
+}
+
+
+static uint32_t queueGet(struct sim_queue *queue_p, uint8_t *data_p, uint32_t size)
+{
+	if(size > queue_p->tail - queue_p->head)
+		size = queue_p->tail - queue_p->head;
+	memcpy(data_p, queue_p->data_p + queue_p->head, size);
+	queue_p->head += size;
+	return size;
+}
+
+
+//*****************************************************************************
+//
+// USB interrupt handler: decodes the commands delivered, counted in the
+// profile of the USB handler as on the board.
+//
+//*****************************************************************************
+static void simUsbIntHandler(void)
+{
+	uint32_t ui32Count;
+	PROFILE_ISR_ENTER();
+
+	simInterruptLine(INT_USB0, false);
+	commandRxCycles = ui32ProfileStart;
+	if(rxCount != 0)
+	{
+		ui32Count = CommandProcess(rxRing, BULK_BUFFER_SIZE, rxRead, rxCount);
+		rxRead = (rxRead + ui32Count) % BULK_BUFFER_SIZE;
+		rxCount -= ui32Count;
+		g_ui32RxCount += ui32Count;
+	}
+	PROFILE_ISR_EXIT(PROFILE_USB0);
+}
+
+
+//*****************************************************************************
+//
+// Start of frame: the IN packets go to the host, the OUT packets the
+// receive ring has room for are delivered.
+//
+//*****************************************************************************
+static void frameFire(struct sim_event *event_p)
+{
+	uint32_t size;
+	uint32_t chunk;
+	uint32_t write;
+
+	frame++;
+	simSchedule(event_p, event_p->time + SIM_USB_FRAME_US * SIM_CYCLES_PER_US);
+	if(!configured)
+		return;
+
+	size = (txCount < SIM_USB_PACKETS * SIM_USB_PACKET) ? txCount : SIM_USB_PACKETS * SIM_USB_PACKET;
+	while(size != 0)
+	{
+		chunk = (txRead + size > BULK_BUFFER_SIZE) ? BULK_BUFFER_SIZE - txRead : size;
+		queuePut(&hostIn, &txRing[txRead], chunk);
+		txRead = (txRead + chunk) % BULK_BUFFER_SIZE;
+		txCount -= chunk;
+		g_ui32TxCount += chunk;
+		size -= chunk;
+	}
+
+	size = hostOut.tail - hostOut.head;
+	if(size > SIM_USB_PACKETS * SIM_USB_PACKET)
+		size = SIM_USB_PACKETS * SIM_USB_PACKET;
+	if(size > BULK_BUFFER_SIZE - rxCount)
+		size = BULK_BUFFER_SIZE - rxCount;
+	if(size == 0)
+		return;
+	while(size != 0)
+	{
+		write = (rxRead + rxCount) % BULK_BUFFER_SIZE;
+		chunk = (write + size > BULK_BUFFER_SIZE) ? BULK_BUFFER_SIZE - write : size;
+		queueGet(&hostOut, &rxRing[write], chunk);
+		rxCount += chunk;
+		size -= chunk;
+	}
+	simInterruptLine(INT_USB0, true);
+}
+
+
+//*****************************************************************************
+//
+// Enumerated and configured, with empty buffers.
+//
+//*****************************************************************************
+void simUsbInit(void)
+{
+	g_ui32TxCount = 0;
+	g_ui32RxCount = 0;
+	configured = true;
+	frame = 0;
+	txRead = txCount = 0;
+	rxRead = rxCount = 0;
+	hostOut.head = hostOut.tail = 0;
+	hostIn.head = hostIn.tail = 0;
+	simVectorSet(INT_USB0, simUsbIntHandler);
+	IntEnable(INT_USB0);
+	frameEvent.fire = frameFire;
+	simSchedule(&frameEvent, simCycles + SIM_USB_FRAME_US * SIM_CYCLES_PER_US);
+}
+
+
+void simUsbConnect(bool connected)
+{
+	configured = connected;
+	if(!connected)
+	{
+		txRead = txCount = 0;
+		rxRead = rxCount = 0;
+	}
+}
+
+
+void simUsbWrite(const uint8_t *data_p, uint32_t size)
+{
+	queuePut(&hostOut, data_p, size);
+}
+
+
+uint32_t simUsbRead(uint8_t *data_p, uint32_t size)
+{
+	return queueGet(&hostIn, data_p, size);
+}
+
+
+uint32_t simUsbReadable(void)
+{
+	return hostIn.tail - hostIn.head;
+}
+
+
+//*****************************************************************************
+//
+// Queues a packet for the host, the whole packet or nothing, as the
+// USBSendPacket() of usb_dev_bulk.c.
+//
+//*****************************************************************************
+uint32_t
+USBSendPacket(const uint8_t *pui8Data, uint32_t ui32Size)
+{
+	uint32_t ui32Queued = 0;
+	uint32_t write;
+	bool bMasked;
+
+	bMasked = IntMasterDisable();
+	if(configured && (BULK_BUFFER_SIZE - txCount >= ui32Size))
+	{
+		for(ui32Queued = 0; ui32Queued < ui32Size; ui32Queued++)
+		{
+			write = (txRead + txCount) % BULK_BUFFER_SIZE;
+			txRing[write] = pui8Data[ui32Queued];
+			txCount++;
+		}
+	}
+	if(!bMasked)
+	{
+		IntMasterEnable();
+	}
+	return(ui32Queued);
+}
+
+
+uint32_t USBFrameNumberGet(uint32_t ui32Base)
+{
+	return frame & 0x7FF;
+}
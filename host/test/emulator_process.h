@@ -0,0 +1,131 @@
+//
+// emulator_process.h
+//
+// usb_emulator started for a test on a socket of its own, with a client
+// connected to it.  The emulator is stopped when the object goes.
+//
+#ifndef EMULATOR_PROCESS_H_
+#define EMULATOR_PROCESS_H_
+
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+class EmulatorProcess {
+public:
+    // Arguments after --socket, e.g. {"--fast"}
+    explicit EmulatorProcess(const std::vector<std::string> &args = {})
+    {
+        path_ = "/tmp/usb_emulator_" + std::to_string(::getpid()) + "_" +
+                std::to_string(count_++) + ".sock";
+
+        std::vector<std::string> argv = {EMULATOR_PATH, "--socket", path_, "--quiet"};
+        argv.insert(argv.end(), args.begin(), args.end());
+
+        pid_ = ::fork();
+        if(pid_ == 0)
+        {
+            std::vector<char *> c;
+
+            for(std::string &arg : argv)
+                c.push_back(&arg[0]);
+            c.push_back(nullptr);
+            ::execv(c[0], c.data());
+            ::_exit(127);
+        }
+    }
+
+    ~EmulatorProcess()
+    {
+        disconnect();
+        stop();
+    }
+
+    const std::string &path() const { return path_; }
+
+    // Connects to the emulator once it listens, false after timeoutMs
+    bool connect(uint32_t timeoutMs = 2000)
+    {
+        sockaddr_un address = {};
+
+        address.sun_family = AF_UNIX;
+        std::strcpy(address.sun_path, path_.c_str());
+        for(uint32_t ms = 0; ms < timeoutMs; ms += 10)
+        {
+            fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            if(::connect(fd_, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0)
+                return true;
+            ::close(fd_);
+            fd_ = -1;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return false;
+    }
+
+    void disconnect()
+    {
+        if(fd_ >= 0)
+            ::close(fd_);
+        fd_ = -1;
+    }
+
+    int fd() const { return fd_; }
+
+    bool send(const std::vector<uint8_t> &data)
+    {
+        return ::send(fd_, data.data(), data.size(), MSG_NOSIGNAL) == ssize_t(data.size());
+    }
+
+    // Exactly size bytes, fewer if none came for timeoutMs
+    std::vector<uint8_t> receive(size_t size, int timeoutMs = 1000)
+    {
+        std::vector<uint8_t> data(size);
+        size_t got = 0;
+
+        while(got < size)
+        {
+            pollfd pfd = {fd_, POLLIN, 0};
+
+            if(::poll(&pfd, 1, timeoutMs) <= 0)
+                break;
+            ssize_t n = ::recv(fd_, &data[got], size - got, 0);
+            if(n <= 0)
+                break;
+            got += size_t(n);
+        }
+        data.resize(got);
+        return data;
+    }
+
+    // SIGTERM, then the exit status of the emulator
+    int stop()
+    {
+        int status = -1;
+
+        if(pid_ > 0)
+        {
+            ::kill(pid_, SIGTERM);
+            ::waitpid(pid_, &status, 0);
+            pid_ = -1;
+        }
+        return status;
+    }
+
+private:
+    static inline int count_ = 0;
+    std::string path_;
+    pid_t pid_ = -1;
+    int fd_ = -1;
+};
+
+#endif /* EMULATOR_PROCESS_H_ */
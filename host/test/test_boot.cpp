@@ -0,0 +1,109 @@
+//
+// test_boot.cpp
+//
+// The firmware booted on the simulated board: tick, servo outputs and a
+// command through the USB pipe.
+//
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "sim.h"
+#include "driverlib/pwm.h"
+#include "inc/hw_memmap.h"
+#include "protocol.h"
+#include "command.h"
+extern "C" {
+#include "timer_handler.h"
+}
+
+namespace {
+
+class BootTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        simBoardInit();
+    }
+
+    // Runs until the firmware has answered, at most timeoutMs
+    std::vector<uint8_t> reply(uint32_t size, uint32_t timeoutMs = 10)
+    {
+        std::vector<uint8_t> data(size);
+        uint32_t got = 0;
+
+        for(uint32_t ms = 0; (ms < timeoutMs) && (got < size); ms++)
+        {
+            simRunMs(1);
+            got += simUsbRead(&data[got], size - got);
+        }
+        data.resize(got);
+        return data;
+    }
+};
+
+uint32_t get32(const uint8_t *p)
+{
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) |
+           (uint32_t(p[2]) << 8) | p[3];
+}
+
+TEST_F(BootTest, TickCountsMilliseconds)
+{
+    uint32_t start = milli_second;
+
+    // The tick reloads with ui32SysClock / 1000, one cycle more each period
+    simRunMs(100);
+    EXPECT_NEAR(double(milli_second - start), 100.0, 1.0);
+}
+
+TEST_F(BootTest, ServosStartCentred)
+{
+    EXPECT_EQ(PWMPulseWidthGet(PWM0_BASE, PWM_OUT_0), 2575u);
+    EXPECT_EQ(PWMPulseWidthGet(PWM0_BASE, PWM_OUT_3), 2000u);
+    EXPECT_EQ(PWMPulseWidthGet(PWM0_BASE, PWM_OUT_4), 2500u);
+}
+
+TEST_F(BootTest, ServoDirectSetsWidth)
+{
+    const uint8_t cmd[] = {SERVO_DIRECT_CMD, 2, 0x00, 0x00, 0x0B, 0xB8};
+
+    simRunMs(5);
+    simUsbWrite(cmd, sizeof(cmd));
+    simRunMs(3);
+    EXPECT_EQ(PWMPulseWidthGet(PWM0_BASE, PWM_OUT_2), 3000u);
+    EXPECT_EQ(simUsbReadable(), 0u);
+}
+
+TEST_F(BootTest, PingEchoesTimeStamp)
+{
+    const uint8_t cmd[] = {PING_CMD, 1, 2, 3, 4, 5, 6, 7, 8};
+
+    simRunMs(20);
+    simUsbWrite(cmd, sizeof(cmd));
+    std::vector<uint8_t> data = reply(25);
+
+    ASSERT_EQ(data.size(), 25u);
+    EXPECT_EQ(data[0], PING_CMD);
+    for(int i = 0; i < 8; i++)
+        EXPECT_EQ(data[1 + i], cmd[1 + i]);
+    EXPECT_GE(get32(&data[9]), 20u);
+    EXPECT_EQ(get32(&data[21]), uint32_t(SIM_CLOCK_HZ));
+}
+
+TEST_F(BootTest, UnknownOpcodeIsAcknowledged)
+{
+    const uint8_t cmd[] = {SEQ_CMD, 42, 0x7E, 0, 0, 0, 0};
+
+    simRunMs(5);
+    simUsbWrite(cmd, sizeof(cmd));
+    std::vector<uint8_t> data = reply(7);
+
+    ASSERT_EQ(data.size(), 7u);
+    EXPECT_EQ(data[0], ACK_MSG);
+    EXPECT_EQ(data[1], 42);
+    EXPECT_EQ(data[2], ACK_UNKNOWN);
+}
+
+}  // namespace
@@ -0,0 +1,193 @@
+//
+// test_client.cpp
+//
+// The host client library: command encoders, cutting of the device
+// stream, and the client against usb_emulator, with several commands in
+// one transfer and several transfers in flight.
+//
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "emulator_process.h"
+#include "client.h"
+#include "protocol.h"
+#include "command.h"
+#include "telemetry.h"
+
+namespace {
+
+using bulk::Command;
+namespace cmd = bulk::cmd;
+
+TEST(Commands, EncodeAsTheFirmwareParses)
+{
+    EXPECT_EQ(cmd::servoDirect(2, 3000), (Command{SERVO_DIRECT_CMD, 2, 0, 0, 0x0B, 0xB8}));
+    EXPECT_EQ(cmd::dcSpeed(-1, 0x1234), (Command{DC_SPEED_CMD, 0xFF, 0xFF, 0x12, 0x34}));
+    EXPECT_EQ(cmd::dcPid(true, 2048, 256, 0, 3000),
+              (Command{DC_PID_CMD, 1, 0x08, 0x00, 0x01, 0x00, 0, 0, 0x0B, 0xB8}));
+    EXPECT_EQ(cmd::telemetry(10, TELEMETRY_ODOMETRY), (Command{TELEMETRY_CMD, 0, 10, 1}));
+    EXPECT_EQ(cmd::ping(0x0102030405060708ull),
+              (Command{PING_CMD, 1, 2, 3, 4, 5, 6, 7, 8}));
+    EXPECT_EQ(cmd::servoChargeMovement({{1, 0, 500, 2500}}),
+              (Command{SERVO_CHARGE_MVMT_CMD, 1, 1, 0, 0, 0, 0, 0, 0, 0x01, 0xF4,
+                       0, 0, 0x09, 0xC4}));
+    EXPECT_EQ(cmd::meccanoLedSequence(2, {{1, 2, 3, 4, 0x0105}}),
+              (Command{MECCANO_LED_SEQ_CMD, 2, 1, 1, 2, 3, 4, 0x01, 0x05}));
+    EXPECT_EQ(cmd::at(100, cmd::trace(0)),
+              (Command{AT_CMD, 0, 0, 0, 100, 2, TRACE_CMD, 0}));
+    EXPECT_THROW(cmd::at(0, Command(59)), std::invalid_argument);
+    EXPECT_THROW(cmd::dcChargeMovement(std::vector<bulk::Keyframe>(256)),
+                 std::invalid_argument);
+}
+
+TEST(Decoder, CutsAStreamSplitAnywhere)
+{
+    const uint8_t stream[] = {
+        ACK_MSG, 7, ACK_OK, 0x01, 0x00, 0x00, 0x40,
+        0x7E,                                   // starts no message
+        PING_CMD, 0, 0, 0, 0, 0, 0, 0, 9, 0, 0, 0, 1,
+        0, 0, 0, 2, 0, 0, 0, 3, 0x07, 0x27, 0x0E, 0x00};
+    bulk::Decoder decoder;
+    std::vector<bulk::Message> messages;
+
+    for(uint8_t byte : stream)
+        decoder.push(&byte, 1, [&](const bulk::Message &m) { messages.push_back(m); });
+
+    ASSERT_EQ(messages.size(), 2u);
+    bulk::Ack ack;
+    bulk::Ping ping;
+    ASSERT_TRUE(bulk::decodeAck(messages[0], ack));
+    EXPECT_EQ(ack.seq, 7);
+    EXPECT_EQ(ack.rxFree, 256);
+    EXPECT_EQ(ack.nodesFree, 64);
+    ASSERT_TRUE(bulk::decodePing(messages[1], ping));
+    EXPECT_EQ(ping.stamp, 9u);
+    EXPECT_EQ(ping.sysClock, 120000000u);
+    EXPECT_EQ(decoder.skipped(), 1u);
+}
+
+TEST(Decoder, CutsTelemetryWithItsChannels)
+{
+    std::vector<uint8_t> packet = {TELEMETRY_MSG, 0, 0, 0, 42, TELEMETRY_CURRENT, 12};
+    bulk::Decoder decoder;
+    std::vector<bulk::Message> messages;
+
+    packet.resize(packet.size() + 12, 0);
+    packet[8] = 100;                            // left, 100 mA
+    packet.push_back(PING_CMD);
+    decoder.setTelemetryChannels(TELEMETRY_CURRENT);
+    decoder.push(packet.data(), packet.size(),
+                 [&](const bulk::Message &m) { messages.push_back(m); });
+
+    ASSERT_EQ(messages.size(), 1u);
+    bulk::Telemetry telemetry;
+    ASSERT_TRUE(bulk::decodeTelemetry(messages[0], telemetry));
+    EXPECT_EQ(telemetry.ms, 42u);
+    EXPECT_TRUE(telemetry.hasCurrent);
+    EXPECT_FALSE(telemetry.hasOdometry);
+    EXPECT_EQ(telemetry.milliAmp[0], 100);
+}
+
+class ClientTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        ASSERT_TRUE(emulator_.connect());
+        emulator_.disconnect();
+        transport_ = std::make_unique<bulk::SocketTransport>(emulator_.path());
+    }
+
+    // Polls until done() or timeoutMs of wall time
+    bool pollUntil(bulk::Client &client, const std::function<bool()> &done,
+                   int timeoutMs = 2000)
+    {
+        auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+
+        while(!done())
+        {
+            if((std::chrono::steady_clock::now() > end) || !client.poll(1))
+                return false;
+        }
+        return true;
+    }
+
+    EmulatorProcess emulator_{{"--fast"}};
+    std::unique_ptr<bulk::SocketTransport> transport_;
+};
+
+TEST_F(ClientTest, BatchesSeveralCommandsInOneTransfer)
+{
+    bulk::Client client(*transport_);
+    std::vector<bulk::Message> replies;
+    std::vector<bulk::Ack> acks;
+
+    client.onMessage([&](const bulk::Message &m) { replies.push_back(m); });
+    client.onAck([&](const bulk::Ack &ack) { acks.push_back(ack); });
+
+    client.send(cmd::servoDirect(0, 3000));
+    client.send(cmd::servoDirect(1, 2000));
+    client.send(cmd::ping(1));
+    client.send(cmd::ping(2));
+    uint8_t seq = client.sendSequenced(cmd::dcGetPosition());
+    ASSERT_TRUE(pollUntil(client, [&] { return (replies.size() == 3) && !acks.empty(); }));
+
+    EXPECT_EQ(client.stats().commands, 5u);
+    EXPECT_EQ(client.stats().frames, 1u);
+    EXPECT_EQ(client.stats().bytesOut, 6u + 6u + 9u + 9u + 2u + 1u);
+    EXPECT_EQ(client.stats().skipped, 0u);
+
+    // Executed in order, the sequenced one acknowledged
+    bulk::Ping ping;
+    ASSERT_TRUE(bulk::decodePing(replies[0], ping));
+    EXPECT_EQ(ping.stamp, 1u);
+    ASSERT_TRUE(bulk::decodePing(replies[1], ping));
+    EXPECT_EQ(ping.stamp, 2u);
+    EXPECT_EQ(replies[2].opcode, DC_GET_POSITION_CMD);
+    EXPECT_EQ(replies[2].data.size(), 21u);
+    EXPECT_EQ(acks[0].seq, seq);
+    EXPECT_EQ(acks[0].status, ACK_OK);
+}
+
+TEST_F(ClientTest, KeepsSeveralTransfersInFlight)
+{
+    bulk::Client client(*transport_, 64, 4);
+    std::vector<bulk::Ack> acks;
+    uint8_t last = 0;
+
+    client.onAck([&](const bulk::Ack &ack) { acks.push_back(ack); });
+
+    // 8 sequenced commands of 8 bytes per 64-byte frame, more than the
+    // receive ring holds: the link holds them back until there is room
+    for(uint32_t i = 0; i < 40; i++)
+        last = client.sendSequenced(cmd::servoDirect(uint8_t(i % 8), 2000 + i));
+    ASSERT_TRUE(pollUntil(client, [&] { return !acks.empty() && (acks.back().seq == last); }));
+
+    EXPECT_EQ(client.stats().frames, 5u);
+    EXPECT_EQ(client.stats().maxInFlight, 4u);
+    EXPECT_EQ(client.stats().failed, 0u);
+    for(const bulk::Ack &ack : acks)
+        EXPECT_EQ(ack.status, ACK_OK);
+}
+
+TEST_F(ClientTest, DeliversTelemetry)
+{
+    bulk::Client client(*transport_);
+    std::vector<bulk::Telemetry> packets;
+
+    client.onTelemetry([&](const bulk::Telemetry &t) { packets.push_back(t); });
+    client.send(cmd::telemetry(10, TELEMETRY_ODOMETRY | TELEMETRY_MEMORY));
+    ASSERT_TRUE(pollUntil(client, [&] { return packets.size() >= 3; }));
+
+    EXPECT_TRUE(packets[2].hasOdometry);
+    EXPECT_TRUE(packets[2].hasMemory);
+    EXPECT_FALSE(packets[2].hasCurrent);
+    EXPECT_EQ(packets[2].ms - packets[1].ms, 10u);
+    EXPECT_EQ(client.stats().skipped, 0u);
+}
+
+}  // namespace
@@ -0,0 +1,155 @@
+//
+// test_dc_plant.cpp
+//
+// The wheel motors, encoders and speed loop of the firmware against the
+// motor model of the simulated board.
+//
+#include <cstdint>
+#include <cstdlib>
+
+#include <gtest/gtest.h>
+
+#include "speed_step.h"
+#include "sim.h"
+#include "dc_plant.h"
+#include "protocol.h"
+extern "C" {
+#include "dc_motor.h"
+#include "dc_encoder.h"
+}
+
+namespace {
+
+double tailVelocity(const speed::Result &result, uint32_t ms)
+{
+    double sum = 0.0;
+
+    for(size_t i = result.samples.size() - ms; i < result.samples.size(); i++)
+        sum += result.samples[i].velocity;
+    return sum / ms;
+}
+
+uint32_t get32(const uint8_t *p)
+{
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) |
+           (uint32_t(p[2]) << 8) | p[3];
+}
+
+TEST(DcPlant, OpenLoopHalfDutyRunsAtHalfSpeed)
+{
+    speed::Config config;
+
+    config.closedLoop = false;
+    config.plant.stiction = 0.0;
+    speed::Result result = speed::run(config);
+
+    EXPECT_NEAR(simPlantDuty(DC_LEFT), 0.5, 0.001);
+    EXPECT_NEAR(tailVelocity(result, 100), 1500.0, 15.0);
+    EXPECT_NEAR(dcWheelVelocity[DC_LEFT], 1500, 100);
+    EXPECT_NEAR(dcWheelVelocity[DC_RIGHT], 1500, 100);
+    // Every count of the model reaches the encoders
+    EXPECT_EQ(dcEncoderPosition(DC_LEFT), simPlantPosition(DC_LEFT));
+    EXPECT_EQ(dcEncoderPosition(DC_RIGHT), simPlantPosition(DC_RIGHT));
+    EXPECT_GT(simPlantPosition(DC_RIGHT), 1000);
+}
+
+TEST(DcPlant, BackwardCountsDown)
+{
+    speed::Config config;
+
+    config.closedLoop = false;
+    config.setpoint = -8192;
+    config.durationMs = 500;
+    speed::run(config);
+
+    EXPECT_LT(simPlantDuty(DC_RIGHT), -0.2);
+    EXPECT_LT(dcEncoderPosition(DC_LEFT), -200);
+    EXPECT_EQ(dcEncoderPosition(DC_RIGHT), simPlantPosition(DC_RIGHT));
+    EXPECT_LT(dcWheelVelocity[DC_RIGHT], 0);
+}
+
+TEST(DcPlant, StictionHoldsSmallDuty)
+{
+    speed::Config config;
+
+    config.closedLoop = false;
+    config.setpoint = 1000;             // 3 % duty
+    config.durationMs = 300;
+    speed::run(config);
+
+    EXPECT_EQ(simPlantPosition(DC_LEFT), 0);
+    EXPECT_EQ(dcWheelVelocity[DC_LEFT], 0);
+}
+
+TEST(DcPlant, GetPositionReportsEncoders)
+{
+    speed::Config config;
+    const uint8_t cmd[] = {DC_GET_POSITION_CMD};
+    uint8_t reply[17];
+    uint32_t got = 0;
+
+    config.closedLoop = false;
+    config.durationMs = 300;
+    speed::run(config);
+
+    simUsbWrite(cmd, sizeof(cmd));
+    for(int ms = 0; (ms < 10) && (got < sizeof(reply)); ms++)
+    {
+        simRunMs(1);
+        got += simUsbRead(&reply[got], sizeof(reply) - got);
+    }
+    ASSERT_EQ(got, sizeof(reply));
+    EXPECT_EQ(reply[0], DC_GET_POSITION_CMD);
+    EXPECT_NEAR(double(int32_t(get32(&reply[5]))), double(simPlantPosition(DC_LEFT)), 10.0);
+    EXPECT_NEAR(double(int32_t(get32(&reply[13]))), double(simPlantPosition(DC_RIGHT)), 10.0);
+}
+
+TEST(DcPlant, ClosedLoopSettles)
+{
+    speed::Config config;
+    speed::Result result = speed::run(config);
+
+    EXPECT_GT(result.riseMs, 0.0);
+    EXPECT_LT(result.overshoot, 25.0);
+    EXPECT_GT(result.settleMs, 0.0);
+    EXPECT_LT(result.settleMs, 500.0);
+    EXPECT_LT(std::abs(result.steadyError), 3.0);
+}
+
+TEST(DcPlant, ClosedLoopRejectsLoad)
+{
+    speed::Config config;
+
+    config.durationMs = 1500;
+    config.loadStepMs = 500;
+    config.loadStep = 600.0;
+
+    config.closedLoop = false;
+    double open = tailVelocity(speed::run(config), 100);
+    config.closedLoop = true;
+    speed::Result closed = speed::run(config);
+
+    EXPECT_LT(open, 0.7 * closed.target);
+    EXPECT_NEAR(tailVelocity(closed, 100), closed.target, 0.03 * closed.target);
+    EXPECT_LT(closed.loadDip, 30.0);
+}
+
+TEST(DcPlant, GainsAreTunedAtRuntime)
+{
+    speed::Config config;
+
+    config.kp = 0;
+    config.ki = 0;
+    config.plant.load = 300.0;
+    speed::Result feedforward = speed::run(config);
+    EXPECT_EQ(dcPid[DC_LEFT].kp, 0);
+
+    config.ki = 256;
+    speed::Result integral = speed::run(config);
+
+    // Without gains only the feedforward drives, the load is not made up
+    EXPECT_GT(feedforward.steadyError, 15.0);
+    EXPECT_LT(std::abs(integral.steadyError), 3.0);
+}
+
+}  // namespace
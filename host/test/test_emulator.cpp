@@ -0,0 +1,151 @@
+//
+// test_emulator.cpp
+//
+// usb_emulator seen from a client of its socket: commands answered as
+// over USB, telemetry streamed, the firmware running between clients, and
+// the rate-limited servo shafts of the simulated board.
+//
+#include <cstdint>
+#include <sys/stat.h>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "emulator_process.h"
+#include "sim.h"
+#include "servo_model.h"
+#include "driverlib/pwm.h"
+#include "inc/hw_memmap.h"
+#include "protocol.h"
+#include "command.h"
+#include "telemetry.h"
+#include "bench.h"
+
+namespace {
+
+uint32_t get32(const uint8_t *p)
+{
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) |
+           (uint32_t(p[2]) << 8) | p[3];
+}
+
+std::vector<uint8_t> ping(EmulatorProcess &emulator, uint8_t stamp)
+{
+    emulator.send({PING_CMD, 0, 0, 0, 0, 0, 0, 0, stamp});
+    return emulator.receive(25);
+}
+
+TEST(Emulator, PingRoundTrip)
+{
+    EmulatorProcess emulator;
+
+    ASSERT_TRUE(emulator.connect());
+    std::vector<uint8_t> reply = ping(emulator, 0x5A);
+
+    ASSERT_EQ(reply.size(), 25u);
+    EXPECT_EQ(reply[0], PING_CMD);
+    EXPECT_EQ(reply[8], 0x5A);
+    EXPECT_EQ(get32(&reply[21]), uint32_t(SIM_CLOCK_HZ));
+}
+
+TEST(Emulator, SequencedCommandIsAcknowledged)
+{
+    EmulatorProcess emulator({"--fast"});
+
+    ASSERT_TRUE(emulator.connect());
+    emulator.send({SEQ_CMD, 42, 0x7E, 0, 0, 0, 0});
+    std::vector<uint8_t> ack = emulator.receive(7);
+
+    ASSERT_EQ(ack.size(), 7u);
+    EXPECT_EQ(ack[0], ACK_MSG);
+    EXPECT_EQ(ack[1], 42);
+    EXPECT_EQ(ack[2], ACK_UNKNOWN);
+}
+
+TEST(Emulator, StreamsTelemetry)
+{
+    EmulatorProcess emulator;
+
+    ASSERT_TRUE(emulator.connect());
+    emulator.send({TELEMETRY_CMD, 0, 10, TELEMETRY_ODOMETRY});
+    std::vector<uint8_t> first = emulator.receive(5, 200);
+
+    ASSERT_EQ(first.size(), 5u);
+    EXPECT_EQ(first[0], TELEMETRY_MSG);
+}
+
+// The host firmware is a benchmark build: bench_report reads these replies
+TEST(Emulator, AnswersBenchmarks)
+{
+    EmulatorProcess emulator({"--fast"});
+
+    ASSERT_TRUE(emulator.connect());
+    // One benchmark pending at a time: each awaits its reply
+    emulator.send({BENCH_CMD, BENCH_LIST, 4, 0, 100});
+    std::vector<uint8_t> list = emulator.receive(22);
+    emulator.send({BENCH_CMD, BENCH_MOTION, 0, 0, 1});
+    std::vector<uint8_t> motion = emulator.receive(22);
+
+    ASSERT_EQ(list.size(), 22u);
+    EXPECT_EQ(list[0], BENCH_CMD);
+    EXPECT_EQ(list[1], BENCH_LIST);
+    EXPECT_EQ(list[3], BENCH_OK);
+    EXPECT_EQ(list[5], 100);
+    ASSERT_EQ(motion.size(), 22u);
+    EXPECT_EQ(motion[3], BENCH_BAD_ARGUMENT);
+}
+
+TEST(Emulator, FirmwareRunsBetweenClients)
+{
+    EmulatorProcess emulator({"--fast"});
+
+    ASSERT_TRUE(emulator.connect());
+    std::vector<uint8_t> before = ping(emulator, 1);
+    emulator.disconnect();
+    ASSERT_TRUE(emulator.connect());
+    std::vector<uint8_t> after = ping(emulator, 2);
+
+    ASSERT_EQ(before.size(), 25u);
+    ASSERT_EQ(after.size(), 25u);
+    EXPECT_EQ(after[8], 2);
+    EXPECT_GT(get32(&after[9]), get32(&before[9]));
+}
+
+TEST(Emulator, StopsCleanly)
+{
+    EmulatorProcess emulator({"--fast", "--meccano", "SLS"});
+    struct stat info;
+
+    ASSERT_TRUE(emulator.connect());
+    emulator.disconnect();
+    int status = emulator.stop();
+
+    EXPECT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+    EXPECT_NE(::stat(emulator.path().c_str(), &info), 0);
+}
+
+TEST(ServoModel, ShaftFollowsAtLimitedRate)
+{
+    const uint8_t cmd[] = {SERVO_DIRECT_CMD, 0, 0x00, 0x00, 0x0B, 0xB8};
+
+    simBoardInit();
+    simServoInit(SIM_SERVO_RATE_DEFAULT);
+    EXPECT_TRUE(simServoSettled());
+    double start = simServoPosition(0);
+
+    simUsbWrite(cmd, sizeof(cmd));
+    while(PWMPulseWidthGet(PWM0_BASE, PWM_OUT_0) != 3000)
+        simRunUs(100);
+
+    // 425 counts at 7.5 counts/ms: still on its way after 20 ms
+    simRunMs(20);
+    EXPECT_FALSE(simServoSettled());
+    EXPECT_NEAR(simServoPosition(0), start + 20 * SIM_SERVO_RATE_DEFAULT,
+                2 * SIM_SERVO_RATE_DEFAULT);
+    simRunMs(50);
+    EXPECT_TRUE(simServoSettled());
+    EXPECT_EQ(simServoPosition(0), 3000.0);
+}
+
+}  // namespace
@@ -0,0 +1,141 @@
+//
+// test_meccano_protocol.cpp
+//
+// The Meccano frame encoder and reply decoder on their own, no wire.
+//
+#include <cstdint>
+
+#include <gtest/gtest.h>
+
+#include "meccano_protocol.h"
+
+namespace {
+
+class MeccanoProtocolTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        meccanoChainInit(&chain);
+    }
+
+    // One frame and its reply, as Timer4AIntHandler does
+    void exchange(uint8_t reply)
+    {
+        meccanoFrameEncode(&chain);
+        meccanoReplyDecode(&chain, reply);
+    }
+
+    struct meccano_chain chain;
+};
+
+TEST_F(MeccanoProtocolTest, CheckSumCarriesModule)
+{
+    const uint8_t discover[4] = {0xFE, 0xFE, 0xFE, 0xFE};
+    const uint8_t mixed[4] = {0x80, 0xF4, 0x04, 0xFE};
+
+    EXPECT_EQ(meccanoCheckSum(discover, 0), 0xA0);
+    EXPECT_EQ(meccanoCheckSum(discover, 3), 0xA3);
+    EXPECT_EQ(meccanoCheckSum(mixed, 2) & 0x0F, 2);
+}
+
+TEST_F(MeccanoProtocolTest, FirstFrameDiscovers)
+{
+    meccanoFrameEncode(&chain);
+
+    EXPECT_EQ(chain.frame[0], MECCANO_HEADER);
+    for(int i = 1; i <= 4; i++)
+        EXPECT_EQ(chain.frame[i], MECCANO_DISCOVER);
+    EXPECT_EQ(chain.frame[5], meccanoCheckSum(&chain.frame[1], 0));
+    EXPECT_EQ(chain.frames, 1u);
+}
+
+TEST_F(MeccanoProtocolTest, ServoIsIdentifiedThenBlue)
+{
+    exchange(MECCANO_REPLY_PRESENT);
+    EXPECT_EQ(chain.outputByte[0], MECCANO_IDENTIFY);
+
+    // Modules 1 - 3 are asked in turn before module 0 again
+    for(int i = 1; i < MECCANO_MODULE_NBR; i++)
+        exchange(MECCANO_REPLY_NONE);
+    EXPECT_EQ(chain.moduleNum, 0);
+
+    exchange(MECCANO_REPLY_SERVO);
+    EXPECT_EQ(chain.type[0], MECCANO_TYPE_SERVO);
+    EXPECT_EQ(chain.outputByte[0], MECCANO_SERVO_BLUE);
+}
+
+TEST_F(MeccanoProtocolTest, LedBytesAlternate)
+{
+    chain.pollMask = 0x01;
+    exchange(MECCANO_REPLY_PRESENT);
+    exchange(MECCANO_REPLY_LED);
+    ASSERT_EQ(chain.type[0], MECCANO_TYPE_LED);
+    EXPECT_EQ(chain.outputByte[0], 0x04);
+
+    exchange(MECCANO_REPLY_LED);
+    EXPECT_EQ(chain.outputByte[0], 0x47);
+    exchange(MECCANO_REPLY_LED);
+    EXPECT_EQ(chain.outputByte[0], 0x04);
+}
+
+TEST_F(MeccanoProtocolTest, OneShotColourReplacesPosition)
+{
+    chain.pollMask = 0x01;
+    exchange(MECCANO_REPLY_PRESENT);
+    exchange(MECCANO_REPLY_SERVO);
+    chain.outputByte[0] = 0x80;
+    chain.servoColor[0] = 0xF2;
+
+    meccanoFrameEncode(&chain);
+    EXPECT_EQ(chain.frame[1], 0xF2);
+    meccanoReplyDecode(&chain, 0x80);
+    meccanoFrameEncode(&chain);
+    EXPECT_EQ(chain.frame[1], 0x80);
+}
+
+TEST_F(MeccanoProtocolTest, TimeoutRetriesKnownModuleOnce)
+{
+    chain.pollMask = 0x03;
+    exchange(MECCANO_REPLY_PRESENT);
+    exchange(MECCANO_REPLY_NONE);
+    exchange(MECCANO_REPLY_SERVO);
+    ASSERT_EQ(chain.moduleNum, 1);
+    exchange(MECCANO_REPLY_NONE);
+    ASSERT_EQ(chain.moduleNum, 0);
+
+    chain.outputByte[0] = 0x40;
+    meccanoFrameEncode(&chain);
+    EXPECT_TRUE(meccanoReplyTimeout(&chain));
+    EXPECT_EQ(chain.moduleNum, 0);
+
+    // The set point moved meanwhile, the retry is the same frame
+    chain.outputByte[0] = 0x90;
+    meccanoFrameEncode(&chain);
+    EXPECT_EQ(chain.frame[1], 0x40);
+    EXPECT_FALSE(meccanoReplyTimeout(&chain));
+    EXPECT_EQ(chain.moduleNum, 1);
+    EXPECT_EQ(chain.timeouts[0], 2u);
+}
+
+TEST_F(MeccanoProtocolTest, KnownModuleDroppedAfterDebounce)
+{
+    chain.pollMask = 0x01;
+    exchange(MECCANO_REPLY_PRESENT);
+    exchange(MECCANO_REPLY_SERVO);
+
+    exchange(MECCANO_REPLY_NONE);
+    EXPECT_EQ(chain.type[0], MECCANO_TYPE_SERVO);
+    exchange(MECCANO_REPLY_NONE);
+    EXPECT_EQ(chain.type[0], MECCANO_TYPE_UNKNOWN);
+    EXPECT_EQ(chain.outputByte[0], MECCANO_DISCOVER);
+    EXPECT_EQ(chain.rediscoveries[0], 1u);
+}
+
+TEST_F(MeccanoProtocolTest, GarbageDuringDiscoveryIsCounted)
+{
+    exchange(0x5A);
+    EXPECT_EQ(chain.badReplies[0], 1u);
+    EXPECT_EQ(chain.type[0], MECCANO_TYPE_UNKNOWN);
+}
+
+}  // namespace
@@ -0,0 +1,166 @@
+//
+// test_meccano_wire.cpp
+//
+// Meccano.c on the simulated board talking to a chain of virtual smart
+// modules: discovery, positions, LIM read back, hot-unplug, timeouts and
+// frame throughput.
+//
+#include <cstdint>
+
+#include <gtest/gtest.h>
+
+#include "sim.h"
+#include "meccano_wire.h"
+#include "inc/hw_memmap.h"
+#include "driverlib/gpio.h"
+extern "C" {
+#include "linked_list_dbl.h"
+#include "Meccano.h"
+}
+
+namespace {
+
+class MeccanoWireTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        simBoardInit();
+        simMeccanoInit(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN);
+    }
+
+    bool typesAre(const char *types)
+    {
+        for(int i = 0; i < MECCANO_MODULE_NBR; i++)
+            if(meccanoChain[0].type[i] != uint8_t(types[i]))
+                return false;
+        return true;
+    }
+
+    // Runs until the chain is seen as given, returns the time it took
+    uint32_t runUntilTypes(const char *types, uint32_t timeoutMs = 5000)
+    {
+        uint32_t ms;
+
+        for(ms = 0; (ms < timeoutMs) && !typesAre(types); ms++)
+            simRunMs(1);
+        return ms;
+    }
+};
+
+TEST_F(MeccanoWireTest, EmptyChainTimesOut)
+{
+    simRunMs(1000);
+
+    EXPECT_TRUE(typesAre("____"));
+    EXPECT_GT(simMeccanoStats()->frames, 10u);
+    EXPECT_EQ(simMeccanoStats()->badFrames, 0u);
+    EXPECT_GT(meccanoChain[0].timeouts[0], 0u);
+    EXPECT_GT(meccanoChain[0].timeouts[3], 0u);
+}
+
+TEST_F(MeccanoWireTest, DiscoversServosAndLed)
+{
+    simMeccanoPlug(MECCANO_REPLY_SERVO);
+    simMeccanoPlug(MECCANO_REPLY_LED);
+    simMeccanoPlug(MECCANO_REPLY_SERVO);
+
+    uint32_t ms = runUntilTypes("SLS_");
+    ASSERT_LT(ms, 5000u);
+    RecordProperty("discovery_ms", int(ms));
+
+    // Identified servos are turned blue, the LED gets its first colour
+    simRunMs(500);
+    EXPECT_EQ(simMeccanoModule(0)->color, MECCANO_SERVO_BLUE);
+    EXPECT_EQ(simMeccanoModule(2)->color, MECCANO_SERVO_BLUE);
+    EXPECT_EQ(simMeccanoModule(1)->led[0], 0x04);
+    EXPECT_EQ(simMeccanoModule(1)->led[1], 0x47);
+    EXPECT_EQ(simMeccanoStats()->badFrames, 0u);
+    EXPECT_EQ(meccanoChain[0].badReplies[0], 0u);
+}
+
+TEST_F(MeccanoWireTest, ServoFollowsSetPoint)
+{
+    simMeccanoPlug(MECCANO_REPLY_SERVO);
+    ASSERT_LT(runUntilTypes("S___"), 5000u);
+
+    setMeccanoServoPosition(0, 0x40);
+    simRunMs(300);
+    EXPECT_EQ(simMeccanoModule(0)->position, 0x40);
+    EXPECT_EQ(meccanoChain[0].moduleInput[0], 0x40);
+}
+
+TEST_F(MeccanoWireTest, LimReportsHandPosition)
+{
+    simMeccanoPlug(MECCANO_REPLY_SERVO);
+    ASSERT_LT(runUntilTypes("S___"), 5000u);
+
+    setMeccanoServotoLIM(0);
+    simRunMs(300);
+    ASSERT_TRUE(simMeccanoModule(0)->lim);
+    simMeccanoModule(0)->position = 0xB0;
+    simRunMs(300);
+    EXPECT_EQ(getMeccanoServoPosition(0), 0xB0);
+}
+
+TEST_F(MeccanoWireTest, HotUnplugDropsTheRestOfTheChain)
+{
+    simMeccanoPlug(MECCANO_REPLY_SERVO);
+    simMeccanoPlug(MECCANO_REPLY_SERVO);
+    simMeccanoPlug(MECCANO_REPLY_LED);
+    ASSERT_LT(runUntilTypes("SSL_"), 5000u);
+
+    simMeccanoUnplug(1);
+    EXPECT_LT(runUntilTypes("S___"), 2000u);
+    EXPECT_EQ(meccanoChain[0].rediscoveries[1], 1u);
+    EXPECT_EQ(meccanoChain[0].rediscoveries[2], 1u);
+    EXPECT_EQ(meccanoChain[0].rediscoveries[0], 0u);
+
+    // Plugged back, found again
+    simMeccanoPlug(MECCANO_REPLY_LED);
+    EXPECT_LT(runUntilTypes("SL__"), 5000u);
+}
+
+TEST_F(MeccanoWireTest, MutedModuleIsRetriedThenSkipped)
+{
+    simMeccanoPlug(MECCANO_REPLY_SERVO);
+    simMeccanoPlug(MECCANO_REPLY_SERVO);
+    ASSERT_LT(runUntilTypes("SS__"), 5000u);
+
+    uint32_t replies = simMeccanoModule(0)->replies;
+    simMeccanoModule(1)->muted = true;
+    simRunMs(1000);
+
+    EXPECT_GT(meccanoChain[0].timeouts[1], 0u);
+    EXPECT_EQ(meccanoChain[0].type[1], MECCANO_TYPE_SERVO);
+    EXPECT_GT(simMeccanoModule(0)->replies, replies);
+    // Every miss of a known module is asked again once, both count
+    EXPECT_EQ(meccanoChain[0].timeouts[1] % 2, 0u);
+}
+
+TEST_F(MeccanoWireTest, CorruptDiscoveryReplyIsCounted)
+{
+    simMeccanoPlug(MECCANO_REPLY_SERVO);
+    simMeccanoCorrupt(0x21);    // 0xFE becomes 0xDF
+
+    simRunMs(100);
+    EXPECT_EQ(meccanoChain[0].badReplies[0], 1u);
+    EXPECT_LT(runUntilTypes("S___"), 5000u);
+}
+
+TEST_F(MeccanoWireTest, FrameThroughput)
+{
+    simMeccanoPlug(MECCANO_REPLY_SERVO);
+    simMeccanoPlug(MECCANO_REPLY_SERVO);
+    ASSERT_LT(runUntilTypes("SS__"), 5000u);
+
+    uint32_t frames = simMeccanoStats()->frames;
+    simRunMs(10000);
+    frames = simMeccanoStats()->frames - frames;
+
+    // 6 bytes of 11 bits, the reply and the 10 ms gap: about 50 ms a frame
+    RecordProperty("frames_per_s", int(frames / 10));
+    EXPECT_GT(frames / 10, 15u);
+    EXPECT_LT(frames / 10, 40u);
+}
+
+}  // namespace
@@ -0,0 +1,58 @@
+//
+// test_motion_golden.cpp
+//
+// Golden traces of the keyframe interpolation: each recorded session of
+// test/motion is replayed and the servo PWM widths are compared with its
+// checked-in trace.  After a change of the motion engine that is meant
+// to move the outputs, record the traces again with
+//
+//     motion_trace test/motion/<name>.session -o test/motion/<name>.trace
+//
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "motion_replay.h"
+
+namespace {
+
+std::string path(const std::string &name, const char *extension)
+{
+    return std::string(MOTION_DIR) + "/" + name + extension;
+}
+
+class MotionGolden : public ::testing::TestWithParam<const char *> {
+};
+
+TEST_P(MotionGolden, MatchesTrace)
+{
+    motion::Session session = motion::loadSession(path(GetParam(), ".session"));
+    motion::Trace golden = motion::loadTrace(path(GetParam(), ".trace"));
+    motion::Trace trace = motion::replay(session);
+
+    EXPECT_EQ(motion::compare(golden, trace, session.end, session.tolerance), "");
+}
+
+INSTANTIATE_TEST_SUITE_P(Sessions, MotionGolden,
+                         ::testing::Values("arm_sweep", "both_arms", "split_charge"));
+
+TEST(MotionTrace, CompareHonoursTolerance)
+{
+    motion::Trace a = {{0, 2, 2575}, {10, 2, 2600}};
+    motion::Trace b = {{0, 2, 2575}, {10, 2, 2602}};
+
+    EXPECT_EQ(motion::compare(a, b, 20, 2), "");
+    EXPECT_EQ(motion::compare(a, b, 20, 1), "tick 10, output 2: width 2602, expected 2600");
+    EXPECT_NE(motion::compare(a, {{0, 2, 2575}, {11, 2, 2600}}, 20, 0), "");
+}
+
+TEST(MotionTrace, SplitTransferIsStoredWhole)
+{
+    motion::Session session = motion::loadSession(path("split_charge", ".session"));
+
+    ASSERT_GE(session.transfers.size(), 2u);
+    EXPECT_EQ(session.transfers[0].data.size() + session.transfers[1].data.size(),
+              2u + 3 * 13);
+}
+
+}  // namespace
@@ -0,0 +1,88 @@
+//
+// test_ping_probe.cpp
+//
+// Percentiles and histogram of the latency probe, and the probe against
+// usb_emulator, alone and behind servo traffic.
+//
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "emulator_process.h"
+#include "ping_probe.h"
+
+namespace {
+
+TEST(PingProbe, NearestRankPercentiles)
+{
+    std::vector<double> samples;
+
+    for(int i = 1000; i >= 1; i--)
+        samples.push_back(i);
+    latency::Summary summary = latency::summarize(samples);
+
+    EXPECT_EQ(summary.count, 1000u);
+    EXPECT_EQ(summary.min, 1.0);
+    EXPECT_EQ(summary.p50, 500.0);
+    EXPECT_EQ(summary.p99, 990.0);
+    EXPECT_EQ(summary.p999, 999.0);
+    EXPECT_EQ(summary.max, 1000.0);
+    EXPECT_EQ(latency::summarize({}).count, 0u);
+}
+
+TEST(PingProbe, PowerOfTwoHistogram)
+{
+    std::vector<uint32_t> bins = latency::histogram({0.5, 1.9, 2.0, 3.9, 100.0, 127.0, 128.0});
+
+    ASSERT_EQ(bins.size(), 8u);
+    EXPECT_EQ(bins[0], 2u);                     // under 2 us
+    EXPECT_EQ(bins[1], 2u);                     // 2 - 3
+    EXPECT_EQ(bins[6], 2u);                     // 64 - 127
+    EXPECT_EQ(bins[7], 1u);                     // 128 - 255
+}
+
+class PingProbeTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        ASSERT_TRUE(emulator_.connect());
+        emulator_.disconnect();
+        transport_ = std::make_unique<bulk::SocketTransport>(emulator_.path());
+    }
+
+    EmulatorProcess emulator_{{"--fast"}};
+    std::unique_ptr<bulk::SocketTransport> transport_;
+};
+
+TEST_F(PingProbeTest, EveryPingIsTimed)
+{
+    bulk::Client client(*transport_);
+    latency::Config config;
+
+    config.count = 50;
+    config.rate = 200.0;
+    latency::Result result = latency::run(client, config);
+
+    EXPECT_EQ(result.sent, 50u);
+    EXPECT_EQ(result.lost(), 0u);
+    ASSERT_EQ(result.device.size(), 50u);
+    EXPECT_GT(latency::summarize(result.roundTrip).min, 0.0);
+}
+
+TEST_F(PingProbeTest, BehindServoTraffic)
+{
+    bulk::Client client(*transport_);
+    latency::Config config;
+
+    config.count = 40;
+    config.rate = 0.0;
+    config.traffic = 8;
+    latency::Result result = latency::run(client, config);
+
+    EXPECT_EQ(result.lost(), 0u);
+    EXPECT_EQ(client.stats().commands, 40u * 9u);
+    EXPECT_EQ(client.stats().failed, 0u);
+}
+
+}  // namespace
@@ -0,0 +1,128 @@
+//
+// test_profile_report.cpp
+//
+// PROFILE_CMD replies decoded and printed, from bytes laid out as the
+// firmware sends them and from usb_emulator.
+//
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "emulator_process.h"
+#include "client.h"
+#include "profile_report.h"
+#include "protocol.h"
+#include "profile.h"
+
+namespace {
+
+bulk::Message handlerReply(uint8_t id, uint32_t count, uint32_t min, uint32_t max,
+                           uint32_t total, size_t bin)
+{
+    bulk::Message message{PROFILE_CMD, {PROFILE_CMD, id}};
+    auto put32 = [&](uint32_t v) {
+        for(int shift = 24; shift >= 0; shift -= 8)
+            message.data.push_back(uint8_t(v >> shift));
+    };
+
+    put32(count);
+    put32(min);
+    put32(max);
+    put32(0);
+    put32(total);
+    for(size_t i = 0; i < PROFILE_HIST_BINS; i++)
+    {
+        message.data.push_back(0);
+        message.data.push_back((i == bin) ? uint8_t(count) : 0);
+    }
+    return message;
+}
+
+TEST(ProfileReport, DecodesTheReplies)
+{
+    profile::Handler handler;
+    profile::Load load;
+    bulk::Message loadReply{PROFILE_CMD, {PROFILE_CMD, 0xFF, 0, 125, 0x01, 0x2C,
+                                          0x07, 0x27, 0x0E, 0x00, PROFILE_ISR_NBR}};
+
+    ASSERT_TRUE(profile::decodeHandler(handlerReply(PROFILE_USB0, 10, 200, 900, 4000, 5),
+                                       handler));
+    EXPECT_EQ(handler.id, PROFILE_USB0);
+    EXPECT_EQ(handler.count, 10u);
+    EXPECT_EQ(handler.max, 900u);
+    EXPECT_EQ(handler.total, 4000u);
+    EXPECT_EQ(handler.hist[5], 10u);
+    EXPECT_FALSE(profile::decodeLoad(handlerReply(0, 1, 1, 1, 1, 0), load));
+
+    ASSERT_TRUE(profile::decodeLoad(loadReply, load));
+    EXPECT_EQ(load.load, 125u);
+    EXPECT_EQ(load.peak, 300u);
+    EXPECT_EQ(load.sysClock, 120000000u);
+    EXPECT_FALSE(profile::decodeHandler(loadReply, handler));
+}
+
+TEST(ProfileReport, BinsCoverTheCycles)
+{
+    uint32_t low, high;
+
+    profile::binRange(0, low, high);
+    EXPECT_EQ(low, 0u);
+    EXPECT_EQ(high, 31u);
+    profile::binRange(5, low, high);
+    EXPECT_EQ(low, 512u);
+    EXPECT_EQ(high, 1023u);
+    profile::binRange(PROFILE_HIST_BINS - 1, low, high);
+    EXPECT_EQ(high, 0xFFFFFFFFu);
+}
+
+TEST(ProfileReport, WorstCaseFirst)
+{
+    profile::Handler timer0, usb, adc;
+    profile::Load load;
+
+    profile::decodeHandler(handlerReply(PROFILE_TIMER0, 1000, 100, 240, 150000, 3), timer0);
+    profile::decodeHandler(handlerReply(PROFILE_USB0, 10, 200, 1200, 4000, 6), usb);
+    profile::decodeHandler(handlerReply(PROFILE_ADC0, 0, 0, 0, 0, 0), adc);
+    load.load = 125;
+    load.sysClock = 120000000;
+
+    std::string text = profile::format(load, {timer0, usb, adc}, true);
+
+    EXPECT_NE(text.find("interrupt load 12.5 %"), std::string::npos);
+    EXPECT_LT(text.find("USB0"), text.find("TIMER0"));
+    EXPECT_EQ(text.find("ADC0"), std::string::npos);
+    EXPECT_NE(text.find("10.00"), std::string::npos);        // 1200 cycles in us
+    EXPECT_NE(text.find("1024 - 2047"), std::string::npos);
+}
+
+TEST(ProfileReport, ReadFromTheEmulator)
+{
+    EmulatorProcess emulator({"--fast"});
+
+    ASSERT_TRUE(emulator.connect());
+    emulator.disconnect();
+
+    bulk::SocketTransport transport(emulator.path());
+    bulk::Client client(transport);
+    std::vector<profile::Handler> handlers;
+
+    client.onMessage([&](const bulk::Message &message) {
+        profile::Handler handler;
+
+        if(profile::decodeHandler(message, handler))
+            handlers.push_back(handler);
+    });
+    client.send(bulk::cmd::profile(PROFILE_TIMER0, false));
+    auto end = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while(handlers.empty() && (std::chrono::steady_clock::now() < end))
+        client.poll(1);
+
+    ASSERT_EQ(handlers.size(), 1u);
+    EXPECT_EQ(handlers[0].id, PROFILE_TIMER0);
+    EXPECT_GT(handlers[0].count, 0u);           // the millisecond tick ran
+}
+
+}  // namespace
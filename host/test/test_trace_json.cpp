@@ -0,0 +1,130 @@
+//
+// test_trace_json.cpp
+//
+// TRACE_MSG packets to Chrome trace JSON: slices, instants and counters
+// from packets laid out as the firmware sends them, the cycle counter
+// unwrapped, and a trace drained from usb_emulator.
+//
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "emulator_process.h"
+#include "client.h"
+#include "trace_json.h"
+#include "protocol.h"
+#include "trace.h"
+
+namespace {
+
+struct Raw {
+    uint8_t id;
+    uint8_t arg8;
+    uint16_t arg16;
+    uint32_t cycles;
+};
+
+bulk::Message packet(uint16_t lost, const std::vector<Raw> &events)
+{
+    bulk::Message message{TRACE_MSG, {TRACE_MSG, uint8_t(events.size()),
+                                      uint8_t(lost >> 8), uint8_t(lost)}};
+
+    for(const Raw &e : events)
+    {
+        message.data.insert(message.data.end(),
+                            {e.id, e.arg8, uint8_t(e.arg16 >> 8), uint8_t(e.arg16),
+                             uint8_t(e.cycles >> 24), uint8_t(e.cycles >> 16),
+                             uint8_t(e.cycles >> 8), uint8_t(e.cycles)});
+    }
+    return message;
+}
+
+TEST(TraceJson, NamesTheActuators)
+{
+    EXPECT_EQ(trace::actuatorName(TRACE_LEFT_ARM | 2), "left arm 2");
+    EXPECT_EQ(trace::actuatorName(TRACE_DC_MOTOR | 1), "dc motor 1");
+    EXPECT_EQ(trace::actuatorName(0x90), "actuator 0x90");
+}
+
+TEST(TraceJson, UnwrapsTheCycleCounter)
+{
+    trace::Converter converter(120000000);
+
+    ASSERT_TRUE(converter.push(packet(2, {{TRACE_COMMAND, SERVO_DIRECT_CMD, 12, 0xFFFFFE00},
+                                          {TRACE_KEYFRAME_START, TRACE_LEFT_ARM | 2, 3000,
+                                           0xFFFFFF00}})));
+    ASSERT_TRUE(converter.push(packet(1, {{TRACE_KEYFRAME_RETIRE, TRACE_LEFT_ARM | 2, 3000,
+                                           0x00000100}})));
+    EXPECT_FALSE(converter.push({PING_CMD, {PING_CMD}}));
+
+    ASSERT_EQ(converter.events().size(), 3u);
+    EXPECT_EQ(converter.events()[2].cycles, 0x100000100ull);
+    EXPECT_EQ(converter.lost(), 3u);
+
+    // 0x200 cycles at 120 MHz
+    std::string json = converter.json();
+    EXPECT_NE(json.find("\"ph\": \"X\", \"pid\": 1, \"tid\": 258, \"name\": \"keyframe\""),
+              std::string::npos);
+    EXPECT_NE(json.find("\"dur\": 4.267"), std::string::npos);
+    EXPECT_NE(json.find("\"name\": \"left arm 2\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\": \"command 0x10\""), std::string::npos);   // SERVO_DIRECT_CMD
+    EXPECT_NE(json.find("\"lost\": 3"), std::string::npos);
+}
+
+TEST(TraceJson, MeccanoFramesAndCounters)
+{
+    trace::Converter converter(120000000);
+
+    converter.push(packet(0, {{TRACE_MECCANO_FRAME, 1, 7, 1200},
+                              {TRACE_MECCANO_TIMEOUT, 1, 1, 2400},
+                              {TRACE_MECCANO_FRAME, 1, 8, 3600},
+                              {TRACE_PWM_COMMIT, TRACE_SERVO_OUTPUT | 3, 2500, 4800},
+                              {TRACE_QUEUE_DEPTH, TRACE_RIGHT_ARM, 4, 6000}}));
+    std::string json = converter.json();
+
+    EXPECT_NE(json.find("\"name\": \"frame 7\", \"ts\": 10.000, \"dur\": 10.000, "
+                        "\"args\": {\"module\": 1, \"timeout\": true, \"retried\": 1}"),
+              std::string::npos);
+    // Never answered: open up to the end of the trace
+    EXPECT_NE(json.find("\"name\": \"frame 8\", \"ts\": 30.000, \"dur\": 20.000"),
+              std::string::npos);
+    EXPECT_NE(json.find("\"ph\": \"C\", \"pid\": 1, \"name\": \"pwm servo output 3\", "
+                        "\"ts\": 40.000, \"args\": {\"value\": 2500}"),
+              std::string::npos);
+    EXPECT_NE(json.find("\"name\": \"queue right arm 0\""), std::string::npos);
+}
+
+TEST(TraceJson, DrainedFromTheEmulator)
+{
+    EmulatorProcess emulator({"--fast"});
+
+    ASSERT_TRUE(emulator.connect());
+    emulator.disconnect();
+
+    bulk::SocketTransport transport(emulator.path());
+    bulk::Client client(transport);
+    trace::Converter converter(120000000);
+
+    client.onMessage([&](const bulk::Message &message) { converter.push(message); });
+    client.send(bulk::cmd::trace(TRACE_CAT_COMMAND | TRACE_CAT_KEYFRAME));
+    client.send(bulk::cmd::servoChargeMovement({{0, 0, 20, 3000}}));
+    client.send(bulk::cmd::servoStartMovement(0x03));           // both arms
+
+    auto end = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    auto retired = [&] {
+        for(const trace::Event &e : converter.events())
+            if(e.id == TRACE_KEYFRAME_RETIRE)
+                return true;
+        return false;
+    };
+    while(!retired() && (std::chrono::steady_clock::now() < end))
+        client.poll(1);
+
+    ASSERT_TRUE(retired());
+    EXPECT_EQ(converter.events().front().id, TRACE_COMMAND);
+    EXPECT_NE(converter.json().find("\"name\": \"keyframe\""), std::string::npos);
+}
+
+}  // namespace
@@ -0,0 +1,231 @@
+//
+// bench_report.cpp
+//
+// Runs the on-target benchmarks of bench.c through BENCH_CMD and prints
+// their results as Google Benchmark JSON, so that the runs of the board
+// are tracked and compared like those of host_benchmarks.  The firmware
+// has to be built with BENCHMARK defined.
+//
+//     bench_report --socket <path> [--iterations 1000] [-o bench.json]
+//     bench_report --usb [--iterations 1000] [-o bench.json]
+//
+// Times are the mean cycles of an iteration at the clock of the board;
+// min_cycles, max_cycles and mean_cycles are given as counters.
+//
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "client.h"
+#ifdef HAVE_LIBUSB
+#include "libusb_transport.h"
+#endif
+
+#include "protocol.h"
+#include "bench.h"
+#include "meccano_protocol.h"
+
+namespace {
+
+struct Case {
+    uint8_t bench;
+    uint8_t param;
+    const char *name;
+    const char *argName;                // nullptr: no argument
+};
+
+const Case kCases[] = {
+    {BENCH_DECODE, 1, "BENCH_DECODE", "commands"},
+    {BENCH_DECODE, 4, "BENCH_DECODE", "commands"},
+    {BENCH_DECODE, BENCH_DECODE_MAX, "BENCH_DECODE", "commands"},
+    {BENCH_LIST, 0, "BENCH_LIST", "queued"},
+    {BENCH_LIST, 4, "BENCH_LIST", "queued"},
+    {BENCH_LIST, BENCH_QUEUE_MAX, "BENCH_LIST", "queued"},
+    {BENCH_MOTION, 8, "BENCH_MOTION", "channels"},
+    {BENCH_MOTION, 32, "BENCH_MOTION", "channels"},
+    {BENCH_MOTION, BENCH_CHANNELS_MAX, "BENCH_MOTION", "channels"},
+    {BENCH_MECCANO_ENCODE, 0, "BENCH_MECCANO_ENCODE", nullptr},
+    {BENCH_MECCANO_DECODE, MECCANO_REPLY_NONE, "BENCH_MECCANO_DECODE", "reply"},
+    {BENCH_MECCANO_DECODE, MECCANO_REPLY_SERVO, "BENCH_MECCANO_DECODE", "reply"},
+    {BENCH_MECCANO_DECODE, MECCANO_REPLY_PRESENT, "BENCH_MECCANO_DECODE", "reply"},
+};
+
+int usage()
+{
+    std::fprintf(stderr,
+        "usage: bench_report (--socket path"
+#ifdef HAVE_LIBUSB
+        " | --usb"
+#endif
+        ") [--iterations n] [-o file]\n");
+    return 2;
+}
+
+// Polls until a message of that opcode comes, at most timeoutMs
+bool await(bulk::Client &client, uint8_t opcode, bulk::Message &reply, int timeoutMs)
+{
+    bool got = false;
+    auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+
+    client.onMessage([&](const bulk::Message &message) {
+        if(message.opcode == opcode)
+        {
+            reply = message;
+            got = true;
+        }
+    });
+    while(!got && (std::chrono::steady_clock::now() < end))
+    {
+        if(!client.poll(1))
+            break;
+    }
+    client.onMessage(nullptr);
+    return got;
+}
+
+}  // namespace
+
+
+int main(int argc, char **argv)
+{
+    const char *path = nullptr;
+    const char *output = nullptr;
+    bool usb = false;
+    uint32_t iterations = 1000;
+
+    for(int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        bool more = (i + 1 < argc);
+
+        if(std::strcmp(arg, "--usb") == 0)
+            usb = true;
+        else if(!more)
+            return usage();
+        else if(std::strcmp(arg, "--socket") == 0)
+            path = argv[++i];
+        else if(std::strcmp(arg, "--iterations") == 0)
+            iterations = uint32_t(std::atoi(argv[++i]));
+        else if(std::strcmp(arg, "-o") == 0)
+            output = argv[++i];
+        else
+            return usage();
+    }
+    if((usb == (path != nullptr)) || (iterations == 0) || (iterations > 0xFFFF))
+        return usage();
+
+    std::unique_ptr<bulk::Transport> transport;
+    try
+    {
+#ifdef HAVE_LIBUSB
+        if(usb)
+            transport = std::make_unique<bulk::LibusbTransport>();
+        else
+#endif
+        if(path != nullptr)
+            transport = std::make_unique<bulk::SocketTransport>(path);
+        else
+            return usage();
+    }
+    catch(const std::exception &error)
+    {
+        std::fprintf(stderr, "bench_report: %s\n", error.what());
+        return 1;
+    }
+
+    bulk::Client client(*transport);
+    bulk::Message reply;
+    bulk::Ping ping;
+
+    // The clock of the board turns the cycles into time
+    client.send(bulk::cmd::ping(0));
+    if(!await(client, PING_CMD, reply, 1000) || !bulk::decodePing(reply, ping) ||
+       (ping.sysClock == 0))
+    {
+        std::fprintf(stderr, "bench_report: no answer to PING_CMD\n");
+        return 1;
+    }
+
+    FILE *out = (output != nullptr) ? std::fopen(output, "w") : stdout;
+    if(out == nullptr)
+    {
+        std::fprintf(stderr, "bench_report: %s: cannot write\n", output);
+        return 1;
+    }
+
+    char date[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+    std::fprintf(out,
+        "{\n"
+        "  \"context\": {\n"
+        "    \"date\": \"%s\",\n"
+        "    \"executable\": \"bench_report\",\n"
+        "    \"num_cpus\": 1,\n"
+        "    \"mhz_per_cpu\": %u,\n"
+        "    \"library_build_type\": \"target\"\n"
+        "  },\n"
+        "  \"benchmarks\": [",
+        date, ping.sysClock / 1000000);
+
+    double nsPerCycle = 1e9 / ping.sysClock;
+    int failed = 0;
+    bool first = true;
+
+    for(const Case &c : kCases)
+    {
+        std::string name = c.name;
+
+        if(c.argName != nullptr)
+            name += std::string("/") + c.argName + ":" + std::to_string(c.param);
+
+        client.send(bulk::cmd::bench(c.bench, c.param, uint16_t(iterations)));
+        if(!await(client, BENCH_CMD, reply, 10000) || (reply.data.size() < 22))
+        {
+            std::fprintf(stderr, "bench_report: %s: no reply\n", name.c_str());
+            failed++;
+            continue;
+        }
+
+        const uint8_t *p = reply.data.data();
+        uint8_t status = p[3];
+        uint32_t count = bulk::get16(&p[4]);
+        uint32_t min = bulk::get32(&p[6]);
+        uint32_t max = bulk::get32(&p[10]);
+        uint64_t total = bulk::get64(&p[14]);
+        double mean = (count != 0) ? double(total) / count : 0.0;
+
+        std::fprintf(out, "%s\n    {\n"
+                     "      \"name\": \"%s\",\n"
+                     "      \"run_name\": \"%s\",\n"
+                     "      \"run_type\": \"iteration\",\n",
+                     first ? "" : ",", name.c_str(), name.c_str());
+        first = false;
+        if(status != BENCH_OK)
+        {
+            std::fprintf(out, "      \"error_occurred\": true,\n"
+                         "      \"error_message\": \"%s\"\n    }",
+                         (status == BENCH_NO_MEMORY) ? "no memory" : "bad argument");
+            failed++;
+            continue;
+        }
+        std::fprintf(out, "      \"iterations\": %u,\n"
+                     "      \"real_time\": %.3f,\n"
+                     "      \"cpu_time\": %.3f,\n"
+                     "      \"time_unit\": \"ns\",\n"
+                     "      \"min_cycles\": %u,\n"
+                     "      \"max_cycles\": %u,\n"
+                     "      \"mean_cycles\": %.1f\n    }",
+                     count, mean * nsPerCycle, mean * nsPerCycle, min, max, mean);
+    }
+    std::fprintf(out, "\n  ]\n}\n");
+    if(out != stdout)
+        std::fclose(out);
+    return (failed == 0) ? 0 : 1;
+}
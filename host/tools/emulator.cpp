@@ -0,0 +1,254 @@
+//
+// emulator.cpp
+//
+// The firmware on the simulated board, served on a Unix socket: the bytes
+// a client writes are the bulk OUT transfers of RxHandler, the bytes it
+// reads are what the firmware sends on the bulk IN endpoint, replies and
+// telemetry alike.  Both move through the simulated USB frames, so the
+// latencies and the throughput a client measures are those of the link.
+//
+//     usb_emulator --socket <path> [--fast] [--meccano SLS]
+//                  [--servo-rate 7.5] [--quiet]
+//
+// In real time (default) the simulation follows the wall clock; --fast
+// runs it as fast as the host can.  --meccano plugs smart modules on the
+// chain in order, S for a servo and L for a LED.  One client at a time,
+// the firmware keeps running between clients.  SIGINT or SIGTERM stops
+// it and prints what was simulated.
+//
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "sim.h"
+#include "dc_plant.h"
+#include "meccano_wire.h"
+#include "servo_model.h"
+#include "inc/hw_memmap.h"
+#include "driverlib/gpio.h"
+#include "meccano_protocol.h"
+extern "C" {
+#include "linked_list_dbl.h"
+#include "Meccano.h"
+#include "timer_handler.h"
+}
+
+namespace {
+
+volatile std::sig_atomic_t stopRequest = 0;
+
+void onStop(int)
+{
+    stopRequest = 1;
+}
+
+int usage()
+{
+    std::fprintf(stderr,
+        "usage: usb_emulator --socket path [--fast] [--meccano SLS]\n"
+        "                    [--servo-rate counts/ms] [--quiet]\n");
+    return 2;
+}
+
+int listenOn(const char *path)
+{
+    sockaddr_un address = {};
+    int fd;
+
+    if(std::strlen(path) >= sizeof(address.sun_path))
+    {
+        std::fprintf(stderr, "usb_emulator: socket path too long\n");
+        return -1;
+    }
+    address.sun_family = AF_UNIX;
+    std::strcpy(address.sun_path, path);
+    ::unlink(path);
+
+    fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if((fd < 0) ||
+       (::bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) ||
+       (::listen(fd, 1) != 0))
+    {
+        std::fprintf(stderr, "usb_emulator: %s: %s\n", path, std::strerror(errno));
+        if(fd >= 0)
+            ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Everything the firmware sent, to the client if there is one
+bool drainDevice(int client, uint64_t &sent)
+{
+    uint8_t buffer[SIM_USB_PACKET * SIM_USB_PACKETS];
+    uint32_t size;
+
+    while((size = simUsbRead(buffer, sizeof(buffer))) != 0)
+    {
+        for(uint32_t done = 0; (client >= 0) && (done < size); )
+        {
+            ssize_t n = ::send(client, &buffer[done], size - done, MSG_NOSIGNAL);
+
+            if(n < 0)
+            {
+                if(errno == EINTR)
+                    continue;
+                return false;
+            }
+            done += uint32_t(n);
+        }
+        if(client >= 0)
+            sent += size;
+    }
+    return true;
+}
+
+}  // namespace
+
+
+int main(int argc, char **argv)
+{
+    const char *path = nullptr;
+    const char *modules = "";
+    double servoRate = SIM_SERVO_RATE_DEFAULT;
+    bool fast = false;
+    bool quiet = false;
+
+    for(int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        bool more = (i + 1 < argc);
+
+        if(std::strcmp(arg, "--fast") == 0)
+            fast = true;
+        else if(std::strcmp(arg, "--quiet") == 0)
+            quiet = true;
+        else if(!more)
+            return usage();
+        else if(std::strcmp(arg, "--socket") == 0)
+            path = argv[++i];
+        else if(std::strcmp(arg, "--meccano") == 0)
+            modules = argv[++i];
+        else if(std::strcmp(arg, "--servo-rate") == 0)
+            servoRate = std::atof(argv[++i]);
+        else
+            return usage();
+    }
+    if((path == nullptr) || (servoRate <= 0.0) ||
+       (std::strlen(modules) > MECCANO_MODULE_NBR) ||
+       (std::strspn(modules, "SL") != std::strlen(modules)))
+        return usage();
+
+    simBoardInit();
+    simPlantInit();
+    simServoInit(servoRate);
+    simMeccanoInit(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN);
+    for(const char *m = modules; *m != '\0'; m++)
+        simMeccanoPlug((*m == 'S') ? MECCANO_REPLY_SERVO : MECCANO_REPLY_LED);
+
+    int server = listenOn(path);
+    if(server < 0)
+        return 1;
+
+    std::signal(SIGINT, onStop);
+    std::signal(SIGTERM, onStop);
+    std::signal(SIGPIPE, SIG_IGN);
+    if(!quiet)
+    {
+        std::printf("usb_emulator: listening on %s\n", path);
+        std::fflush(stdout);
+    }
+
+    int client = -1;
+    uint64_t received = 0, sent = 0;
+    uint32_t clients = 0;
+    uint32_t startMs = milli_second;
+    auto start = std::chrono::steady_clock::now();
+
+    while(!stopRequest)
+    {
+        // One host on the bus: the next client waits in the backlog
+        pollfd fd = {(client >= 0) ? client : server, POLLIN, 0};
+        int timeout = fast ? 0 : 1;
+
+        if(::poll(&fd, 1, timeout) < 0)
+        {
+            if(errno == EINTR)
+                continue;
+            break;
+        }
+
+        if((client < 0) && (fd.revents & POLLIN))
+        {
+            client = ::accept(server, nullptr, nullptr);
+            if(client >= 0)
+                clients++;
+        }
+        else if((client >= 0) && (fd.revents & (POLLIN | POLLHUP | POLLERR)))
+        {
+            uint8_t buffer[4096];
+            ssize_t n = ::recv(client, buffer, sizeof(buffer), 0);
+
+            if(n > 0)
+            {
+                simUsbWrite(buffer, uint32_t(n));
+                received += uint64_t(n);
+            }
+            else if((n == 0) || (errno != EINTR))
+            {
+                ::close(client);
+                client = -1;
+            }
+        }
+
+        //
+        // The simulation catches up with the wall clock, or steps one
+        // frame when it runs free.
+        //
+        if(fast)
+            simRunMs(1);
+        else
+        {
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            uint32_t wallMs = uint32_t(
+                std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+
+            if(wallMs > milli_second - startMs)
+                simRunMs(wallMs - (milli_second - startMs));
+        }
+        if(!drainDevice(client, sent))
+        {
+            ::close(client);
+            client = -1;
+        }
+    }
+
+    if(client >= 0)
+        ::close(client);
+    ::close(server);
+    ::unlink(path);
+
+    if(!quiet)
+    {
+        const sim_meccano_stats *meccano = simMeccanoStats();
+
+        std::printf("usb_emulator: %u ms simulated, %u clients, %llu bytes in, %llu bytes out\n",
+                    milli_second - startMs, clients,
+                    (unsigned long long)received, (unsigned long long)sent);
+        std::printf("usb_emulator: Meccano %u frames, %u bad, %u replies\n",
+                    meccano->frames, meccano->badFrames, meccano->replies);
+        std::printf("usb_emulator: servo shafts");
+        for(uint32_t i = 0; i < SIM_SERVO_NBR; i++)
+            std::printf(" %.0f", simServoPosition(i));
+        std::printf("%s\n", simServoSettled() ? "" : " (moving)");
+    }
+    return 0;
+}
@@ -0,0 +1,254 @@
+//
+// motion_replay.cpp
+//
+// Session replay on the simulated board, see motion_replay.h.
+//
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "motion_replay.h"
+
+#include "sim.h"
+#include "driverlib/pwm.h"
+#include "inc/hw_memmap.h"
+extern "C" {
+#include "timer_handler.h"
+}
+
+namespace motion {
+
+namespace {
+
+constexpr uint32_t kStepUs = 100;   // finer than the tick, coarser than the loop
+
+const uint32_t kPwmOut[kOutputs] = {
+    PWM_OUT_0, PWM_OUT_1, PWM_OUT_2, PWM_OUT_3,
+    PWM_OUT_4, PWM_OUT_5, PWM_OUT_6, PWM_OUT_7
+};
+
+[[noreturn]] void fail(const std::string &path, int line, const std::string &what)
+{
+    std::ostringstream message;
+
+    message << path << ":" << line << ": " << what;
+    throw std::runtime_error(message.str());
+}
+
+std::vector<uint8_t> parseHex(const std::string &path, int line,
+                              std::istringstream &words)
+{
+    std::vector<uint8_t> data;
+    std::string word;
+
+    // Bytes may be grouped, "13 02" or "1302"
+    while(words >> word)
+    {
+        if(word.size() % 2 != 0)
+            fail(path, line, "odd number of hex digits in " + word);
+        for(size_t i = 0; i < word.size(); i += 2)
+        {
+            char *end;
+            std::string byte = word.substr(i, 2);
+            unsigned long value = std::strtoul(byte.c_str(), &end, 16);
+
+            if(*end != '\0')
+                fail(path, line, "not a hex byte: " + byte);
+            data.push_back(uint8_t(value));
+        }
+    }
+    return data;
+}
+
+std::ifstream open(const std::string &path)
+{
+    std::ifstream file(path);
+
+    if(!file)
+        throw std::runtime_error(path + ": cannot open");
+    return file;
+}
+
+// Width of every output at every tick up to the end
+std::vector<uint32_t> expand(const Trace &trace, uint32_t end)
+{
+    std::vector<uint32_t> widths((end + 1) * kOutputs, 0);
+    size_t next = 0;
+    uint32_t now[kOutputs] = {0};
+
+    for(uint32_t ms = 0; ms <= end; ms++)
+    {
+        for(; (next < trace.size()) && (trace[next].ms <= ms); next++)
+            now[trace[next].output] = trace[next].width;
+        for(int output = 0; output < kOutputs; output++)
+            widths[ms * kOutputs + output] = now[output];
+    }
+    return widths;
+}
+
+}  // namespace
+
+
+Session loadSession(const std::string &path)
+{
+    std::ifstream file = open(path);
+    Session session;
+    std::string text;
+    bool ended = false;
+
+    for(int line = 1; std::getline(file, text); line++)
+    {
+        std::istringstream words(text.substr(0, text.find('#')));
+        std::string first;
+        Transfer transfer;
+
+        if(!(words >> first))
+            continue;
+        if(ended)
+            fail(path, line, "transfer after the end");
+        if((text[0] == ' ') || (text[0] == '\t'))
+        {
+            // Continues the transfer above
+            std::istringstream rest(text.substr(0, text.find('#')));
+            std::vector<uint8_t> data;
+
+            if(session.transfers.empty())
+                fail(path, line, "continuation without a transfer");
+            data = parseHex(path, line, rest);
+            session.transfers.back().data.insert(session.transfers.back().data.end(),
+                                                 data.begin(), data.end());
+            continue;
+        }
+        if(first == "tolerance")
+        {
+            if(!(words >> session.tolerance))
+                fail(path, line, "tolerance without a value");
+            continue;
+        }
+        transfer.ms = std::strtoul(first.c_str(), nullptr, 10);
+        if(!session.transfers.empty() && (transfer.ms < session.transfers.back().ms))
+            fail(path, line, "transfers out of order");
+        std::streampos data = words.tellg();
+        std::string word;
+        if((words >> word) && (word == "end"))
+        {
+            session.end = transfer.ms;
+            ended = true;
+            continue;
+        }
+        words.clear();
+        words.seekg(data);
+        transfer.data = parseHex(path, line, words);
+        if(transfer.data.empty())
+            fail(path, line, "transfer without data");
+        session.transfers.push_back(transfer);
+    }
+    if(!ended)
+        throw std::runtime_error(path + ": no end");
+    return session;
+}
+
+
+Trace loadTrace(const std::string &path)
+{
+    std::ifstream file = open(path);
+    Trace trace;
+    std::string text;
+
+    for(int line = 1; std::getline(file, text); line++)
+    {
+        std::istringstream words(text.substr(0, text.find('#')));
+        Change change;
+
+        if(!(words >> change.ms))
+            continue;
+        if(!(words >> change.output >> change.width) || (change.output >= kOutputs))
+            fail(path, line, "expected <ms> <output> <width>");
+        trace.push_back(change);
+    }
+    return trace;
+}
+
+
+void saveTrace(const std::string &path, const Trace &trace)
+{
+    std::ofstream file(path);
+
+    if(!file)
+        throw std::runtime_error(path + ": cannot write");
+    file << "# ms output width\n";
+    for(const Change &change : trace)
+        file << change.ms << " " << change.output << " " << change.width << "\n";
+}
+
+
+Trace replay(const Session &session)
+{
+    Trace trace;
+    uint32_t width[kOutputs];
+    uint32_t traced;
+    size_t next = 0;
+    uint8_t discard[256];
+
+    simBoardInit();
+    traced = milli_second;
+    for(int output = 0; output < kOutputs; output++)
+    {
+        width[output] = PWMPulseWidthGet(PWM0_BASE, kPwmOut[output]);
+        trace.push_back({0, uint32_t(output), width[output]});
+    }
+
+    while(milli_second - traced < session.end)
+    {
+        for(; (next < session.transfers.size()) &&
+              (session.transfers[next].ms <= milli_second - traced); next++)
+            simUsbWrite(session.transfers[next].data.data(),
+                        session.transfers[next].data.size());
+
+        simRunUs(kStepUs);
+        while(simUsbRead(discard, sizeof(discard)) != 0)
+            ;
+
+        for(int output = 0; output < kOutputs; output++)
+        {
+            uint32_t now = PWMPulseWidthGet(PWM0_BASE, kPwmOut[output]);
+
+            if(now != width[output])
+            {
+                width[output] = now;
+                trace.push_back({milli_second - traced, uint32_t(output), now});
+            }
+        }
+    }
+    return trace;
+}
+
+
+std::string compare(const Trace &expected, const Trace &actual,
+                    uint32_t end, uint32_t tolerance)
+{
+    std::vector<uint32_t> want = expand(expected, end);
+    std::vector<uint32_t> got = expand(actual, end);
+
+    for(uint32_t ms = 0; ms <= end; ms++)
+    {
+        for(int output = 0; output < kOutputs; output++)
+        {
+            uint32_t a = want[ms * kOutputs + output];
+            uint32_t b = got[ms * kOutputs + output];
+
+            if(((a > b) ? a - b : b - a) > tolerance)
+            {
+                std::ostringstream message;
+
+                message << "tick " << ms << ", output " << output << ": width "
+                        << b << ", expected " << a;
+                return message.str();
+            }
+        }
+    }
+    return std::string();
+}
+
+}  // namespace motion
@@ -0,0 +1,64 @@
+//
+// motion_replay.h
+//
+// Replays a recorded USB session on the simulated board and traces the
+// width of the eight servo PWM outputs, one sample per tick of the
+// firmware clock.
+//
+// A session is a text file, one transfer per line:
+//
+//     # comment
+//     tolerance 2             widths a trace may differ by, default 0
+//     <ms> <hex bytes>        transfer written when milli_second reaches ms
+//         <hex bytes>         more bytes of the transfer above
+//     <ms> end                last tick traced
+//
+// A trace only keeps the changes, one per line: "<ms> <output> <width>".
+// It starts with the eight widths at tick 0.
+//
+#ifndef MOTION_REPLAY_H_
+#define MOTION_REPLAY_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace motion {
+
+constexpr int kOutputs = 8;
+
+struct Transfer {
+    uint32_t ms;
+    std::vector<uint8_t> data;
+};
+
+struct Session {
+    std::vector<Transfer> transfers;
+    uint32_t end = 0;
+    uint32_t tolerance = 0;
+};
+
+struct Change {
+    uint32_t ms;
+    uint32_t output;
+    uint32_t width;
+};
+
+using Trace = std::vector<Change>;
+
+// Throw std::runtime_error with the file and line of the error
+Session loadSession(const std::string &path);
+Trace loadTrace(const std::string &path);
+void saveTrace(const std::string &path, const Trace &trace);
+
+// Boots the firmware, replays the session and traces it
+Trace replay(const Session &session);
+
+// Empty when every width of the two traces is within the tolerance up to
+// the end, otherwise the first tick that is not
+std::string compare(const Trace &expected, const Trace &actual,
+                    uint32_t end, uint32_t tolerance);
+
+}  // namespace motion
+
+#endif /* MOTION_REPLAY_H_ */
@@ -0,0 +1,74 @@
+//
+// motion_trace.cpp
+//
+// Replays a USB session on the simulated board and writes the servo PWM
+// trace, or checks it against a golden trace:
+//
+//     motion_trace <session> -o <trace>       record (a new golden trace)
+//     motion_trace <session> -g <trace>       compare, exit 1 on mismatch
+//     motion_trace <session> -g <trace> -t 3  with another tolerance
+//
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include "motion_replay.h"
+
+static int usage()
+{
+    std::cerr << "usage: motion_trace <session> [-o <trace>] [-g <golden>] "
+                 "[-t <tolerance>]\n";
+    return 2;
+}
+
+int main(int argc, char **argv)
+{
+    const char *session_path = nullptr;
+    const char *out_path = nullptr;
+    const char *golden_path = nullptr;
+    long tolerance = -1;
+
+    for(int i = 1; i < argc; i++)
+    {
+        if((std::strcmp(argv[i], "-o") == 0) && (i + 1 < argc))
+            out_path = argv[++i];
+        else if((std::strcmp(argv[i], "-g") == 0) && (i + 1 < argc))
+            golden_path = argv[++i];
+        else if((std::strcmp(argv[i], "-t") == 0) && (i + 1 < argc))
+            tolerance = std::strtol(argv[++i], nullptr, 0);
+        else if((argv[i][0] != '-') && (session_path == nullptr))
+            session_path = argv[i];
+        else
+            return usage();
+    }
+    if((session_path == nullptr) || ((out_path == nullptr) && (golden_path == nullptr)))
+        return usage();
+
+    try
+    {
+        motion::Session session = motion::loadSession(session_path);
+        motion::Trace trace = motion::replay(session);
+
+        if(out_path != nullptr)
+            motion::saveTrace(out_path, trace);
+        if(golden_path != nullptr)
+        {
+            std::string error = motion::compare(
+                motion::loadTrace(golden_path), trace, session.end,
+                (tolerance < 0) ? session.tolerance : uint32_t(tolerance));
+
+            if(!error.empty())
+            {
+                std::cerr << session_path << ": " << error << "\n";
+                return 1;
+            }
+        }
+    }
+    catch(const std::exception &e)
+    {
+        std::cerr << e.what() << "\n";
+        return 2;
+    }
+    return 0;
+}
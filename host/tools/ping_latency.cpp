@@ -0,0 +1,137 @@
+//
+// ping_latency.cpp
+//
+// Round-trip latency of PING_CMD at a given rate, alone or behind servo
+// traffic, on usb_emulator or on the board.  Prints p50, p99 and p999 of
+// the round trip and of its device part, and the histogram of the round
+// trip, so that protocol and priority changes are compared in figures.
+//
+//     ping_latency (--socket <path> | --usb) [--count 1000] [--rate 100]
+//                  [--traffic 0] [--frame 64] [--csv]
+//
+// --rate 0 fires the pings back to back, --traffic n sends n
+// SERVO_DIRECT_CMD ahead of each ping.  --csv prints the samples instead.
+//
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "ping_probe.h"
+#ifdef HAVE_LIBUSB
+#include "libusb_transport.h"
+#endif
+
+namespace {
+
+int usage()
+{
+    std::fprintf(stderr,
+        "usage: ping_latency (--socket path"
+#ifdef HAVE_LIBUSB
+        " | --usb"
+#endif
+        ") [--count n] [--rate hz] [--traffic n]\n"
+        "                    [--frame bytes] [--csv]\n");
+    return 2;
+}
+
+void printSummary(const char *name, const latency::Summary &s)
+{
+    std::printf("%-12s %9.1f %9.1f %9.1f %9.1f %9.1f\n",
+                name, s.min, s.p50, s.p99, s.p999, s.max);
+}
+
+}  // namespace
+
+
+int main(int argc, char **argv)
+{
+    latency::Config config;
+    const char *path = nullptr;
+    bool usb = false;
+    bool csv = false;
+    size_t frame = 64;
+
+    for(int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        bool more = (i + 1 < argc);
+
+        if(std::strcmp(arg, "--usb") == 0)
+            usb = true;
+        else if(std::strcmp(arg, "--csv") == 0)
+            csv = true;
+        else if(!more)
+            return usage();
+        else if(std::strcmp(arg, "--socket") == 0)
+            path = argv[++i];
+        else if(std::strcmp(arg, "--count") == 0)
+            config.count = uint32_t(std::atoi(argv[++i]));
+        else if(std::strcmp(arg, "--rate") == 0)
+            config.rate = std::atof(argv[++i]);
+        else if(std::strcmp(arg, "--traffic") == 0)
+            config.traffic = uint32_t(std::atoi(argv[++i]));
+        else if(std::strcmp(arg, "--frame") == 0)
+            frame = size_t(std::atoi(argv[++i]));
+        else
+            return usage();
+    }
+    if((usb == (path != nullptr)) || (config.count == 0) || (config.rate < 0.0))
+        return usage();
+
+    std::unique_ptr<bulk::Transport> transport;
+    try
+    {
+#ifdef HAVE_LIBUSB
+        if(usb)
+            transport = std::make_unique<bulk::LibusbTransport>();
+        else
+#endif
+        if(path != nullptr)
+            transport = std::make_unique<bulk::SocketTransport>(path);
+        else
+            return usage();
+    }
+    catch(const std::exception &error)
+    {
+        std::fprintf(stderr, "ping_latency: %s\n", error.what());
+        return 1;
+    }
+
+    bulk::Client client(*transport, frame);
+    latency::Result result = latency::run(client, config);
+
+    if(csv)
+    {
+        std::printf("round_trip_us,device_us\n");
+        for(size_t i = 0; i < result.roundTrip.size(); i++)
+            std::printf("%.1f,%.2f\n", result.roundTrip[i], result.device[i]);
+        return (result.lost() == 0) ? 0 : 1;
+    }
+
+    std::printf("%u pings, %zu answered, %u lost, %u servo commands each\n\n",
+                result.sent, result.roundTrip.size(), result.lost(), config.traffic);
+    std::printf("%-12s %9s %9s %9s %9s %9s\n", "us", "min", "p50", "p99", "p999", "max");
+    printSummary("round trip", latency::summarize(result.roundTrip));
+    printSummary("on device", latency::summarize(result.device));
+
+    std::vector<uint32_t> bins = latency::histogram(result.roundTrip);
+    uint32_t most = 1;
+
+    for(uint32_t count : bins)
+        most = std::max(most, count);
+    std::printf("\nround trip\n");
+    for(size_t bin = 0; bin < bins.size(); bin++)
+    {
+        if(bins[bin] == 0)
+            continue;
+        std::printf("%8lu - %-8lu us %7u %s\n",
+                    (bin == 0) ? 0ul : 1ul << bin, (2ul << bin) - 1, bins[bin],
+                    std::string(size_t(bins[bin]) * 50 / most, '#').c_str());
+    }
+    return (result.lost() == 0) ? 0 : 1;
+}
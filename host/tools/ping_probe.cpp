@@ -0,0 +1,117 @@
+//
+// ping_probe.cpp
+//
+// Round-trip latency of the bulk protocol, see ping_probe.h.
+//
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "ping_probe.h"
+
+#include "protocol.h"
+
+namespace latency {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double percentile(const std::vector<double> &sorted, double p)
+{
+    size_t rank = size_t(std::ceil(p * double(sorted.size())));
+
+    return sorted[std::min(std::max<size_t>(rank, 1), sorted.size()) - 1];
+}
+
+}  // namespace
+
+Summary summarize(std::vector<double> samples)
+{
+    Summary summary;
+
+    if(samples.empty())
+        return summary;
+    std::sort(samples.begin(), samples.end());
+    summary.count = samples.size();
+    summary.min = samples.front();
+    summary.p50 = percentile(samples, 0.50);
+    summary.p99 = percentile(samples, 0.99);
+    summary.p999 = percentile(samples, 0.999);
+    summary.max = samples.back();
+    return summary;
+}
+
+std::vector<uint32_t> histogram(const std::vector<double> &samples)
+{
+    std::vector<uint32_t> bins;
+
+    for(double sample : samples)
+    {
+        size_t bin = (sample < 2.0) ? 0 : size_t(std::log2(sample));
+
+        if(bins.size() <= bin)
+            bins.resize(bin + 1, 0);
+        bins[bin]++;
+    }
+    return bins;
+}
+
+Result run(bulk::Client &client, const Config &config)
+{
+    Result result;
+    Clock::time_point start = Clock::now();
+    Clock::duration period = (config.rate > 0.0)
+        ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / config.rate))
+        : Clock::duration::zero();
+    Clock::time_point next = start;
+    uint32_t servo = 0;
+
+    // The stamp is the host time of the send, in ns since start
+    client.onMessage([&](const bulk::Message &message) {
+        bulk::Ping ping;
+
+        if(!bulk::decodePing(message, ping) || (ping.sysClock == 0))
+            return;
+        uint64_t now = uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            Clock::now() - start).count());
+        result.roundTrip.push_back(double(now - ping.stamp) / 1000.0);
+        result.device.push_back(double(uint32_t(ping.execCycles - ping.rxCycles)) * 1e6 /
+                                ping.sysClock);
+    });
+
+    while(result.sent < config.count)
+    {
+        Clock::time_point now = Clock::now();
+
+        if(now < next)
+        {
+            client.poll(int(std::chrono::duration_cast<std::chrono::milliseconds>(next - now).count()));
+            continue;
+        }
+        // Real traffic ahead of the ping, in the same transfer
+        for(uint32_t i = 0; i < config.traffic; i++, servo++)
+            client.send(bulk::cmd::servoDirect(uint8_t(servo % 8), uint32_t(2000 + (servo % 1000))));
+        client.send(bulk::cmd::ping(uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            Clock::now() - start).count())));
+        client.flush();
+        result.sent++;
+        // Late slots are skipped rather than caught up: a burst of pings
+        // would overflow the transmit ring of the device, which holds 10
+        // replies
+        next = std::max(next + period, Clock::now());
+        if(!client.poll(0))
+            break;
+    }
+
+    Clock::time_point end = Clock::now() + std::chrono::milliseconds(config.timeoutMs);
+    while((result.roundTrip.size() < result.sent) && (Clock::now() < end))
+    {
+        if(!client.poll(1))
+            break;
+    }
+    client.onMessage(nullptr);
+    return result;
+}
+
+}  // namespace latency
@@ -0,0 +1,54 @@
+//
+// ping_probe.h
+//
+// Round-trip latency of the bulk protocol: PING_CMD fired at a given rate
+// through the client, mixed with servo traffic, each echo timed against
+// the host clock.  The device part, from the receive interrupt to the
+// execution of the command, comes from the cycle counts of the echo.
+//
+#ifndef PING_PROBE_H_
+#define PING_PROBE_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "client.h"
+
+namespace latency {
+
+struct Config {
+    uint32_t count = 1000;              // pings
+    double rate = 100.0;                // pings per second, 0: back to back
+    uint32_t traffic = 0;               // SERVO_DIRECT_CMD sent with each ping
+    int timeoutMs = 1000;               // wait for the last echoes
+};
+
+struct Summary {
+    size_t count = 0;
+    double min = 0.0;                   // microseconds
+    double p50 = 0.0;
+    double p99 = 0.0;
+    double p999 = 0.0;
+    double max = 0.0;
+};
+
+struct Result {
+    uint32_t sent = 0;
+    std::vector<double> roundTrip;      // microseconds, host clock
+    std::vector<double> device;         // microseconds, reception to execution
+    // Not answered in time, or answer dropped by a full transmit ring
+    uint32_t lost() const { return sent - uint32_t(roundTrip.size()); }
+};
+
+// Nearest-rank percentiles of the samples
+Summary summarize(std::vector<double> samples);
+
+// Counts of the samples per power of two microseconds: bin n holds
+// [2^n, 2^(n+1)), bin 0 everything under 2
+std::vector<uint32_t> histogram(const std::vector<double> &samples);
+
+Result run(bulk::Client &client, const Config &config);
+
+}  // namespace latency
+
+#endif /* PING_PROBE_H_ */
@@ -0,0 +1,130 @@
+//
+// profile_dump.cpp
+//
+// Reads the interrupt profile of the board with PROFILE_CMD and prints
+// the worst-case execution time of every handler, under the interrupt
+// load of the last window.
+//
+//     profile_dump (--socket <path> | --usb) [--histogram] [--clear]
+//
+// --histogram adds the log2 histogram of each handler, --clear resets the
+// profile once read.
+//
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "client.h"
+#include "profile_report.h"
+#ifdef HAVE_LIBUSB
+#include "libusb_transport.h"
+#endif
+
+#include "protocol.h"
+#include "profile.h"
+
+namespace {
+
+int usage()
+{
+    std::fprintf(stderr,
+        "usage: profile_dump (--socket path"
+#ifdef HAVE_LIBUSB
+        " | --usb"
+#endif
+        ") [--histogram] [--clear]\n");
+    return 2;
+}
+
+}  // namespace
+
+
+int main(int argc, char **argv)
+{
+    const char *path = nullptr;
+    bool usb = false;
+    bool histograms = false;
+    bool clear = false;
+
+    for(int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+
+        if(std::strcmp(arg, "--usb") == 0)
+            usb = true;
+        else if(std::strcmp(arg, "--histogram") == 0)
+            histograms = true;
+        else if(std::strcmp(arg, "--clear") == 0)
+            clear = true;
+        else if((std::strcmp(arg, "--socket") == 0) && (i + 1 < argc))
+            path = argv[++i];
+        else
+            return usage();
+    }
+    if(usb == (path != nullptr))
+        return usage();
+
+    std::unique_ptr<bulk::Transport> transport;
+    try
+    {
+#ifdef HAVE_LIBUSB
+        if(usb)
+            transport = std::make_unique<bulk::LibusbTransport>();
+        else
+#endif
+        if(path != nullptr)
+            transport = std::make_unique<bulk::SocketTransport>(path);
+        else
+            return usage();
+    }
+    catch(const std::exception &error)
+    {
+        std::fprintf(stderr, "profile_dump: %s\n", error.what());
+        return 1;
+    }
+
+    bulk::Client client(*transport);
+    std::vector<profile::Handler> handlers;
+    profile::Load load;
+    bool loaded = false;
+
+    client.onMessage([&](const bulk::Message &message) {
+        profile::Handler handler;
+
+        if(profile::decodeHandler(message, handler))
+            handlers.push_back(handler);
+        else if(profile::decodeLoad(message, load))
+            loaded = true;
+    });
+
+    // The load first: it closes the window the handlers are read in.  One
+    // request at a time, the replies of all of them overflow the transmit
+    // ring
+    auto end = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    for(uint8_t id = 0; id <= PROFILE_ISR_NBR; id++)
+    {
+        size_t replies = handlers.size() + (loaded ? 1 : 0);
+
+        if(id == 0)
+            client.send(bulk::cmd::profile(0xFF, false));
+        else
+            client.send(bulk::cmd::profile(uint8_t(id - 1), clear));
+        while((handlers.size() + (loaded ? 1 : 0) == replies) &&
+              (std::chrono::steady_clock::now() < end))
+        {
+            if(!client.poll(1))
+                break;
+        }
+    }
+    if(!loaded || (handlers.size() != PROFILE_ISR_NBR))
+    {
+        std::fprintf(stderr, "profile_dump: %zu of %u replies to PROFILE_CMD\n",
+                     handlers.size() + (loaded ? 1 : 0), PROFILE_ISR_NBR + 1);
+        return 1;
+    }
+    std::fputs(profile::format(load, handlers, histograms).c_str(), stdout);
+    return 0;
+}
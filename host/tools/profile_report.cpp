@@ -0,0 +1,142 @@
+//
+// profile_report.cpp
+//
+// PROFILE_CMD replies decoded and laid out for reading, see
+// profile_report.h.
+//
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+
+#include "profile_report.h"
+
+#include "protocol.h"
+#include "profile.h"
+
+namespace profile {
+
+namespace {
+
+const char *const kNames[PROFILE_ISR_NBR] = {
+    "TIMER0",                           // millisecond tick and motion
+    "TIMER4",                           // Meccano bit timing
+    "MECCANO_PIN",
+    "TIMER5",
+    "USB0",
+    "ADC0",
+    "ENCODER",
+};
+
+std::string line(const char *format, ...) __attribute__((format(printf, 1, 2)));
+
+std::string line(const char *format, ...)
+{
+    char text[256];
+    va_list args;
+
+    va_start(args, format);
+    std::vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    return text;
+}
+
+}  // namespace
+
+std::string handlerName(uint8_t id)
+{
+    if(id < PROFILE_ISR_NBR)
+        return kNames[id];
+    return "handler " + std::to_string(id);
+}
+
+void binRange(size_t bin, uint32_t &low, uint32_t &high)
+{
+    low = (bin == 0) ? 0 : (1u << (bin + PROFILE_HIST_SHIFT));
+    high = (bin + 1 >= PROFILE_HIST_BINS) ? 0xFFFFFFFF
+                                          : (1u << (bin + PROFILE_HIST_SHIFT + 1)) - 1;
+}
+
+bool decodeHandler(const bulk::Message &message, Handler &handler)
+{
+    const uint8_t *p = message.data.data();
+
+    if((message.opcode != PROFILE_CMD) ||
+       (message.data.size() != 22 + 2 * PROFILE_HIST_BINS) || (p[1] >= PROFILE_ISR_NBR))
+        return false;
+    handler.id = p[1];
+    handler.count = bulk::get32(&p[2]);
+    handler.min = bulk::get32(&p[6]);
+    handler.max = bulk::get32(&p[10]);
+    handler.total = bulk::get64(&p[14]);
+    handler.hist.clear();
+    for(size_t bin = 0; bin < PROFILE_HIST_BINS; bin++)
+        handler.hist.push_back(uint16_t(bulk::get16(&p[22 + 2 * bin])));
+    return true;
+}
+
+bool decodeLoad(const bulk::Message &message, Load &load)
+{
+    const uint8_t *p = message.data.data();
+
+    if((message.opcode != PROFILE_CMD) || (message.data.size() != 11) ||
+       (p[1] < PROFILE_ISR_NBR))
+        return false;
+    load.load = uint16_t(bulk::get16(&p[2]));
+    load.peak = uint16_t(bulk::get16(&p[4]));
+    load.sysClock = bulk::get32(&p[6]);
+    load.handlers = p[10];
+    return true;
+}
+
+std::string format(const Load &load, std::vector<Handler> handlers, bool histograms)
+{
+    double usPerCycle = (load.sysClock != 0) ? 1e6 / load.sysClock : 0.0;
+    std::string text;
+
+    text += line("interrupt load %u.%u %%, peak %u.%u %%, clock %u MHz\n\n",
+                   load.load / 10, load.load % 10, load.peak / 10, load.peak % 10,
+                   load.sysClock / 1000000);
+    text += line("%-12s %10s %10s %10s %10s %10s\n",
+                   "handler", "count", "min", "mean", "max", "max us");
+
+    // Worst case first, the handlers that never ran left out
+    handlers.erase(std::remove_if(handlers.begin(), handlers.end(),
+                                  [](const Handler &h) { return h.count == 0; }),
+                   handlers.end());
+    std::stable_sort(handlers.begin(), handlers.end(),
+                     [](const Handler &a, const Handler &b) { return a.max > b.max; });
+
+    for(const Handler &h : handlers)
+    {
+        text += line("%-12s %10u %10u %10.0f %10u %10.2f\n",
+                       handlerName(h.id).c_str(), h.count, h.min,
+                       double(h.total) / h.count, h.max, h.max * usPerCycle);
+    }
+
+    if(!histograms)
+        return text;
+    for(const Handler &h : handlers)
+    {
+        uint16_t most = *std::max_element(h.hist.begin(), h.hist.end());
+
+        text += "\n" + handlerName(h.id) + " cycles\n";
+        for(size_t bin = 0; bin < h.hist.size(); bin++)
+        {
+            uint32_t low, high;
+
+            if(h.hist[bin] == 0)
+                continue;
+            binRange(bin, low, high);
+            if(high == 0xFFFFFFFF)
+                text += line("  %8u -          %5u%s ", low, h.hist[bin],
+                               (h.hist[bin] == 0xFFFF) ? "+" : " ");
+            else
+                text += line("  %8u - %-8u %5u%s ", low, high, h.hist[bin],
+                               (h.hist[bin] == 0xFFFF) ? "+" : " ");
+            text += std::string(size_t(h.hist[bin]) * 40 / most, '#') + "\n";
+        }
+    }
+    return text;
+}
+
+}  // namespace profile
@@ -0,0 +1,52 @@
+//
+// profile_report.h
+//
+// PROFILE_CMD replies decoded and laid out for reading: per interrupt
+// handler the count, the best, mean and worst execution time in cycles
+// and microseconds, and the log2 histogram, worst handler first, under
+// the interrupt load of the last window.
+//
+#ifndef PROFILE_REPORT_H_
+#define PROFILE_REPORT_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "messages.h"
+
+namespace profile {
+
+struct Handler {
+    uint8_t id = 0;
+    uint32_t count = 0;
+    uint32_t min = 0;                   // cycles
+    uint32_t max = 0;
+    uint64_t total = 0;
+    std::vector<uint16_t> hist;         // PROFILE_HIST_BINS, saturate at 0xFFFF
+};
+
+struct Load {
+    uint16_t load = 0;                  // per mille, last window
+    uint16_t peak = 0;
+    uint32_t sysClock = 0;              // Hz
+    uint8_t handlers = 0;
+};
+
+// Name of a PROFILE_ handler id, "handler <id>" for an unknown one
+std::string handlerName(uint8_t id);
+
+// Cycle range [low, high] of a histogram bin, the last one is open
+void binRange(size_t bin, uint32_t &low, uint32_t &high);
+
+// false if the message is not the reply of that kind
+bool decodeHandler(const bulk::Message &message, Handler &handler);
+bool decodeLoad(const bulk::Message &message, Load &load);
+
+// Table of the handlers that ran, by worst case, with their histograms
+// when asked
+std::string format(const Load &load, std::vector<Handler> handlers, bool histograms);
+
+}  // namespace profile
+
+#endif /* PROFILE_REPORT_H_ */
@@ -0,0 +1,121 @@
+//
+// speed_step.cpp
+//
+// Speed loop step response, see speed_step.h.
+//
+#include <cmath>
+
+#include "speed_step.h"
+
+#include "sim.h"
+#include "protocol.h"
+extern "C" {
+#include "dc_motor.h"
+#include "timer_handler.h"
+}
+
+namespace speed {
+
+namespace {
+
+void put16(std::vector<uint8_t> &cmd, uint32_t value)
+{
+    cmd.push_back(uint8_t(value >> 8));
+    cmd.push_back(uint8_t(value));
+}
+
+}  // namespace
+
+
+Result run(const Config &config)
+{
+    Result result;
+    std::vector<uint8_t> tune = {DC_PID_CMD, uint8_t(config.closedLoop ? 1 : 0)};
+    std::vector<uint8_t> step = {DC_SPEED_CMD};
+    sim_dc_plant plant = config.plant;
+    uint32_t stepMs;
+    uint8_t discard[256];
+
+    simBoardInit();
+    simPlantInit();
+    simPlantSet(DC_LEFT, &plant);
+    simPlantSet(DC_RIGHT, &plant);
+
+    put16(tune, uint32_t(config.kp));
+    put16(tune, uint32_t(config.ki));
+    put16(tune, uint32_t(config.kd));
+    put16(tune, uint32_t(config.velocityMax));
+    simUsbWrite(tune.data(), tune.size());
+    simRunMs(5);
+
+    put16(step, uint16_t(config.setpoint));
+    put16(step, uint16_t(config.setpoint));
+    simUsbWrite(step.data(), step.size());
+    // The step starts when the USB frame delivers it
+    while(dcSpeedSetpoint[DC_LEFT] != config.setpoint)
+        simRunUs(SIM_PLANT_STEP_US);
+    stepMs = milli_second;
+
+    result.target = double(config.setpoint) * config.velocityMax / DC_SPEED_MAX;
+    for(uint32_t ms = 0; ms < config.durationMs; ms++)
+    {
+        if((config.loadStepMs != 0) && (ms == config.loadStepMs))
+        {
+            plant.load += config.loadStep;
+            simPlantSet(DC_LEFT, &plant);
+            simPlantSet(DC_RIGHT, &plant);
+        }
+        simRunMs(1);
+        while(simUsbRead(discard, sizeof(discard)) != 0)
+            ;
+        result.samples.push_back({milli_second - stepMs, simPlantDuty(DC_LEFT),
+                                  simPlantVelocity(DC_LEFT), dcWheelVelocity[DC_LEFT]});
+    }
+
+    //
+    // Figures of the step, on the plant velocity
+    //
+    double low = -1.0, high = -1.0, peak = 0.0;
+    double settle = 0.0;
+    double band = std::fabs(result.target) * 0.05;
+    uint32_t end = (config.loadStepMs != 0) ? config.loadStepMs : config.durationMs;
+    double tail = 0.0;
+    uint32_t tailNbr = 0;
+
+    for(uint32_t i = 0; i < end && i < result.samples.size(); i++)
+    {
+        double v = result.samples[i].velocity;
+
+        if((low < 0) && (v >= 0.1 * result.target))
+            low = i;
+        if((high < 0) && (v >= 0.9 * result.target))
+            high = i;
+        if(v > peak)
+            peak = v;
+        if(std::fabs(v - result.target) > band)
+            settle = i + 1;
+        if(i + 100 >= end)
+        {
+            tail += v;
+            tailNbr++;
+        }
+    }
+    result.riseMs = ((low >= 0) && (high >= 0)) ? high - low : -1.0;
+    result.overshoot = (peak > result.target) ? 100.0 * (peak - result.target) / result.target : 0.0;
+    result.settleMs = (settle < end) ? settle : -1.0;
+    result.steadyError = (tailNbr != 0) ?
+                         100.0 * (result.target - tail / tailNbr) / result.target : 100.0;
+
+    result.loadDip = 0.0;
+    if(config.loadStepMs != 0)
+    {
+        double dip = result.target;
+
+        for(uint32_t i = config.loadStepMs; i < result.samples.size(); i++)
+            dip = std::fmin(dip, result.samples[i].velocity);
+        result.loadDip = 100.0 * (result.target - dip) / result.target;
+    }
+    return result;
+}
+
+}  // namespace speed
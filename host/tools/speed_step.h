@@ -0,0 +1,52 @@
+//
+// speed_step.h
+//
+// Step response of the wheel speed loop on the simulated board: the
+// firmware is booted with a plant model, tuned through DC_PID_CMD and
+// given a DC_SPEED_CMD step, as the host would do it.
+//
+#ifndef SPEED_STEP_H_
+#define SPEED_STEP_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "dc_plant.h"
+
+namespace speed {
+
+struct Config {
+    bool closedLoop = true;
+    int32_t kp = 2048;                  // Q8, as DC_PID_CMD
+    int32_t ki = 256;
+    int32_t kd = 0;
+    int32_t velocityMax = 3000;         // counts/s at DC_SPEED_MAX
+    int16_t setpoint = 16384;           // DC_SPEED_CMD, both wheels
+    uint32_t durationMs = 1000;
+    sim_dc_plant plant = SIM_PLANT_DEFAULT;
+    uint32_t loadStepMs = 0;            // 0: no load step
+    double loadStep = 0.0;              // counts/s added to the load then
+};
+
+struct Sample {
+    uint32_t ms;
+    double duty;                        // left wheel
+    double velocity;                    // plant, counts/s
+    int32_t measured;                   // dcWheelVelocity, counts/s
+};
+
+struct Result {
+    double target;                      // counts/s asked for
+    double riseMs;                      // 10 % to 90 % of the target, -1 if never
+    double overshoot;                   // % of the target
+    double settleMs;                    // last time out of the 5 % band, -1 if never in
+    double steadyError;                 // % of the target, mean of the last 100 ms
+    double loadDip;                     // % of the target lost after the load step
+    std::vector<Sample> samples;        // one per ms
+};
+
+Result run(const Config &config);
+
+}  // namespace speed
+
+#endif /* SPEED_STEP_H_ */
@@ -0,0 +1,96 @@
+//
+// speed_tune.cpp
+//
+// Tuning of the wheel speed loop on the motor model: runs a step with the
+// gains given and prints its figures, or the response sample by sample.
+//
+//     speed_tune [--kp 2048] [--ki 256] [--kd 0] [--vmax 3000] [--open]
+//                [--setpoint 16384] [--ms 1000]
+//                [--free-speed 3000] [--tau 0.05] [--stiction 0.05] [--load 0]
+//                [--load-step <ms> <counts/s>] [--csv]
+//
+// Gains are Q8 as in DC_PID_CMD, the setpoint is a DC_SPEED_CMD speed.
+//
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "speed_step.h"
+
+static int usage()
+{
+    std::fprintf(stderr,
+        "usage: speed_tune [--kp n] [--ki n] [--kd n] [--vmax n] [--open]\n"
+        "                  [--setpoint n] [--ms n] [--free-speed x] [--tau s]\n"
+        "                  [--stiction x] [--load x] [--load-step ms x] [--csv]\n");
+    return 2;
+}
+
+int main(int argc, char **argv)
+{
+    speed::Config config;
+    bool csv = false;
+
+    for(int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        bool more = (i + 1 < argc);
+
+        if(std::strcmp(arg, "--open") == 0)
+            config.closedLoop = false;
+        else if(std::strcmp(arg, "--csv") == 0)
+            csv = true;
+        else if(!more)
+            return usage();
+        else if(std::strcmp(arg, "--kp") == 0)
+            config.kp = std::atoi(argv[++i]);
+        else if(std::strcmp(arg, "--ki") == 0)
+            config.ki = std::atoi(argv[++i]);
+        else if(std::strcmp(arg, "--kd") == 0)
+            config.kd = std::atoi(argv[++i]);
+        else if(std::strcmp(arg, "--vmax") == 0)
+            config.velocityMax = std::atoi(argv[++i]);
+        else if(std::strcmp(arg, "--setpoint") == 0)
+            config.setpoint = int16_t(std::atoi(argv[++i]));
+        else if(std::strcmp(arg, "--ms") == 0)
+            config.durationMs = uint32_t(std::atoi(argv[++i]));
+        else if(std::strcmp(arg, "--free-speed") == 0)
+            config.plant.freeSpeed = std::atof(argv[++i]);
+        else if(std::strcmp(arg, "--tau") == 0)
+            config.plant.timeConstant = std::atof(argv[++i]);
+        else if(std::strcmp(arg, "--stiction") == 0)
+            config.plant.stiction = std::atof(argv[++i]);
+        else if(std::strcmp(arg, "--load") == 0)
+            config.plant.load = std::atof(argv[++i]);
+        else if((std::strcmp(arg, "--load-step") == 0) && (i + 2 < argc))
+        {
+            config.loadStepMs = uint32_t(std::atoi(argv[++i]));
+            config.loadStep = std::atof(argv[++i]);
+        }
+        else
+            return usage();
+    }
+    if((config.setpoint <= 0) || (config.plant.timeConstant <= 0.0) ||
+       (config.loadStepMs >= config.durationMs))
+        return usage();
+
+    speed::Result result = speed::run(config);
+
+    if(csv)
+    {
+        std::printf("ms,duty,velocity,measured\n");
+        for(const speed::Sample &sample : result.samples)
+            std::printf("%u,%.4f,%.1f,%d\n", sample.ms, sample.duty,
+                        sample.velocity, sample.measured);
+        return 0;
+    }
+
+    std::printf("target       %8.1f counts/s\n", result.target);
+    std::printf("rise 10-90%%  %8.1f ms\n", result.riseMs);
+    std::printf("overshoot    %8.1f %%\n", result.overshoot);
+    std::printf("settling 5%%  %8.1f ms\n", result.settleMs);
+    std::printf("steady error %8.1f %%\n", result.steadyError);
+    if(config.loadStepMs != 0)
+        std::printf("load dip     %8.1f %%\n", result.loadDip);
+    return 0;
+}
@@ -0,0 +1,198 @@
+//
+// trace_export.cpp
+//
+// Drains the trace ring of the board for a while and writes it as Chrome
+// trace JSON, to be opened in ui.perfetto.dev or chrome://tracing.  The
+// messages received can be saved as they come and converted again later.
+//
+//     trace_export (--socket <path> | --usb) [--mask 0x1F] [--ms 1000]
+//                  [--save capture.bin] [-o trace.json]
+//     trace_export --input capture.bin [--clock 120000000] [-o trace.json]
+//
+// The mask is that of TRACE_CMD, TRACE_CAT_ bits.
+//
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "client.h"
+#include "trace_json.h"
+#ifdef HAVE_LIBUSB
+#include "libusb_transport.h"
+#endif
+
+#include "protocol.h"
+#include "trace.h"
+
+namespace {
+
+int usage()
+{
+    std::fprintf(stderr,
+        "usage: trace_export (--socket path"
+#ifdef HAVE_LIBUSB
+        " | --usb"
+#endif
+        ") [--mask m] [--ms n] [--save file] [-o file]\n"
+        "       trace_export --input file [--clock hz] [-o file]\n");
+    return 2;
+}
+
+// Runs the client until done() or timeoutMs
+template <typename Done>
+void pollFor(bulk::Client &client, int timeoutMs, Done done)
+{
+    auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+
+    while(!done() && (std::chrono::steady_clock::now() < end))
+    {
+        if(!client.poll(1))
+            break;
+    }
+}
+
+}  // namespace
+
+
+int main(int argc, char **argv)
+{
+    const char *path = nullptr;
+    const char *input = nullptr;
+    const char *save = nullptr;
+    const char *output = nullptr;
+    bool usb = false;
+    uint8_t mask = TRACE_CAT_COMMAND | TRACE_CAT_KEYFRAME | TRACE_CAT_MECCANO |
+                   TRACE_CAT_PWM | TRACE_CAT_QUEUE;
+    int ms = 1000;
+    uint32_t sysClock = 120000000;
+
+    for(int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        bool more = (i + 1 < argc);
+
+        if(std::strcmp(arg, "--usb") == 0)
+            usb = true;
+        else if(!more)
+            return usage();
+        else if(std::strcmp(arg, "--socket") == 0)
+            path = argv[++i];
+        else if(std::strcmp(arg, "--input") == 0)
+            input = argv[++i];
+        else if(std::strcmp(arg, "--save") == 0)
+            save = argv[++i];
+        else if(std::strcmp(arg, "-o") == 0)
+            output = argv[++i];
+        else if(std::strcmp(arg, "--mask") == 0)
+            mask = uint8_t(std::strtoul(argv[++i], nullptr, 0));
+        else if(std::strcmp(arg, "--ms") == 0)
+            ms = std::atoi(argv[++i]);
+        else if(std::strcmp(arg, "--clock") == 0)
+            sysClock = uint32_t(std::strtoul(argv[++i], nullptr, 0));
+        else
+            return usage();
+    }
+    if((int(usb) + int(path != nullptr) + int(input != nullptr) != 1) || (sysClock == 0))
+        return usage();
+
+    std::vector<bulk::Message> messages;
+
+    if(input != nullptr)
+    {
+        // A capture of the IN stream, cut as the client does
+        FILE *in = std::fopen(input, "rb");
+        bulk::Decoder decoder;
+        uint8_t buffer[4096];
+        size_t size;
+
+        if(in == nullptr)
+        {
+            std::fprintf(stderr, "trace_export: %s: cannot read\n", input);
+            return 1;
+        }
+        while((size = std::fread(buffer, 1, sizeof(buffer), in)) != 0)
+            decoder.push(buffer, size, [&](const bulk::Message &m) { messages.push_back(m); });
+        std::fclose(in);
+    }
+    else
+    {
+        std::unique_ptr<bulk::Transport> transport;
+        try
+        {
+#ifdef HAVE_LIBUSB
+            if(usb)
+                transport = std::make_unique<bulk::LibusbTransport>();
+            else
+#endif
+            if(path != nullptr)
+                transport = std::make_unique<bulk::SocketTransport>(path);
+            else
+                return usage();
+        }
+        catch(const std::exception &error)
+        {
+            std::fprintf(stderr, "trace_export: %s\n", error.what());
+            return 1;
+        }
+
+        bulk::Client client(*transport);
+        bulk::Ping ping;
+        bool pinged = false;
+        FILE *capture = nullptr;
+
+        if(save != nullptr)
+        {
+            capture = std::fopen(save, "wb");
+            if(capture == nullptr)
+            {
+                std::fprintf(stderr, "trace_export: %s: cannot write\n", save);
+                return 1;
+            }
+        }
+        client.onMessage([&](const bulk::Message &message) {
+            if(capture != nullptr)
+                std::fwrite(message.data.data(), 1, message.data.size(), capture);
+            if(message.opcode == TRACE_MSG)
+                messages.push_back(message);
+            else if(bulk::decodePing(message, ping))
+                pinged = true;
+        });
+
+        // The clock of the board turns the cycles into time
+        client.send(bulk::cmd::ping(0));
+        pollFor(client, 1000, [&] { return pinged; });
+        if(!pinged || (ping.sysClock == 0))
+        {
+            std::fprintf(stderr, "trace_export: no answer to PING_CMD\n");
+            return 1;
+        }
+        sysClock = ping.sysClock;
+
+        client.send(bulk::cmd::trace(mask));
+        pollFor(client, ms, [] { return false; });
+        client.send(bulk::cmd::trace(0));
+        pollFor(client, 100, [] { return false; });
+        if(capture != nullptr)
+            std::fclose(capture);
+    }
+
+    trace::Converter converter(sysClock);
+    for(const bulk::Message &message : messages)
+        converter.push(message);
+
+    FILE *out = (output != nullptr) ? std::fopen(output, "w") : stdout;
+    if(out == nullptr)
+    {
+        std::fprintf(stderr, "trace_export: %s: cannot write\n", output);
+        return 1;
+    }
+    std::fputs(converter.json().c_str(), out);
+    if(out != stdout)
+        std::fclose(out);
+    std::fprintf(stderr, "%zu events, %u lost\n", converter.events().size(), converter.lost());
+    return 0;
+}
@@ -0,0 +1,230 @@
+//
+// trace_json.cpp
+//
+// TRACE_MSG packets to Chrome trace JSON, see trace_json.h.
+//
+#include <cstdarg>
+#include <cstdio>
+
+#include "trace_json.h"
+
+#include "protocol.h"
+#include "trace.h"
+
+namespace trace {
+
+namespace {
+
+// Tracks of the timeline
+constexpr int kUsbTrack = 1;
+constexpr int kMeccanoTrack = 2;
+constexpr int kActuatorTracks = 0x100;  // + actuator ID
+
+std::string line(const char *format, ...) __attribute__((format(printf, 1, 2)));
+
+std::string line(const char *format, ...)
+{
+    char text[256];
+    va_list args;
+
+    va_start(args, format);
+    std::vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    return text;
+}
+
+class Writer {
+public:
+    explicit Writer(uint32_t sysClock) : usPerCycle_(1e6 / sysClock) {}
+
+    double us(uint64_t cycles) const { return double(cycles) * usPerCycle_; }
+
+    void add(const std::string &event)
+    {
+        text_ += first_ ? "\n    " : ",\n    ";
+        text_ += event;
+        first_ = false;
+    }
+
+    void thread(int tid, const std::string &name)
+    {
+        add(line("{\"ph\": \"M\", \"pid\": 1, \"tid\": %d, \"name\": \"thread_name\", "
+                 "\"args\": {\"name\": \"%s\"}}", tid, name.c_str()));
+    }
+
+    void slice(int tid, const std::string &name, uint64_t start, uint64_t stop,
+               const std::string &args)
+    {
+        add(line("{\"ph\": \"X\", \"pid\": 1, \"tid\": %d, \"name\": \"%s\", "
+                 "\"ts\": %.3f, \"dur\": %.3f, \"args\": {%s}}",
+                 tid, name.c_str(), us(start), us(stop - start), args.c_str()));
+    }
+
+    void instant(int tid, const std::string &name, uint64_t at, const std::string &args)
+    {
+        add(line("{\"ph\": \"i\", \"s\": \"t\", \"pid\": 1, \"tid\": %d, \"name\": \"%s\", "
+                 "\"ts\": %.3f, \"args\": {%s}}",
+                 tid, name.c_str(), us(at), args.c_str()));
+    }
+
+    void counter(const std::string &name, uint64_t at, uint32_t value)
+    {
+        add(line("{\"ph\": \"C\", \"pid\": 1, \"name\": \"%s\", \"ts\": %.3f, "
+                 "\"args\": {\"value\": %u}}", name.c_str(), us(at), value));
+    }
+
+    const std::string &text() const { return text_; }
+
+private:
+    double usPerCycle_;
+    std::string text_;
+    bool first_ = true;
+};
+
+}  // namespace
+
+std::string actuatorName(uint8_t actuator)
+{
+    static const char *const groups[] = {
+        "left arm", "right arm", "meccano servo", "dc motor", "servo output"};
+    unsigned group = actuator >> 4;
+
+    if(group >= sizeof(groups) / sizeof(groups[0]))
+        return line("actuator 0x%02X", actuator);
+    return line("%s %u", groups[group], actuator & 0x0F);
+}
+
+Converter::Converter(uint32_t sysClock) : sysClock_(sysClock) {}
+
+bool Converter::push(const bulk::Message &message)
+{
+    const uint8_t *p = message.data.data();
+
+    if((message.opcode != TRACE_MSG) || (message.data.size() < 4) ||
+       (message.data.size() != 4 + 8u * p[1]))
+        return false;
+    lost_ += bulk::get16(&p[2]);
+    for(size_t i = 0; i < p[1]; i++)
+    {
+        const uint8_t *e = &p[4 + 8 * i];
+        uint32_t cycles = bulk::get32(&e[4]);
+
+        // The counter wraps in 35 s at 120 MHz, the events come in order
+        if(!events_.empty() && (cycles < last_))
+            wraps_++;
+        last_ = cycles;
+        events_.push_back({e[0], e[1], uint16_t(bulk::get16(&e[2])),
+                           (wraps_ << 32) | cycles});
+    }
+    return true;
+}
+
+std::string Converter::json() const
+{
+    Writer writer(sysClock_);
+    std::map<uint8_t, Event> keyframes;  // started, by actuator
+    std::map<int, bool> tracks;
+    bool framed = false;
+    Event frame = {};
+    uint64_t end = events_.empty() ? 0 : events_.back().cycles;
+
+    auto track = [&](int tid, const std::string &name) {
+        if(!tracks[tid])
+            writer.thread(tid, name);
+        tracks[tid] = true;
+    };
+
+    writer.add("{\"ph\": \"M\", \"pid\": 1, \"name\": \"process_name\", "
+               "\"args\": {\"name\": \"usb_dev_bulk\"}}");
+
+    for(const Event &e : events_)
+    {
+        int tid = kActuatorTracks + e.arg8;
+
+        switch(e.id)
+        {
+        case TRACE_COMMAND:
+            track(kUsbTrack, "usb");
+            writer.instant(kUsbTrack, line("command 0x%02X", e.arg8), e.cycles,
+                           line("\"available\": %u", e.arg16));
+            break;
+        case TRACE_KEYFRAME_START:
+            // A keyframe cut short by the next one ends there
+            track(tid, actuatorName(e.arg8));
+            if(keyframes.count(e.arg8) != 0)
+            {
+                const Event &start = keyframes[e.arg8];
+                writer.slice(tid, "keyframe", start.cycles, e.cycles,
+                             line("\"target\": %u, \"retired\": false", start.arg16));
+            }
+            keyframes[e.arg8] = e;
+            break;
+        case TRACE_KEYFRAME_RETIRE:
+            track(tid, actuatorName(e.arg8));
+            if(keyframes.count(e.arg8) != 0)
+            {
+                const Event &start = keyframes[e.arg8];
+                writer.slice(tid, "keyframe", start.cycles, e.cycles,
+                             line("\"target\": %u, \"retired\": true", start.arg16));
+                keyframes.erase(e.arg8);
+            }
+            else
+                writer.instant(tid, "keyframe retired", e.cycles,
+                               line("\"target\": %u", e.arg16));
+            break;
+        case TRACE_MECCANO_FRAME:
+            track(kMeccanoTrack, "meccano");
+            if(framed)
+                writer.slice(kMeccanoTrack, line("frame %u", frame.arg16), frame.cycles,
+                             e.cycles, line("\"module\": %u", frame.arg8));
+            frame = e;
+            framed = true;
+            break;
+        case TRACE_MECCANO_REPLY:
+        case TRACE_MECCANO_TIMEOUT:
+            track(kMeccanoTrack, "meccano");
+            if(framed)
+            {
+                if(e.id == TRACE_MECCANO_REPLY)
+                    writer.slice(kMeccanoTrack, line("frame %u", frame.arg16), frame.cycles,
+                                 e.cycles, line("\"module\": %u, \"reply\": %u",
+                                                e.arg8, e.arg16));
+                else
+                    writer.slice(kMeccanoTrack, line("frame %u", frame.arg16), frame.cycles,
+                                 e.cycles, line("\"module\": %u, \"timeout\": true, "
+                                                "\"retried\": %u", e.arg8, e.arg16));
+                framed = false;
+            }
+            else
+                writer.instant(kMeccanoTrack, (e.id == TRACE_MECCANO_REPLY) ? "reply" : "timeout",
+                               e.cycles, line("\"module\": %u", e.arg8));
+            break;
+        case TRACE_PWM_COMMIT:
+            writer.counter("pwm " + actuatorName(e.arg8), e.cycles, e.arg16);
+            break;
+        case TRACE_QUEUE_DEPTH:
+            writer.counter("queue " + actuatorName(e.arg8), e.cycles, e.arg16);
+            break;
+        default:
+            track(kUsbTrack, "usb");
+            writer.instant(kUsbTrack, line("event 0x%02X", e.id), e.cycles,
+                           line("\"arg8\": %u, \"arg16\": %u", e.arg8, e.arg16));
+            break;
+        }
+    }
+
+    // What is still open runs to the end of the trace
+    for(const auto &open : keyframes)
+        writer.slice(kActuatorTracks + open.first, "keyframe", open.second.cycles, end,
+                     line("\"target\": %u, \"retired\": false", open.second.arg16));
+    if(framed)
+        writer.slice(kMeccanoTrack, line("frame %u", frame.arg16), frame.cycles, end,
+                     line("\"module\": %u", frame.arg8));
+
+    return "{\n  \"displayTimeUnit\": \"ns\",\n"
+           "  \"otherData\": {\"lost\": " + std::to_string(lost_) +
+           ", \"clock\": " + std::to_string(sysClock_) + "},\n"
+           "  \"traceEvents\": [" + writer.text() + "\n  ]\n}\n";
+}
+
+}  // namespace trace
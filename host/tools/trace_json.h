@@ -0,0 +1,59 @@
+//
+// trace_json.h
+//
+// TRACE_MSG packets drained from the trace ring, turned into the Chrome
+// trace event format read by Perfetto and chrome://tracing.  The cycle
+// stamps are unwrapped and put in microseconds at the clock of the board:
+//   - a keyframe is a slice on the track of its actuator, from its start
+//     to its retirement,
+//   - a Meccano frame a slice on the Meccano track, up to its reply or
+//     timeout,
+//   - the commands received are instants on the USB track,
+//   - PWM commits and queue depths are counters.
+//
+#ifndef TRACE_JSON_H_
+#define TRACE_JSON_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "messages.h"
+
+namespace trace {
+
+struct Event {
+    uint8_t id;
+    uint8_t arg8;
+    uint16_t arg16;
+    uint64_t cycles;                    // unwrapped
+};
+
+// "left arm 3", "dc motor 1", ... for a TRACE_ actuator ID
+std::string actuatorName(uint8_t actuator);
+
+class Converter {
+public:
+    explicit Converter(uint32_t sysClock);
+
+    // Takes the events of a TRACE_MSG packet, false for another message
+    bool push(const bulk::Message &message);
+
+    const std::vector<Event> &events() const { return events_; }
+    uint32_t lost() const { return lost_; }
+
+    // The whole trace as Chrome trace JSON
+    std::string json() const;
+
+private:
+    uint32_t sysClock_;
+    std::vector<Event> events_;
+    uint32_t lost_ = 0;
+    uint64_t wraps_ = 0;
+    uint32_t last_ = 0;
+};
+
+}  // namespace trace
+
+#endif /* TRACE_JSON_H_ */
@@ -14,29 +14,30 @@
 
 #include "utils/uartstdio.h"
 
+#include "linked_list_dbl.h"
 #include "Meccano.h"
+#include "meccano_record.h"
 #include "delay.h"
+#include "profile.h"
+#include "hal.h"
+#include "trace.h"
+#include "latency.h"
+#include "event.h"
 
 
 
 volatile uint32_t state;
 volatile uint32_t mask;
 
-uint8_t meccanoType[3][4] = {{'_', '_', '_', '_'},
-							 {'_', '_', '_', '_'},
-							 {'_', '_', '_', '_'}};
-uint8_t meccanoOutputByte[3][4] = {{0xFE, 0xFE, 0xFE, 0xFE},
-								   {0xFE, 0xFE, 0xFE, 0xFE},
-								   {0xFE, 0xFE, 0xFE, 0xFE}};
+struct meccano_chain meccanoChain[3];
 
-uint8_t meccanoChecksum[3];
 uint8_t meccanoTempByte[3];
-uint8_t meccanoInputByte[3];
-
-uint8_t meccanoModuleNum[3] = {0, 0, 0};
 
 volatile bool chargeNewValue;
 volatile bool meccanoTimeout;
+uint32_t meccanoFrameGap = TIMER_LOADVALUE_10MS;	// quiet time between two frames
+
+static uint8_t meccanoKnownType[MECCANO_MODULE_NBR];	// types last notified
 
 
 extern volatile uint32_t delayCounter;
@@ -47,17 +48,43 @@ extern uint32_t g_ui32SysClock;
 #define HIGH                    1
 #define LOW                     0
 
-uint8_t LEDoutputByte1 = 0x03;
-uint8_t LEDoutputByte2 = 0x07;
+//*****************************************************************************
+//
+// Meccano servo movement variables.
+//
+//*****************************************************************************
+bool meccano_is_moving = false;
+uint32_t meccano_mvmt_start_time;
+uint8_t meccano_actual_pos[MECCANO_MODULE_NBR];
+uint8_t meccanoServoSetpoint[MECCANO_MODULE_NBR] = {MECCANO_SERVO_POS_MID,
+													MECCANO_SERVO_POS_MID,
+													MECCANO_SERVO_POS_MID,
+													MECCANO_SERVO_POS_MID};
 
-uint8_t moduleNum = 0;
-uint8_t inputByte;
-uint8_t checkSum;
-int ledOrder = 0;
 
-uint8_t moduleType[4];
-uint8_t outputByte[4];
 
+//*****************************************************************************
+//
+// Notifies the host of the modules that appeared or disappeared with the
+// last reply.
+//
+//*****************************************************************************
+static void
+meccanoTypeEvents(void)
+{
+	int i;
+
+	for(i = 0; i < MECCANO_MODULE_NBR; i++)
+	{
+		if(meccanoChain[0].type[i] == meccanoKnownType[i])
+			continue;
+		if(meccanoKnownType[i] != MECCANO_TYPE_UNKNOWN)
+			EVENT(EVENT_MODULE_LOST, i, meccanoKnownType[i]);
+		if(meccanoChain[0].type[i] != MECCANO_TYPE_UNKNOWN)
+			EVENT(EVENT_MODULE_FOUND, i, meccanoChain[0].type[i]);
+		meccanoKnownType[i] = meccanoChain[0].type[i];
+	}
+}
 
 
 //*****************************************************************************
@@ -66,194 +93,152 @@ uint8_t outputByte[4];
 //
 //*****************************************************************************
 void
-Timer1AIntHandler(void)
+Timer4AIntHandler(void)
 {
-	uint8_t outputValue;
+	uint8_t outputValue = 0;
+	PROFILE_ISR_ENTER();
     //
     // Clear the timer interrupt.
     //
-    ROM_TimerIntClear(TIMER1_BASE, TIMER_TIMA_TIMEOUT);
+    halTimerIntClear(TIMER4_BASE, TIMER_TIMA_TIMEOUT);
 
     //
     // Treat the Interrupt
     //
-    if(state == 0)
-    {
-    	outputValue = 0xFF;
-    	meccanoTempByte[0] = 0;
-    }
-    else if(state < 5)
+    if(state < MECCANO_FRAME_SIZE)
     {
-    	outputValue = meccanoOutputByte[0][state-1];
-    }
-    else if(state == 5)
-    {
-
-    	meccanoChecksum[0] = calculateCheckSum(meccanoOutputByte[0][0],
-											   meccanoOutputByte[0][1],
-											   meccanoOutputByte[0][2],
-											   meccanoOutputByte[0][3]);
-    	outputValue = meccanoChecksum[0];
-//		UARTprintf("Sent: %d, %d, %d, %d, %d\r\n", meccanoOutputByte[0][0],
-//												   meccanoOutputByte[0][1],
-//												   meccanoOutputByte[0][2],
-//												   meccanoOutputByte[0][3],
-//												   meccanoChecksum[0]);
+    	if((state == 0) && (mask == 0))
+    	{
+    		meccanoTempByte[0] = 0;
+    		meccanoFrameEncode(&meccanoChain[0]);
+    		TRACE(TRACE_MECCANO_FRAME, meccanoChain[0].moduleNum, meccanoChain[0].frames);
+    		latencyApply(LATENCY_MECCANO);
+//			UARTprintf("Sent: %d, %d, %d, %d, %d\r\n", meccanoChain[0].frame[1],
+//													   meccanoChain[0].frame[2],
+//													   meccanoChain[0].frame[3],
+//													   meccanoChain[0].frame[4],
+//													   meccanoChain[0].frame[5]);
+    	}
+    	outputValue = meccanoChain[0].frame[state];
     }
 
     if((mask == 0) && (state < 6))
     {
-        GPIOPinTypeGPIOOutput(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN);
-        GPIOPinWrite(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN, LOW);						// send 0
-        TimerLoadSet(TIMER1_BASE, TIMER_A, TIMER_LOADVALUE_417US);
+        halPinOutput(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN);
+        halPinWrite(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN, LOW);						// send 0
+        halTimerLoadSet(TIMER4_BASE, TIMER_A, TIMER_LOADVALUE_417US);
         mask = 0x01;
     }
     else if((mask < 0x100) && (mask > 0) && (state < 6))
     {
     	if (outputValue & mask)
     	{   // if bitwise AND resolves to true
-			GPIOPinWrite(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN, GPIO_MECCANO_PIN);  	// send 1
+			halPinWrite(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN, GPIO_MECCANO_PIN);  	// send 1
 		}else
 		{   // if bitwise and resolves to false
-			GPIOPinWrite(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN, LOW);               	// send 0
+			halPinWrite(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN, LOW);               	// send 0
 		}
         mask <<= 1;
     }
     else if((mask == 0x100) && (state < 6))
     {
-    	GPIOPinWrite(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN, GPIO_MECCANO_PIN);  		// send 1
+    	halPinWrite(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN, GPIO_MECCANO_PIN);  		// send 1
     	mask <<= 1;
     }
     else if((mask == 0x200) && (state < 6))
     {
-    	GPIOPinWrite(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN, GPIO_MECCANO_PIN);  		// send 1
+    	halPinWrite(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN, GPIO_MECCANO_PIN);  		// send 1
     	mask = 0;
     	state += 1;
     }
     else if((mask == 0) && (state == 6))
     {
-		GPIOPinTypeGPIOInput(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN);  			// Init GPIO as input
+		halPinInput(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN);  			// Init GPIO as input
 		mask = 0x01;
 		meccanoTimeout = true;
-        TimerLoadSet(TIMER1_BASE, TIMER_A, TIMER_LOADVALUE_3000US);
-		GPIOIntClear(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN);      // Clear pending interrupts for GPIO
-		GPIOIntEnable(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN);     // Enable interrupt for GPIO
+        halTimerLoadSet(TIMER4_BASE, TIMER_A, TIMER_LOADVALUE_3000US);
+		halPinIntClear(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN);      // Clear pending interrupts for GPIO
+		halPinIntEnable(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN);     // Enable interrupt for GPIO
     }
     else if((mask < 0x100) && (mask > 0) && (state == 6))
     {
     	if(meccanoTimeout)
 		{
 			/* Error: no Meccano response */
-    		meccanoModuleNum[0]++;                             // increment to next module ID
-			if (meccanoModuleNum[0] > 3)
-			{
-				meccanoModuleNum[0] = 0;
-			}
 			mask = 0;
 			state = 0;
 			chargeNewValue = true;
-			GPIOIntDisable(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN);    // Disable interrupt GPIO (in case it was enabled)
-			GPIOIntClear(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN);  	// Clear interrupt flag
-			TimerLoadSet(TIMER1_BASE, TIMER_A, TIMER_LOADVALUE_10MS);
+			halPinIntDisable(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN);    // Disable interrupt GPIO (in case it was enabled)
+			halPinIntClear(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN);  	// Clear interrupt flag
+			if(meccanoReplyTimeout(&meccanoChain[0]))
+			{
+				TRACE(TRACE_MECCANO_TIMEOUT, meccanoChain[0].moduleNum, 1);
+				halTimerLoadSet(TIMER4_BASE, TIMER_A, TIMER_LOADVALUE_500US);	// the line has been quiet long enough, retry now
+			}
+			else
+			{
+				TRACE(TRACE_MECCANO_TIMEOUT, meccanoChain[0].moduleNum, 0);
+				halTimerLoadSet(TIMER4_BASE, TIMER_A, meccanoFrameGap);
+			}
 		}
 		else
 		{
-			if(GPIOPinRead(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN) != LOW)
+			if(halPinRead(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN) != LOW)
 			{
 				meccanoTempByte[0] = meccanoTempByte[0] + mask;
 			}
 			meccanoTimeout = true;
-			TimerLoadSet(TIMER1_BASE, TIMER_A, TIMER_LOADVALUE_1500US);
-			GPIOIntClear(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN);      // Clear pending interrupts for GPIO
-			GPIOIntEnable(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN);     // Enable interrupt for GPIO
+			halTimerLoadSet(TIMER4_BASE, TIMER_A, TIMER_LOADVALUE_1500US);
+			halPinIntClear(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN);      // Clear pending interrupts for GPIO
+			halPinIntEnable(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN);     // Enable interrupt for GPIO
 			mask <<= 1;
 		}
     }
 
     if((mask >= 0x100) && (state == 6))
     {
-    	meccanoInputByte[0] = meccanoTempByte[0];
-    	// if received back 0xFE, then the module exists so get ID number
-    	if (meccanoTempByte[0] == 0xFE)
-    	{
-    		meccanoOutputByte[0][meccanoModuleNum[0]] = 0xFC;
-    	}
-
-    	// if received back 0x01 (module ID is a servo), then change servo color to Blue
-		if (meccanoTempByte[0] == 0x01 && meccanoType[0][meccanoModuleNum[0]] == '_')
-		{
-			meccanoOutputByte[0][meccanoModuleNum[0]] = 0xF4;
-			meccanoType[0][meccanoModuleNum[0]] = 'S';
-		}
-
-		if (meccanoType[0][meccanoModuleNum[0]] == 'L')
-		{
-			if(ledOrder == 0)
-			{
-				meccanoOutputByte[0][meccanoModuleNum[0]] = LEDoutputByte1;
-				ledOrder = 1;
-			}else
-			{
-				meccanoOutputByte[0][meccanoModuleNum[0]] = LEDoutputByte2;
-				ledOrder = 0;
-			}
-		}
-
-		// if received back 0x01 (module ID is a LED), then change servo color to Blue
-		if (meccanoTempByte[0] == 0x02 && meccanoType[0][meccanoModuleNum[0]] == '_')
-		{
-			LEDoutputByte1 = 0x04;
-			LEDoutputByte2 = 0x47;
-			meccanoOutputByte[0][meccanoModuleNum[0]] = LEDoutputByte1;
-			ledOrder = 1;
-			meccanoType[0][meccanoModuleNum[0]] = 'L';
-		}
-
-		if(meccanoTempByte[0] == 0x00)
-		{
-			int x;
-			for(x = meccanoModuleNum[0]; x < 4; x++)
-			{
-				meccanoOutputByte[0][x] = 0xFE;
-				meccanoType[0][x] = '_';
-			}
-		}
-
-//		UARTprintf("module: %d, received: %d\r\n", meccanoModuleNum[0], meccanoTempByte[0]);
-//		UARTprintf("Rcvd: %d, %d, %d, %d\r\n", meccanoOutputByte[0][0], meccanoOutputByte[0][1], meccanoOutputByte[0][2], meccanoOutputByte[0][3]);
-
-		meccanoModuleNum[0]++;                             // increment to next module ID
-		if (meccanoModuleNum[0] > 3)
-		{
-			meccanoModuleNum[0] = 0;
-		}
+//		UARTprintf("module: %d, received: %d\r\n", meccanoChain[0].moduleNum, meccanoTempByte[0]);
+    	TRACE(TRACE_MECCANO_REPLY, meccanoChain[0].moduleNum, meccanoTempByte[0]);
+    	meccanoReplyDecode(&meccanoChain[0], meccanoTempByte[0]);
+    	meccanoTypeEvents();
+    	meccanoRecordSample(&meccanoChain[0]);
 
     	/* Finished */
 		state = 0;
 		mask = 0;
 		chargeNewValue = true;
-		GPIOIntDisable(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN);    // Disable interrupt GPIO (in case it was enabled)
-		GPIOIntClear(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN);  	// Clear interrupt flag
-        TimerLoadSet(TIMER1_BASE, TIMER_A, TIMER_LOADVALUE_10MS);
+		halPinIntDisable(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN);    // Disable interrupt GPIO (in case it was enabled)
+		halPinIntClear(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN);  	// Clear interrupt flag
+        halTimerLoadSet(TIMER4_BASE, TIMER_A, meccanoFrameGap);
     }
+    PROFILE_ISR_EXIT(PROFILE_TIMER4);
 }
 
 
 void onMeccanoPinUp(void) {
-    if (GPIOIntStatus(GPIO_MECCANO_BASE, false) & GPIO_MECCANO_PIN) {
+	PROFILE_ISR_ENTER();
+    if (halPinIntStatus(GPIO_MECCANO_BASE) & GPIO_MECCANO_PIN) {
         // GPIO_MECCANO_PIN was interrupt cause
     	meccanoTimeout = false;
-        TimerLoadSet(TIMER1_BASE, TIMER_A, TIMER_LOADVALUE_500US);
-        GPIOIntDisable(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN);    // Disable interrupt GPIO (in case it was enabled)
-        GPIOIntClear(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN);  	// Clear interrupt flag
+        halTimerLoadSet(TIMER4_BASE, TIMER_A, TIMER_LOADVALUE_500US);
+        halPinIntDisable(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN);    // Disable interrupt GPIO (in case it was enabled)
+        halPinIntClear(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN);  	// Clear interrupt flag
     }
+    PROFILE_ISR_EXIT(PROFILE_MECCANO_PIN);
 }
 
 
 void MeccanoInit(void){
+	int i;
+
 	state = 0;
 	mask = 0;
 	chargeNewValue = false;
+	meccanoChainInit(&meccanoChain[MECCANO_HEAD]);
+	meccanoChainInit(&meccanoChain[MECCANO_LEFT_ARM]);
+	meccanoChainInit(&meccanoChain[MECCANO_RIGHT_ARM]);
+	for(i = 0; i < MECCANO_MODULE_NBR; i++)
+		meccanoKnownType[i] = MECCANO_TYPE_UNKNOWN;
 
     //
     // Enable the GPIO port that is used for the on-board LED.
@@ -276,7 +261,7 @@ void MeccanoInit(void){
     //
     // Enable the peripherals used by this example.
     //
-    SysCtlPeripheralEnable(SYSCTL_PERIPH_TIMER1);
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_TIMER4);
 
     //
     // Enable processor interrupts.
@@ -286,20 +271,20 @@ void MeccanoInit(void){
     //
     // Configure the 32-bit periodic timers.
     //
-    TimerConfigure(TIMER1_BASE, TIMER_CFG_PERIODIC);
-    TimerLoadSet(TIMER1_BASE, TIMER_A, SysCtlClockGet()/10);
+    TimerConfigure(TIMER4_BASE, TIMER_CFG_PERIODIC);
+    TimerLoadSet(TIMER4_BASE, TIMER_A, SysCtlClockGet()/10);
 
     //
     // Setup the interrupt for the timer timeout.
     //
-    IntEnable(INT_TIMER1A);
-    TimerIntEnable(TIMER1_BASE, TIMER_TIMA_TIMEOUT);
+    IntEnable(INT_TIMER4A);
+    TimerIntEnable(TIMER4_BASE, TIMER_TIMA_TIMEOUT);
 
     //
     // Enable the timers.
     //
-    TimerLoadSet(TIMER1_BASE, TIMER_A, TIMER_LOADVALUE_10MS);
-    TimerEnable(TIMER1_BASE, TIMER_A);
+    TimerLoadSet(TIMER4_BASE, TIMER_A, TIMER_LOADVALUE_10MS);
+    TimerEnable(TIMER4_BASE, TIMER_A);
 
 	// GPIO Interrupt setup
 	GPIOIntDisable(GPIO_MECCANO_BASE, GPIO_MECCANO_PIN);    // Disable interrupt GPIO (in case it was enabled)
@@ -335,9 +320,8 @@ The bytes are as such:
 
 void setMeccanoLEDColor(uint8_t red, uint8_t green, uint8_t blue, uint8_t fadetime){
     // values from 0-7
-    LEDoutputByte1 = 0 ; LEDoutputByte2 = 0;
-    LEDoutputByte1 =  0x3F & ( ( (green<<3) & 0x38) | (red & 0x07) );
-    LEDoutputByte2 =  0x40 | ( ( (fadetime<<3) & 0x38) | (blue & 0x07) );
+    meccanoChain[0].ledByte1 =  0x3F & ( ( (green<<3) & 0x38) | (red & 0x07) );
+    meccanoChain[0].ledByte2 =  0x40 | ( ( (fadetime<<3) & 0x38) | (blue & 0x07) );
 }
 
 /*   setMeccanoServoColor(int servoNum, byte color)  ->  sets the color of the Meccano Smart Servo module
@@ -361,8 +345,25 @@ setMeccanoServoColor(2,0xF6)
   end  */
 
 void setMeccanoServoColor(uint8_t servoNum, uint8_t color){
-    if(meccanoType[0][servoNum] == 'S'){
-    	meccanoOutputByte[0][servoNum] = color;
+    if(meccanoChain[0].type[servoNum] == MECCANO_TYPE_SERVO){
+    	meccanoChain[0].outputByte[servoNum] = color;
+    }
+}
+
+
+/*   setMeccanoServoColorOnce(int servoNum, byte color)  ->  sets the color of a Meccano Smart Servo without stopping its movement
+If the servo is currently showing a colour, this is the same as setMeccanoServoColor().
+Otherwise the colour is sent in the next frame only and the servo keeps on receiving its position afterwards.
+
+  end  */
+
+void setMeccanoServoColorOnce(uint8_t servoNum, uint8_t color){
+    if(meccanoChain[0].type[servoNum] == MECCANO_TYPE_SERVO){
+        if(meccanoChain[0].outputByte[servoNum] >= 0xF0 && meccanoChain[0].outputByte[servoNum] <= 0xF7){
+            meccanoChain[0].outputByte[servoNum] = color;
+        }else{
+            meccanoChain[0].servoColor[servoNum] = color;
+        }
     }
 }
 
@@ -379,17 +380,19 @@ The byte POS refers to the servo position  0x00 - 0xEF, which equals to a full 1
 
 void setMeccanoServoPosition(uint8_t servoNum, uint8_t pos){
     uint8_t servoPos = 0;
-    if(meccanoType[0][servoNum] == 'S'){
+    if((meccanoChain[0].type[servoNum] == MECCANO_TYPE_SERVO) &&
+       ((meccanoRecordMask & (1 << servoNum)) == 0)){
 
-        if(pos < 0x18){
-            servoPos = 0x18;
-        }else if(pos > 0xE8){
-            servoPos = 0xE8;
+        if(pos < MECCANO_SERVO_POS_MIN){
+            servoPos = MECCANO_SERVO_POS_MIN;
+        }else if(pos > MECCANO_SERVO_POS_MAX){
+            servoPos = MECCANO_SERVO_POS_MAX;
         }else{
             servoPos = pos;
         }
 
-        meccanoOutputByte[0][servoNum] = servoPos;
+        meccanoServoSetpoint[servoNum] = servoPos;
+        meccanoChain[0].outputByte[servoNum] = servoPos;
     }
 }
 
@@ -404,8 +407,8 @@ LIM stands for Learned Intelligent Movement.  It is a special mode where the ser
 
 
 void setMeccanoServotoLIM(uint8_t servoNum){
-    if(meccanoType[0][servoNum] == 'S'){
-    	meccanoOutputByte[0][servoNum] = 0xFA;
+    if(meccanoChain[0].type[servoNum] == MECCANO_TYPE_SERVO){
+    	meccanoChain[0].outputByte[servoNum] = MECCANO_LIM;
     }
 
 }
@@ -423,47 +426,10 @@ The returned byte POS is the servo's position  0x00 - 0xEF, which equals to a fu
   end */
 
 uint8_t getMeccanoServoPosition(uint8_t servoNum){
-    int temp = 0;
-    if(meccanoType[0][servoNum] == 'S'){
-        if (meccanoModuleNum[0] > 0){
-            temp = meccanoModuleNum[0] - 1;
-        }
-        else{
-            temp = 0;
-        }
-        if(temp == servoNum){
-            return meccanoInputByte[0];
+    if(meccanoChain[0].type[servoNum] == MECCANO_TYPE_SERVO){
+        if(meccanoChain[0].outputByte[servoNum] == MECCANO_LIM){
+            return meccanoChain[0].moduleInput[servoNum];
         }
     }
     return 0x00;
 }
-
-
-
-/*    communicate()  -  this is the main method that takes care of initializing, sending data to and receiving data from Meccano Smart modules
-
-  The datastream consists of 6 output bytes sent to the Smart modules and one return input byte from the Smart modules.
-  Since there can be a maximum of 4 Smart modules in a chain, each module takes turns replying along the single data wire.
-
-  Output bytes:
-      0xFF - the first byte is always a header byte of 0xFF
-      Data 1 -  the second byte is the data for the Smart module at the 1st position in the chain
-      Data 2 -  the third byte is the data for the Smart module at the 2nd position in the chain
-      Data 3 -  the fourth byte is the data for the Smart module at the 3rd position in the chain
-      Data 4 -  the fifth byte is the data for the Smart module at the 4th position in the chain
-      Checksum  -  the sixth byte is part checksum, part module ID.  The module ID tells which of the modules in the chain should reply
-   end  */
-
-
-uint8_t calculateCheckSum(uint8_t Data1, uint8_t Data2, uint8_t Data3, uint8_t Data4){
-    int CS;
-    CS =  Data1 + Data2 + Data3 + Data4;  // ignore overflow
-    CS = CS + (CS >> 8);                  // right shift 8 places
-    CS = CS + (CS << 4);                  // left shift 4 places
-    CS = CS & 0xF0;                     // mask off top nibble
-    CS = CS | meccanoModuleNum[0];
-    return CS;
-}
-
-
-
@@ -1,4 +1,6 @@
 
+#include "meccano_protocol.h"
+
 /* I/O Port Definitions */
 #define SYSCTL_MECCANO_GPIO     SYSCTL_PERIPH_GPIOP
 #define GPIO_MECCANO_BASE       GPIO_PORTP_BASE
@@ -19,6 +21,24 @@
 #define	MECCANO_LEFT_ARM		0x01
 #define	MECCANO_RIGHT_ARM		0x02
 
+/* Meccano Servo Definitions */
+#define MECCANO_SERVO_OFFSET	8		// servo number of the first Meccano servo in a movement
+#define MECCANO_SERVO_POS_MIN	0x18
+#define MECCANO_SERVO_POS_MAX	0xE8
+#define MECCANO_SERVO_POS_MID	0x80
+
+
+/* Meccano Servo movement variables */
+extern struct list_s meccano_servo_list[MECCANO_MODULE_NBR];	// list contains the different actions
+extern bool meccano_is_moving;
+extern uint32_t meccano_mvmt_start_time;
+extern uint8_t meccano_actual_pos[MECCANO_MODULE_NBR];
+extern uint8_t meccanoServoSetpoint[MECCANO_MODULE_NBR];
+
+/* Meccano chains */
+extern struct meccano_chain meccanoChain[3];
+extern uint32_t meccanoFrameGap;
+
 
 //    {"mecled",   CMD_mec_led,   " : set mecled [r] [g] [b] [t] => [0..7]"},
 //    {"mecsled",  CMD_mec_sled,  " : set mecsled [n] [clr] => n = [0..3], clr = [240..247]"},
@@ -29,7 +49,7 @@
 void MeccanoInit(void);
 void setMeccanoLEDColor(uint8_t red, uint8_t green, uint8_t blue, uint8_t fadetime);
 void setMeccanoServoColor(uint8_t servoNum, uint8_t color);
+void setMeccanoServoColorOnce(uint8_t servoNum, uint8_t color);
 void setMeccanoServoPosition(uint8_t servoNum, uint8_t pos);
 void setMeccanoServotoLIM(uint8_t servoNum);
 uint8_t getMeccanoServoPosition(uint8_t servoNum);
-uint8_t calculateCheckSum(uint8_t Data1, uint8_t Data2, uint8_t Data3, uint8_t Data4);
@@ -0,0 +1,140 @@
+/*
+ * app.c
+ *
+ * Purpose:  Start-up of the robot modules and the work of the main loop,
+ *           apart from the USB device, so that the host simulation runs
+ *           the same sequence as main().
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "linked_list_dbl.h"
+#include "delay.h"
+
+#include "timer_handler.h"
+#include "servo.h"
+#include "dc_motor.h"
+#include "dc_encoder.h"
+#include "dc_drive.h"
+#include "telemetry.h"
+#include "current_sense.h"
+#include "profile.h"
+#include "trace.h"
+#include "log.h"
+#include "memory.h"
+#include "bench.h"
+#include "latency.h"
+#include "event.h"
+#include "Meccano.h"
+#include "meccano_sequence.h"
+#include "meccano_record.h"
+#include "app.h"
+
+extern uint32_t ui32SysClock;
+
+//*****************************************************************************
+//
+// Linked list for servo motor movement.
+//
+//*****************************************************************************
+struct list_s left_arm_list[4];		// list contains the different actions
+struct list_s right_arm_list[4];	// list contains the different actions
+struct list_s meccano_servo_list[MECCANO_MODULE_NBR];	// list contains the different actions
+struct list_s dc_motor_list[DC_MOTOR_NBR];	// list contains the different actions
+
+
+//*****************************************************************************
+//
+// Initialises the robot modules and starts their interrupts.  The system
+// clock has to be set first.
+//
+//*****************************************************************************
+void appInit(void)
+{
+	int i;
+
+    /* Initialise action list */
+	for(i = 0; i < 4; i++)
+	{
+		left_arm_list[i].h_p = left_arm_list[i].t_p = NULL;
+		right_arm_list[i].h_p = right_arm_list[i].t_p = NULL;
+	}
+	for(i = 0; i < MECCANO_MODULE_NBR; i++)
+		meccano_servo_list[i].h_p = meccano_servo_list[i].t_p = NULL;
+	dc_motor_list[DC_LEFT].h_p = dc_motor_list[DC_LEFT].t_p = NULL;
+	dc_motor_list[DC_RIGHT].h_p = dc_motor_list[DC_RIGHT].t_p = NULL;
+    meccanoSequenceInit();
+
+    //
+    // Start the cycle counter before the first interrupt
+    //
+    profileInit();
+    latencyInit();
+
+    //
+    // Initialise millisecond timer
+    //
+    timerInit();
+
+    //
+    // Initialise delay functions
+    //
+    delay_init();
+
+    //
+    // Initialise Servo Control
+    //
+    initPWM();
+
+    //
+    // Initialise DC Motor Control
+    //
+    initDCMotor();
+
+    //
+    // Initialise the wheel encoders
+    //
+    dcEncoderInit();
+    driveInit();
+
+    //
+    // Initialise the current sensing
+    //
+    currentSenseInit();
+
+    //
+    // Initialise the Meccano Servos and LEDs
+    //
+    MeccanoInit();
+    LOG_INFO(LOG_BOOT, ui32SysClock, 0);
+}
+
+
+//*****************************************************************************
+//
+// One pass of the main loop.
+//
+//*****************************************************************************
+void appProcess(void)
+{
+    //
+    // Compress a finished Meccano record.
+    //
+    meccanoRecordProcess();
+
+    //
+    // Send the telemetry that is due.
+    //
+    memoryUpdate();
+    telemetryProcess();
+    traceProcess();
+    logProcess();
+    eventProcess();
+#ifdef BENCHMARK
+    benchProcess();
+#endif
+}
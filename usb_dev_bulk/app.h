@@ -0,0 +1,14 @@
+/*
+ * app.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+
+#ifndef APP_H_
+#define APP_H_
+
+void appInit(void);
+void appProcess(void);
+
+#endif /* APP_H_ */
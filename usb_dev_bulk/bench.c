@@ -0,0 +1,250 @@
+/*
+ * bench.c
+ *
+ * Purpose:  Cycle counts of the command and motion hot paths measured on
+ *           the target.  Every iteration runs with the interrupts masked
+ *           so that the handlers do not add to it, and the interrupts are
+ *           allowed again between two iterations.
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "driverlib/interrupt.h"
+#include "usblib/usblib.h"
+#include "usblib/device/usbdevice.h"
+#include "usblib/device/usbdbulk.h"
+
+#include "usb_bulk_structs.h"
+#include "protocol.h"
+#include "linked_list_dbl.h"
+#include "meccano_protocol.h"
+#include "profile.h"
+#include "trace.h"
+#include "motion.h"
+#include "metrics.h"
+#include "command.h"
+#include "bench.h"
+
+#ifdef BENCHMARK
+
+static bool benchPending = false;
+static uint8_t benchOpcode;
+static uint8_t benchId;
+static uint8_t benchParam;
+static uint32_t benchIterations;
+
+static struct list_node_s benchNodes[BENCH_CHANNELS_MAX];
+static struct list_s benchLists[BENCH_CHANNELS_MAX];
+static struct meccano_chain benchChain;
+static uint8_t benchTransfer[5 * BENCH_DECODE_MAX];
+static volatile uint32_t benchSink;
+static uint8_t benchReply[24];
+
+
+//*****************************************************************************
+//
+// Runs one iteration of the benchmark.
+//
+//*****************************************************************************
+static void benchRun(uint32_t iteration)
+{
+	uint32_t i;
+	uint32_t pos;
+
+	switch(benchId)
+	{
+	case BENCH_LIST:
+		Insert(&benchLists[0], 0xFFFFFFFF, 0xFFFFFFFF, iteration, 0);
+		listDelete(&benchLists[0], false);
+		break;
+	case BENCH_MOTION:
+		for(i = 0; i < benchParam; i++)
+			motionStep(&benchLists[i], 0, iteration & 0xFFFF, i * 64, i, &pos);
+		benchSink = pos;
+		break;
+	case BENCH_MECCANO_ENCODE:
+		meccanoFrameEncode(&benchChain);
+		break;
+	case BENCH_MECCANO_DECODE:
+		meccanoReplyDecode(&benchChain, benchParam);
+		break;
+	case BENCH_DECODE:
+		CommandDeferred(benchTransfer, 5 * benchParam);
+		break;
+	default:
+		break;
+	}
+}
+
+
+//*****************************************************************************
+//
+// Prepares the data of the benchmark, returns its status.
+//
+//*****************************************************************************
+static uint8_t benchSetup(void)
+{
+	uint32_t i;
+
+	switch(benchId)
+	{
+	case BENCH_LIST:
+		if(benchParam > BENCH_QUEUE_MAX)
+			return BENCH_BAD_ARGUMENT;
+		benchLists[0].h_p = benchLists[0].t_p = NULL;
+		for(i = 0; i < benchParam; i++)
+		{
+			Insert(&benchLists[0], i, i, i, 0);
+			if(listLength(&benchLists[0]) != i + 1)
+			{
+				Free_list(&benchLists[0]);
+				return BENCH_NO_MEMORY;
+			}
+		}
+		// The node of the iterations has to fit as well
+		Insert(&benchLists[0], 0xFFFFFFFF, 0xFFFFFFFF, 0, 0);
+		if(listLength(&benchLists[0]) != benchParam + 1)
+		{
+			Free_list(&benchLists[0]);
+			return BENCH_NO_MEMORY;
+		}
+		listDelete(&benchLists[0], false);
+		return BENCH_OK;
+	case BENCH_MOTION:
+		if((benchParam == 0) || (benchParam > BENCH_CHANNELS_MAX))
+			return BENCH_BAD_ARGUMENT;
+		// Actions that never end, nothing is freed
+		for(i = 0; i < benchParam; i++)
+		{
+			benchNodes[i].ms_time_start = 0;
+			benchNodes[i].ms_time_stop = 0x10000;
+			benchNodes[i].position = 4000 - i * 16;
+			benchNodes[i].arrival = 0;
+			benchNodes[i].prev_p = benchNodes[i].next_p = NULL;
+			benchLists[i].h_p = benchLists[i].t_p = &benchNodes[i];
+		}
+		return BENCH_OK;
+	case BENCH_MECCANO_ENCODE:
+	case BENCH_MECCANO_DECODE:
+		meccanoChainInit(&benchChain);
+		return BENCH_OK;
+	case BENCH_DECODE:
+		if((benchParam == 0) || (benchParam > BENCH_DECODE_MAX))
+			return BENCH_BAD_ARGUMENT;
+		// SERVO_MVMT_CMD is reserved: it is decoded and skipped, so
+		// only the decoding is measured
+		for(i = 0; i < 5 * benchParam; i++)
+			benchTransfer[i] = ((i % 5) == 0) ? SERVO_MVMT_CMD : 0;
+		return BENCH_OK;
+	default:
+		return BENCH_BAD_ARGUMENT;
+	}
+}
+
+
+//*****************************************************************************
+//
+// Asks for a benchmark, run later by benchProcess().
+//
+//*****************************************************************************
+void benchStart(uint8_t opcode, uint8_t bench, uint8_t param, uint32_t iterations)
+{
+	benchOpcode = opcode;
+	benchId = bench;
+	benchParam = param;
+	benchIterations = iterations;
+	benchPending = true;
+}
+
+
+//*****************************************************************************
+//
+// Runs the benchmark asked for and sends its result, called from the main
+// loop.
+//
+//*****************************************************************************
+void benchProcess(void)
+{
+	uint32_t i;
+	uint32_t start;
+	uint32_t cycles;
+	uint32_t overhead = 0xFFFFFFFF;
+	uint32_t min = 0xFFFFFFFF;
+	uint32_t max = 0;
+	uint64_t total = 0;
+	uint32_t savedTrace;
+	uint32_t savedInserted, savedRetired, savedFlushed;
+	uint16_t savedCommands;
+	uint8_t status;
+	uint8_t *p;
+	bool masked;
+
+	if(!benchPending)
+		return;
+	benchPending = false;
+
+	// Keep the benchmark out of the trace and of the metrics
+	savedTrace = traceMask;
+	traceMask = 0;
+	savedInserted = listInserted;
+	savedRetired = listRetired;
+	savedFlushed = listFlushed;
+	savedCommands = metricsCommands[SERVO_MVMT_CMD];
+
+	status = benchSetup();
+	if(status == BENCH_OK)
+	{
+		// Cost of the measurement itself
+		for(i = 0; i < 16; i++)
+		{
+			masked = IntMasterDisable();
+			start = DWT_CYCCNT_R;
+			cycles = DWT_CYCCNT_R - start;
+			if(!masked)
+				IntMasterEnable();
+			if(cycles < overhead)
+				overhead = cycles;
+		}
+
+		for(i = 0; i < benchIterations; i++)
+		{
+			masked = IntMasterDisable();
+			start = DWT_CYCCNT_R;
+			benchRun(i);
+			cycles = DWT_CYCCNT_R - start - overhead;
+			if(!masked)
+				IntMasterEnable();
+
+			if(cycles < min)
+				min = cycles;
+			if(cycles > max)
+				max = cycles;
+			total += cycles;
+		}
+		if(benchId == BENCH_LIST)
+			Free_list(&benchLists[0]);
+	}
+
+	traceMask = savedTrace;
+	listInserted = savedInserted;
+	listRetired = savedRetired;
+	listFlushed = savedFlushed;
+	metricsCommands[SERVO_MVMT_CMD] = savedCommands;
+
+	p = benchReply;
+	*p++ = benchOpcode;
+	*p++ = benchId;
+	*p++ = benchParam;
+	*p++ = status;
+	p = protocolPut16(p, benchIterations);
+	p = protocolPut32(p, (status == BENCH_OK) ? min : 0);
+	p = protocolPut32(p, max);
+	p = protocolPut32(p, (uint32_t)(total >> 32));
+	p = protocolPut32(p, (uint32_t)total);
+	USBSendPacket(benchReply, p - benchReply);
+}
+
+#endif
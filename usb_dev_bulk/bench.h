@@ -0,0 +1,44 @@
+/*
+ * bench.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+//*****************************************************************************
+//
+// Benchmarks run on the target with the cycle counter, compiled in when
+// BENCHMARK is defined.
+//
+//*****************************************************************************
+#define BENCH_LIST					0		// Insert at the tail and delete it, param = queue size
+#define BENCH_MOTION				1		// one motion tick, param = channels
+#define BENCH_MECCANO_ENCODE		2		// one Meccano frame encoded
+#define BENCH_MECCANO_DECODE		3		// one Meccano reply decoded, param = reply
+#define BENCH_DECODE				4		// one transfer decoded, param = commands
+
+#define BENCH_QUEUE_MAX				16		// nodes, the heap is 1 KB
+#define BENCH_CHANNELS_MAX			128
+#define BENCH_DECODE_MAX			12		// 5-byte commands in a 64-byte packet
+
+#define BENCH_OK					0
+#define BENCH_BAD_ARGUMENT			1
+#define BENCH_NO_MEMORY				2
+
+//*****************************************************************************
+//
+// Reply to the benchmark command, sent from the main loop once done:
+//   opcode, benchmark, param, status, iterations (2 bytes), then min, max
+//   and total (8 bytes) cycles of one iteration, the measurement overhead
+//   already removed.
+// bench_report on the host collects the replies as JSON.
+//
+//*****************************************************************************
+
+void benchStart(uint8_t opcode, uint8_t bench, uint8_t param, uint32_t iterations);
+void benchProcess(void);
+
+#endif /* BENCH_H_ */
@@ -0,0 +1,1110 @@
+/*
+ * command.c
+ *
+ * Purpose:  Decoding and execution of the commands of the host.  The
+ *           transport hands over its receive ring and the number of bytes
+ *           available, and the replies leave through USBSendPacket(), so
+ *           the same code serves the USB bulk device and any other
+ *           transport that provides these two.
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include "inc/hw_memmap.h"
+#include "driverlib/pwm.h"
+#include "driverlib/usb.h"
+#include "usblib/usblib.h"
+#include "usblib/device/usbdevice.h"
+#include "usblib/device/usbdbulk.h"
+#include "usb_bulk_structs.h"
+
+#include "linked_list_dbl.h"
+#include "timer_handler.h"
+#include "servo.h"
+#include "dc_motor.h"
+#include "dc_encoder.h"
+#include "dc_drive.h"
+#include "telemetry.h"
+#include "current_sense.h"
+#include "profile.h"
+#include "trace.h"
+#include "log.h"
+#include "metrics.h"
+#include "hal.h"
+#include "bench.h"
+#include "latency.h"
+#include "event.h"
+#include "schedule.h"
+#include "Meccano.h"
+#include "meccano_sequence.h"
+#include "meccano_record.h"
+#include "protocol.h"
+#include "command.h"
+
+
+extern uint32_t ui32SysClock;
+
+
+//*****************************************************************************
+//
+// Reply buffer, one USB packet long.
+//
+//*****************************************************************************
+#define REPLY_BUFFER_SIZE		64
+static uint8_t g_pui8ReplyBuffer[REPLY_BUFFER_SIZE];
+
+//*****************************************************************************
+//
+// Linked list for servo motor movement.
+//
+//*****************************************************************************
+extern struct list_s left_arm_list[4];		// list contains the different actions
+extern struct list_s right_arm_list[4];		// list contains the different actions
+
+//*****************************************************************************
+//
+// Receive ring of the transport being decoded.
+//
+//*****************************************************************************
+static const uint8_t *g_pui8CmdRing;
+static uint32_t g_ui32CmdRingSize;
+
+//*****************************************************************************
+//
+// Sequence number of the next command, given by SEQ_CMD, and the status
+// of the command being executed.
+//
+//*****************************************************************************
+static bool g_bCmdSequenced;
+static uint8_t g_ui8CmdSeq;
+static uint8_t g_ui8CmdStatus;
+static bool g_bAckDue;
+
+//*****************************************************************************
+//
+// Bytes of a refused command still to be skipped, they may arrive with the
+// next transfers.
+//
+//*****************************************************************************
+static uint32_t g_ui32CmdDiscard;
+
+uint32_t commandRxCycles;
+
+//*****************************************************************************
+//
+// PWM outputs of SERVO_DIRECT_CMD.
+//
+//*****************************************************************************
+#define SERVO_OUTPUT_NBR		8
+
+static const uint32_t g_pui32ServoOutput[SERVO_OUTPUT_NBR] = {
+    PWM_OUT_0, PWM_OUT_1, PWM_OUT_2, PWM_OUT_3,
+    PWM_OUT_4, PWM_OUT_5, PWM_OUT_6, PWM_OUT_7
+};
+
+//*****************************************************************************
+//
+// Reads one byte of the receive ring and advances the read index,
+// taking care of the buffer wrap.
+//
+//*****************************************************************************
+static uint8_t
+RxBufferRead(uint_fast32_t *pui32ReadIndex)
+{
+    uint8_t ui8Data = g_pui8CmdRing[*pui32ReadIndex];
+
+    (*pui32ReadIndex)++;
+    *pui32ReadIndex = ((*pui32ReadIndex == g_ui32CmdRingSize) ?
+                       0 : *pui32ReadIndex);
+    return(ui8Data);
+}
+
+//*****************************************************************************
+//
+// Returns a byte of the receive ring ahead of the read index, without
+// advancing it.
+//
+//*****************************************************************************
+static uint8_t
+RxBufferPeek(uint_fast32_t ui32ReadIndex, uint32_t ui32Offset)
+{
+    return(g_pui8CmdRing[(ui32ReadIndex + ui32Offset) % g_ui32CmdRingSize]);
+}
+
+//*****************************************************************************
+//
+// Reads a 32-bit value of the receive ring, most significant byte
+// first.
+//
+//*****************************************************************************
+static uint32_t
+RxBufferRead32(uint_fast32_t *pui32ReadIndex)
+{
+    uint32_t ui32Value;
+
+    ui32Value = RxBufferRead(pui32ReadIndex) << 24;
+    ui32Value |= RxBufferRead(pui32ReadIndex) << 16;
+    ui32Value |= RxBufferRead(pui32ReadIndex) << 8;
+    ui32Value |= RxBufferRead(pui32ReadIndex);
+    return(ui32Value);
+}
+
+
+//*****************************************************************************
+//
+// Refuses the command being decoded: it is reported with ACK_REFUSED and
+// its ui32Size bytes are skipped, even those not received yet, so that its
+// payload is never decoded as commands.
+//
+//*****************************************************************************
+static uint32_t
+CommandRefuse(uint32_t ui32Size)
+{
+    g_ui8CmdStatus = ACK_REFUSED;
+    g_ui32CmdDiscard = ui32Size;
+    return(ui32Size);
+}
+
+
+//*****************************************************************************
+//
+// Starts the movements charged for a set of groups on the same millisecond.
+//
+// \param ui8Groups is a mask of the groups: 0x01 left arm, 0x02 right arm,
+// 0x04 Meccano servos, 0x08 Meccano colour sequences, 0x10 DC motors.
+//
+//*****************************************************************************
+static void
+StartMovement(uint8_t ui8Groups)
+{
+    int i;
+
+    // Retrieve actual Servo position
+    actual_pos[0] = getServoPosition(0, false);
+    actual_pos[1] = getServoPosition(2, false);
+    actual_pos[2] = getServoPosition(2, true);
+    actual_pos[3] = getServoPosition(3, false);
+    actual_pos[4] = getServoPosition(1, true);
+    actual_pos[5] = getServoPosition(1, false);
+    actual_pos[6] = getServoPosition(0, true);
+    actual_pos[7] = getServoPosition(3, true);
+
+    // Start left arm movement
+    if((ui8Groups & 0x01) == 0x01)
+    {
+        left_mvmt_start_time = milli_second;
+        left_is_moving = true;
+        latencyStart(LATENCY_SERVO, commandRxCycles);
+    }
+    // Start right arm movement
+    if((ui8Groups & 0x02) == 0x02)
+    {
+        right_mvmt_start_time = milli_second;
+        right_is_moving = true;
+        latencyStart(LATENCY_SERVO, commandRxCycles);
+    }
+    // Start Meccano servo movement
+    if((ui8Groups & 0x04) == 0x04)
+    {
+        for(i = 0; i < MECCANO_MODULE_NBR; i++)
+            meccano_actual_pos[i] = meccanoServoSetpoint[i];
+        meccano_mvmt_start_time = milli_second;
+        meccano_is_moving = true;
+        latencyStart(LATENCY_MECCANO, commandRxCycles);
+    }
+    // Restart the Meccano colour sequences
+    if((ui8Groups & 0x08) == 0x08)
+    {
+        startMeccanoSequence(0x1F);
+    }
+    // Start DC motor movement, ramping from the present speeds
+    if((ui8Groups & 0x10) == 0x10)
+    {
+        driveCancel();
+        for(i = 0; i < DC_MOTOR_NBR; i++)
+            dc_actual_speed[i] = dcSpeedSetpoint[i];
+        dc_mvmt_start_time = milli_second;
+        dc_is_moving = true;
+        latencyStart(LATENCY_DC, commandRxCycles);
+    }
+}
+
+//*****************************************************************************
+//
+// Drops the DC motor movement so that direct commands are not overridden.
+//
+//*****************************************************************************
+static void
+StopDCMovement(void)
+{
+    driveCancel();
+    dc_is_moving = false;
+    Free_list(&dc_motor_list[DC_LEFT]);
+    Free_list(&dc_motor_list[DC_RIGHT]);
+}
+
+//*****************************************************************************
+//
+// Decodes and executes the command at the read index.
+//
+// \return Returns the number of bytes of the command, 0 if it is not
+// complete yet.
+//
+//*****************************************************************************
+static uint32_t
+CommandExecute(uint_fast32_t ui32ReadIndex, uint32_t ui32Available)
+{
+	int i;
+	int direction;
+	int servo;
+	int position = 0;
+	int colour;
+	int red, green, blue, time;
+	int speed;
+	int return_nbr;
+	int loops, hold;
+	uint32_t packet_nbr;
+
+    //
+    // Check the message type
+    //
+    switch(g_pui8CmdRing[ui32ReadIndex])
+    {
+    case DC_DIRECT_CMD:
+    	if(ui32Available < 11)
+    		return 0;
+    	StopDCMovement();
+		RxBufferRead(&ui32ReadIndex);
+		// Right then left DC motor: direction (0x01 forward,
+		// 0x02 backward, else unchanged), raw match value
+		for(i = 0; i < DC_MOTOR_NBR; i++)
+		{
+			direction = RxBufferRead(&ui32ReadIndex);
+			speed = RxBufferRead32(&ui32ReadIndex);
+			if((direction == 0x01) || (direction == 0x02))
+			{
+				latencyMark(LATENCY_DC, commandRxCycles);
+				setDCMotorSetpoint((i == 0) ? DC_RIGHT : DC_LEFT,
+								   dcMatchToSpeed(speed, direction == 0x01));
+			}
+		}
+		return 11;
+    case DC_SPEED_CMD:
+    	// Left and right speeds, signed 16-bit normalised to the
+    	// full duty cycle
+    	if(ui32Available < 5)
+    		return 0;
+    	StopDCMovement();
+		RxBufferRead(&ui32ReadIndex);
+		for(i = 0; i < DC_MOTOR_NBR; i++)
+		{
+			int16_t i16Speed;
+
+			i16Speed = RxBufferRead(&ui32ReadIndex) << 8;
+			i16Speed |= RxBufferRead(&ui32ReadIndex);
+			latencyMark(LATENCY_DC, commandRxCycles);
+			setDCMotorSetpoint(i, i16Speed);
+		}
+		return 5;
+    case DC_PWM_CMD:
+    	// frequency (Hz), resolution (bits), decay mode
+    	if(ui32Available < 7)
+    		return 0;
+		RxBufferRead(&ui32ReadIndex);
+		{
+			uint8_t *pui8Reply = g_pui8ReplyBuffer;
+			uint32_t ui32Frequency;
+			uint32_t ui32Bits;
+
+			ui32Frequency = RxBufferRead32(&ui32ReadIndex);
+			ui32Bits = RxBufferRead(&ui32ReadIndex);
+			ui32Frequency = setDCPwmConfig(ui32Frequency, ui32Bits,
+										   RxBufferRead(&ui32ReadIndex));
+
+			// Reply the frequency and the duty steps actually set
+			*pui8Reply++ = DC_PWM_CMD;
+			pui8Reply = protocolPut32(pui8Reply, ui32Frequency);
+			pui8Reply = protocolPut32(pui8Reply, dcPwmLoad / dcPwmStep);
+			USBSendPacket(g_pui8ReplyBuffer, pui8Reply - g_pui8ReplyBuffer);
+		}
+		return 7;
+    case DC_MVMT_CMD:
+    	// Single manoeuvre: ramp both motors to their speeds,
+    	// cruise, then ramp them down to a stop
+    	if(ui32Available < 15)
+    		return 0;
+    	RxBufferRead(&ui32ReadIndex);
+		{
+			int32_t i32Speed[DC_MOTOR_NBR];
+			uint32_t ui32Ramp;
+			uint32_t ui32Cruise;
+
+			i32Speed[DC_LEFT] = (int32_t)RxBufferRead32(&ui32ReadIndex);
+			i32Speed[DC_RIGHT] = (int32_t)RxBufferRead32(&ui32ReadIndex);
+			ui32Ramp = RxBufferRead(&ui32ReadIndex) << 8;
+			ui32Ramp += RxBufferRead(&ui32ReadIndex);
+			ui32Cruise = RxBufferRead32(&ui32ReadIndex);
+
+			StopDCMovement();
+			for(i = 0; i < DC_MOTOR_NBR; i++)
+			{
+				if(!Insert(&dc_motor_list[i], 0, ui32Ramp, (uint32_t)i32Speed[i],
+						   LATENCY_STAMP(commandRxCycles)) ||
+				   !Insert(&dc_motor_list[i], ui32Ramp, ui32Ramp + ui32Cruise, (uint32_t)i32Speed[i],
+						   LATENCY_STAMP(commandRxCycles)) ||
+				   !Insert(&dc_motor_list[i], ui32Ramp + ui32Cruise, 2 * ui32Ramp + ui32Cruise, 0,
+						   LATENCY_STAMP(commandRxCycles)))
+					g_ui8CmdStatus = ACK_REFUSED;
+			}
+		}
+		StartMovement(0x10);
+    	return 15;
+    case DC_START_MVMT_CMD:
+    	if(ui32Available < 2)
+    		return 0;
+		RxBufferRead(&ui32ReadIndex);
+		StartMovement(RxBufferRead(&ui32ReadIndex));
+    	return 2;
+    case DC_CHARGE_MVMT_CMD:
+    	// Wait for the whole timeline to be received, a timeline that the
+    	// receive ring or the keyframe store cannot hold is refused at once
+    	if(ui32Available < 2)
+    		return 0;
+    	packet_nbr = RxBufferPeek(ui32ReadIndex, 1);
+    	if((2 + 13 * packet_nbr > g_ui32CmdRingSize) ||
+    	   (packet_nbr > LIST_NODE_MAX))
+    		return CommandRefuse(2 + 13 * packet_nbr);
+    	if(ui32Available < 2 + 13 * packet_nbr)
+    		return 0;
+		RxBufferRead(&ui32ReadIndex);
+		packet_nbr = RxBufferRead(&ui32ReadIndex);
+		return_nbr = 2 + 13 * packet_nbr;
+		while(packet_nbr--)
+		{
+			uint32_t motor_nbr = RxBufferRead(&ui32ReadIndex);
+			uint32_t start_time = RxBufferRead32(&ui32ReadIndex);
+			uint32_t stop_time = RxBufferRead32(&ui32ReadIndex);
+			uint32_t stop_speed = RxBufferRead32(&ui32ReadIndex);
+
+			if(motor_nbr < DC_MOTOR_NBR)
+			{
+				// The signed speed is stored in the position field
+				if(!Insert(&dc_motor_list[motor_nbr],
+						   start_time,
+						   stop_time,
+						   stop_speed,
+						   LATENCY_STAMP(commandRxCycles)))
+					g_ui8CmdStatus = ACK_REFUSED;
+				TRACE(TRACE_QUEUE_DEPTH, TRACE_DC_MOTOR | motor_nbr,
+					  listLength(&dc_motor_list[motor_nbr]));
+			}
+		}
+		return return_nbr;
+    case DC_GET_POSITION_CMD:
+    	{
+			uint8_t *pui8Reply = g_pui8ReplyBuffer;
+
+			// opcode, time, then position (counts) and
+			// velocity (counts/s) of the left and right wheels
+			*pui8Reply++ = DC_GET_POSITION_CMD;
+			pui8Reply = protocolPut32(pui8Reply, milli_second);
+			for(i = 0; i < DC_MOTOR_NBR; i++)
+			{
+				pui8Reply = protocolPut32(pui8Reply, (uint32_t)dcEncoderPosition(i));
+				pui8Reply = protocolPut32(pui8Reply, (uint32_t)dcWheelVelocity[i]);
+			}
+			USBSendPacket(g_pui8ReplyBuffer, pui8Reply - g_pui8ReplyBuffer);
+    	}
+    	return 1;
+    case DC_PID_CMD:
+    	if(ui32Available < 10)
+    		return 0;
+		RxBufferRead(&ui32ReadIndex);
+		{
+			uint8_t ui8Mode = RxBufferRead(&ui32ReadIndex);
+			int32_t i32Kp, i32Ki, i32Kd, i32VelocityMax;
+
+			i32Kp = RxBufferRead(&ui32ReadIndex) << 8;
+			i32Kp += RxBufferRead(&ui32ReadIndex);
+			i32Ki = RxBufferRead(&ui32ReadIndex) << 8;
+			i32Ki += RxBufferRead(&ui32ReadIndex);
+			i32Kd = RxBufferRead(&ui32ReadIndex) << 8;
+			i32Kd += RxBufferRead(&ui32ReadIndex);
+			i32VelocityMax = RxBufferRead(&ui32ReadIndex) << 8;
+			i32VelocityMax += RxBufferRead(&ui32ReadIndex);
+
+			// Gains are Q8, a zero velocity keeps the present one
+			for(i = 0; i < DC_MOTOR_NBR; i++)
+				pidInit(&dcPid[i], i32Kp, i32Ki, i32Kd, DC_SPEED_MAX);
+			if(i32VelocityMax != 0)
+				dcVelocityMax = i32VelocityMax;
+			setDCClosedLoop(ui8Mode != 0);
+		}
+		return 10;
+    case DRIVE_VELOCITY_CMD:
+    	// v (mm/s), omega (mrad/s), signed 16-bit
+    	if(ui32Available < 5)
+    		return 0;
+		RxBufferRead(&ui32ReadIndex);
+		{
+			int16_t i16V, i16Omega;
+
+			i16V = RxBufferRead(&ui32ReadIndex) << 8;
+			i16V |= RxBufferRead(&ui32ReadIndex);
+			i16Omega = RxBufferRead(&ui32ReadIndex) << 8;
+			i16Omega |= RxBufferRead(&ui32ReadIndex);
+			StopDCMovement();
+			latencyMark(LATENCY_DC, commandRxCycles);
+			setDriveVelocity(i16V, i16Omega);
+		}
+    	return 5;
+    case DRIVE_POSE_CMD:
+    	// dx, dy (mm), dtheta (mrad), vmax (mm/s), signed 16-bit,
+    	// relative to the present pose
+    	if(ui32Available < 9)
+    		return 0;
+		RxBufferRead(&ui32ReadIndex);
+		{
+			int16_t i16Pose[4];
+
+			for(i = 0; i < 4; i++)
+			{
+				i16Pose[i] = RxBufferRead(&ui32ReadIndex) << 8;
+				i16Pose[i] |= RxBufferRead(&ui32ReadIndex);
+			}
+			StopDCMovement();
+			latencyMark(LATENCY_DC, commandRxCycles);
+			setDriveTarget(i16Pose[0], i16Pose[1], i16Pose[2], i16Pose[3]);
+		}
+    	return 9;
+    case DRIVE_ODOMETRY_RESET_CMD:
+    	driveResetOdometry();
+    	return 1;
+    case SERVO_DIRECT_CMD:
+    	// PWM output 0 - 7, pulse width (4 bytes)
+    	if(ui32Available < 6)
+    		return 0;
+		RxBufferRead(&ui32ReadIndex);
+		servo = RxBufferRead(&ui32ReadIndex);
+		position = RxBufferRead32(&ui32ReadIndex);
+		if(servo >= SERVO_OUTPUT_NBR)
+			return CommandRefuse(6);
+		servo = g_pui32ServoOutput[servo];
+
+		latencyMark(LATENCY_SERVO, commandRxCycles);
+		setServoPosition(servo, position);
+		// Return number of bytes received
+		return 6;
+    case SERVO_MVMT_CMD:
+
+    	break;
+    case SERVO_START_MVMT_CMD:
+    	if(ui32Available < 2)
+    		return 0;
+		RxBufferRead(&ui32ReadIndex);
+		// Servo groups and DC motors share the same start mask
+		StartMovement(RxBufferRead(&ui32ReadIndex));
+    	return 2;
+    case SERVO_CHARGE_MVMT_CMD:
+    	// Wait for the whole timeline to be received, a timeline that the
+    	// receive ring or the keyframe store cannot hold is refused at once
+    	if(ui32Available < 2)
+    		return 0;
+    	packet_nbr = RxBufferPeek(ui32ReadIndex, 1);
+    	if((2 + 13 * packet_nbr > g_ui32CmdRingSize) ||
+    	   (packet_nbr > LIST_NODE_MAX))
+    		return CommandRefuse(2 + 13 * packet_nbr);
+    	if(ui32Available < 2 + 13 * packet_nbr)
+    		return 0;
+    	return_nbr = 2;
+		RxBufferRead(&ui32ReadIndex);
+		packet_nbr = RxBufferRead(&ui32ReadIndex);
+
+		while(packet_nbr--)
+		{
+			uint32_t servo_nbr = RxBufferRead(&ui32ReadIndex);
+			uint32_t start_time = RxBufferRead32(&ui32ReadIndex);
+			uint32_t stop_time = RxBufferRead32(&ui32ReadIndex);
+			uint32_t stop_position = RxBufferRead32(&ui32ReadIndex);
+			if(servo_nbr < MECCANO_SERVO_OFFSET)
+			{
+				if(!Insert(servo_list[servo_nbr],
+						   start_time,
+						   stop_time,
+						   stop_position,
+						   LATENCY_STAMP(commandRxCycles)))
+					g_ui8CmdStatus = ACK_REFUSED;
+				TRACE(TRACE_QUEUE_DEPTH,
+					  (servo_not[servo_nbr].left ? TRACE_LEFT_ARM : TRACE_RIGHT_ARM) | servo_not[servo_nbr].nbr,
+					  listLength(servo_list[servo_nbr]));
+			}
+			else if(servo_nbr < MECCANO_SERVO_OFFSET + MECCANO_MODULE_NBR)
+			{
+				// Meccano smart servos share the timeline of the PWM servos
+				if(!Insert(&meccano_servo_list[servo_nbr - MECCANO_SERVO_OFFSET],
+						   start_time,
+						   stop_time,
+						   stop_position,
+						   LATENCY_STAMP(commandRxCycles)))
+					g_ui8CmdStatus = ACK_REFUSED;
+				TRACE(TRACE_QUEUE_DEPTH, TRACE_MECCANO_SERVO | (servo_nbr - MECCANO_SERVO_OFFSET),
+					  listLength(&meccano_servo_list[servo_nbr - MECCANO_SERVO_OFFSET]));
+			}
+			return_nbr += 13;
+		}
+		return return_nbr;
+    case SERVO_GET_POSITION_CMD:
+        //
+        // Read the new packet and echo it back to the host.
+        //
+        //return(EchoNewDataToHost(psDevice, pvMsgData, ui32Available));
+    	break;
+    case MECCANO_SERVO_POS_CMD:
+    	if(ui32Available < 3)
+    		return 0;
+		RxBufferRead(&ui32ReadIndex);
+		servo = RxBufferRead(&ui32ReadIndex);
+		position = RxBufferRead(&ui32ReadIndex);
+		if(servo >= MECCANO_MODULE_NBR)
+			return CommandRefuse(3);
+
+		latencyMark(LATENCY_MECCANO, commandRxCycles);
+		setMeccanoServoPosition(servo, position);
+		// Return number of bytes received
+		return 3;
+    case MECCANO_SERVO_LED_CMD:
+    	if(ui32Available < 3)
+    		return 0;
+		RxBufferRead(&ui32ReadIndex);
+		servo = RxBufferRead(&ui32ReadIndex);
+		colour = RxBufferRead(&ui32ReadIndex);
+		if(servo >= MECCANO_MODULE_NBR)
+			return CommandRefuse(3);
+
+		latencyMark(LATENCY_MECCANO, commandRxCycles);
+		setMeccanoServoColor(servo, colour);
+		// Return number of bytes received
+		return 3;
+    case MECCANO_LED_CMD:
+    	if(ui32Available < 5)
+    		return 0;
+		RxBufferRead(&ui32ReadIndex);
+		red = RxBufferRead(&ui32ReadIndex);
+		green = RxBufferRead(&ui32ReadIndex);
+		blue = RxBufferRead(&ui32ReadIndex);
+		time = RxBufferRead(&ui32ReadIndex);
+
+		latencyMark(LATENCY_MECCANO, commandRxCycles);
+		setMeccanoLEDColor(red, green, blue, time);
+		// Return number of bytes received
+		return 5;
+    case MECCANO_LED_SEQ_CMD:
+    	// Wait for the whole sequence to be received, a sequence longer
+    	// than the keyframe store is refused before
+    	if(ui32Available < 3)
+    		return 0;
+    	packet_nbr = RxBufferPeek(ui32ReadIndex, 2);
+    	if(packet_nbr > LED_SEQ_KEYFRAME_MAX)
+    		return CommandRefuse(3 + 6 * packet_nbr);
+    	if(ui32Available < 3 + 6 * packet_nbr)
+    		return 0;
+    	RxBufferRead(&ui32ReadIndex);
+		loops = RxBufferRead(&ui32ReadIndex);
+		packet_nbr = RxBufferRead(&ui32ReadIndex);
+		return_nbr = 3 + 6 * packet_nbr;
+		setMeccanoLEDSequence(loops);
+		while(packet_nbr--)
+		{
+			red = RxBufferRead(&ui32ReadIndex);
+			green = RxBufferRead(&ui32ReadIndex);
+			blue = RxBufferRead(&ui32ReadIndex);
+			time = RxBufferRead(&ui32ReadIndex);
+			hold = RxBufferRead(&ui32ReadIndex) << 8;
+			hold += RxBufferRead(&ui32ReadIndex);
+			addMeccanoLEDKeyframe(red, green, blue, time, hold);
+		}
+		startMeccanoSequence(0x01);
+		return return_nbr;
+    case MECCANO_SERVO_LED_SEQ_CMD:
+    	// Wait for the whole sequence to be received, a sequence longer
+    	// than the keyframe store or for no servo is refused before
+    	if(ui32Available < 4)
+    		return 0;
+    	packet_nbr = RxBufferPeek(ui32ReadIndex, 3);
+    	if((packet_nbr > SERVO_SEQ_KEYFRAME_MAX) ||
+    	   (RxBufferPeek(ui32ReadIndex, 1) >= MECCANO_MODULE_NBR))
+    		return CommandRefuse(4 + 3 * packet_nbr);
+    	if(ui32Available < 4 + 3 * packet_nbr)
+    		return 0;
+    	RxBufferRead(&ui32ReadIndex);
+		servo = RxBufferRead(&ui32ReadIndex);
+		loops = RxBufferRead(&ui32ReadIndex);
+		packet_nbr = RxBufferRead(&ui32ReadIndex);
+		return_nbr = 4 + 3 * packet_nbr;
+		setMeccanoServoColorSequence(servo, loops);
+		while(packet_nbr--)
+		{
+			colour = RxBufferRead(&ui32ReadIndex);
+			hold = RxBufferRead(&ui32ReadIndex) << 8;
+			hold += RxBufferRead(&ui32ReadIndex);
+			addMeccanoServoColorKeyframe(servo, colour, hold);
+		}
+		startMeccanoSequence(0x02 << servo);
+		return return_nbr;
+    case MECCANO_RECORD_CMD:
+    	if(ui32Available < 3)
+    		return 0;
+    	RxBufferRead(&ui32ReadIndex);
+		servo = RxBufferRead(&ui32ReadIndex);
+		position = RxBufferRead(&ui32ReadIndex);
+		// A servo mask starts a record, an empty mask stops it and
+		// compresses it with the given position tolerance
+		if(servo != 0)
+			meccanoRecordStart(servo);
+		else
+			meccanoRecordStop(position);
+		return 3;
+    case MECCANO_GET_RECORD_CMD:
+    	if(ui32Available < 4)
+    		return 0;
+    	RxBufferRead(&ui32ReadIndex);
+		{
+			uint8_t *pui8Reply = g_pui8ReplyBuffer;
+			uint32_t ui32Offset;
+			uint32_t ui32Total;
+			uint8_t ui8Kind = RxBufferRead(&ui32ReadIndex);
+
+			ui32Offset = RxBufferRead(&ui32ReadIndex) << 8;
+			ui32Offset += RxBufferRead(&ui32ReadIndex);
+			ui32Total = (ui8Kind == 0) ? lim_sample_nbr : lim_keyframe_nbr;
+
+			// Header: opcode, kind, total, offset, count
+			*pui8Reply++ = MECCANO_GET_RECORD_CMD;
+			*pui8Reply++ = ui8Kind;
+			pui8Reply = protocolPut16(pui8Reply, ui32Total);
+			pui8Reply = protocolPut16(pui8Reply, ui32Offset);
+			*pui8Reply++ = 0;
+			for(i = 0; (ui32Offset + i < ui32Total); i++)
+			{
+				if(ui8Kind == 0)
+				{
+					// Raw sample: servo, time, position
+					if(pui8Reply + 6 > g_pui8ReplyBuffer + REPLY_BUFFER_SIZE)
+						break;
+					*pui8Reply++ = lim_sample[ui32Offset + i].servo;
+					pui8Reply = protocolPut32(pui8Reply, lim_sample[ui32Offset + i].ms_time);
+					*pui8Reply++ = lim_sample[ui32Offset + i].position;
+				}
+				else
+				{
+					// Keyframe: servo, start, stop, position
+					if(pui8Reply + 10 > g_pui8ReplyBuffer + REPLY_BUFFER_SIZE)
+						break;
+					*pui8Reply++ = lim_keyframe[ui32Offset + i].servo;
+					pui8Reply = protocolPut32(pui8Reply, lim_keyframe[ui32Offset + i].ms_time_start);
+					pui8Reply = protocolPut32(pui8Reply, lim_keyframe[ui32Offset + i].ms_time_stop);
+					*pui8Reply++ = lim_keyframe[ui32Offset + i].position;
+				}
+			}
+			g_pui8ReplyBuffer[6] = i;
+			USBSendPacket(g_pui8ReplyBuffer, pui8Reply - g_pui8ReplyBuffer);
+		}
+		return 4;
+    case MECCANO_REPLAY_CMD:
+    	if(!meccanoRecordReplay())
+    		g_ui8CmdStatus = ACK_REFUSED;
+    	return 1;
+    case MECCANO_GET_ERRORS_CMD:
+    	if(ui32Available < 2)
+    		return 0;
+    	RxBufferRead(&ui32ReadIndex);
+		{
+			uint8_t *pui8Reply = g_pui8ReplyBuffer;
+			struct meccano_chain *chain_p = &meccanoChain[0];
+
+			// opcode, time, frames, then type, timeouts, bad
+			// replies and rediscoveries of every module
+			*pui8Reply++ = MECCANO_GET_ERRORS_CMD;
+			pui8Reply = protocolPut32(pui8Reply, milli_second);
+			pui8Reply = protocolPut32(pui8Reply, chain_p->frames);
+			for(i = 0; i < MECCANO_MODULE_NBR; i++)
+			{
+				*pui8Reply++ = chain_p->type[i];
+				pui8Reply = protocolPut32(pui8Reply, chain_p->timeouts[i]);
+				pui8Reply = protocolPut32(pui8Reply, chain_p->badReplies[i]);
+				pui8Reply = protocolPut32(pui8Reply, chain_p->rediscoveries[i]);
+			}
+			USBSendPacket(g_pui8ReplyBuffer, pui8Reply - g_pui8ReplyBuffer);
+
+			// A non-zero byte clears the counters once read
+			if(RxBufferRead(&ui32ReadIndex) != 0)
+				meccanoErrorsClear(chain_p);
+		}
+		return 2;
+    case TELEMETRY_CMD:
+    	// period (ms, 0 stops), channel mask
+    	if(ui32Available < 4)
+    		return 0;
+		RxBufferRead(&ui32ReadIndex);
+		{
+			uint32_t ui32Period;
+
+			ui32Period = RxBufferRead(&ui32ReadIndex) << 8;
+			ui32Period += RxBufferRead(&ui32ReadIndex);
+			setTelemetry(ui32Period, RxBufferRead(&ui32ReadIndex));
+		}
+		return 4;
+    case CURRENT_LIMIT_CMD:
+    	// DC motor and servo supply limits (mA)
+    	if(ui32Available < 5)
+    		return 0;
+		RxBufferRead(&ui32ReadIndex);
+		{
+			uint32_t ui32DCLimit;
+			uint32_t ui32ServoLimit;
+
+			ui32DCLimit = RxBufferRead(&ui32ReadIndex) << 8;
+			ui32DCLimit += RxBufferRead(&ui32ReadIndex);
+			ui32ServoLimit = RxBufferRead(&ui32ReadIndex) << 8;
+			ui32ServoLimit += RxBufferRead(&ui32ReadIndex);
+			setCurrentLimit(ui32DCLimit, ui32ServoLimit);
+		}
+		return 5;
+    case PROFILE_CMD:
+    	// handler ID (0xFF for the CPU load), clear after read
+    	if(ui32Available < 3)
+    		return 0;
+		RxBufferRead(&ui32ReadIndex);
+		{
+			uint8_t *pui8Reply = g_pui8ReplyBuffer;
+			uint8_t ui8Id = RxBufferRead(&ui32ReadIndex);
+			struct isr_profile *psProfile;
+
+			*pui8Reply++ = PROFILE_CMD;
+			*pui8Reply++ = ui8Id;
+			if(ui8Id < PROFILE_ISR_NBR)
+			{
+				// count, min, max, total (64-bit) cycles, then
+				// the log2 histogram
+				psProfile = &isrProfile[ui8Id];
+				pui8Reply = protocolPut32(pui8Reply, psProfile->count);
+				pui8Reply = protocolPut32(pui8Reply, psProfile->min);
+				pui8Reply = protocolPut32(pui8Reply, psProfile->max);
+				pui8Reply = protocolPut32(pui8Reply, (uint32_t)(psProfile->total >> 32));
+				pui8Reply = protocolPut32(pui8Reply, (uint32_t)psProfile->total);
+				for(i = 0; i < PROFILE_HIST_BINS; i++)
+				{
+					pui8Reply = protocolPut16(pui8Reply, psProfile->hist[i]);
+				}
+			}
+			else
+			{
+				// load and peak load (per mille), clock (Hz),
+				// number of handlers
+				pui8Reply = protocolPut16(pui8Reply, profileLoad);
+				pui8Reply = protocolPut16(pui8Reply, profileLoadPeak);
+				pui8Reply = protocolPut32(pui8Reply, ui32SysClock);
+				*pui8Reply++ = PROFILE_ISR_NBR;
+			}
+			USBSendPacket(g_pui8ReplyBuffer, pui8Reply - g_pui8ReplyBuffer);
+
+			if(RxBufferRead(&ui32ReadIndex) != 0)
+				profileClear();
+		}
+		return 3;
+    case TRACE_CMD:
+    	// category mask, 0 stops the trace
+    	if(ui32Available < 2)
+    		return 0;
+		RxBufferRead(&ui32ReadIndex);
+		setTraceMask(RxBufferRead(&ui32ReadIndex));
+		return 2;
+    case LOG_CMD:
+    	// highest level sent, 0 stops the log
+    	if(ui32Available < 2)
+    		return 0;
+		RxBufferRead(&ui32ReadIndex);
+		setLogLevel(RxBufferRead(&ui32ReadIndex));
+		return 2;
+    case METRICS_CMD:
+    	if(!metricsSend(METRICS_CMD))
+    		g_ui8CmdStatus = ACK_NO_ROOM;
+    	return 1;
+    case PING_CMD:
+    	// host time stamp (8 bytes), echoed with the time (ms) and the
+    	// cycle counter at reception and at execution
+    	if(ui32Available < 9)
+    		return 0;
+		{
+			uint8_t *pui8Reply = g_pui8ReplyBuffer;
+			uint32_t ui32ExecCycles = DWT_CYCCNT_R;
+
+			RxBufferRead(&ui32ReadIndex);
+			*pui8Reply++ = PING_CMD;
+			for(i = 0; i < 8; i++)
+				*pui8Reply++ = RxBufferRead(&ui32ReadIndex);
+			pui8Reply = protocolPut32(pui8Reply, milli_second);
+			pui8Reply = protocolPut32(pui8Reply, commandRxCycles);
+			pui8Reply = protocolPut32(pui8Reply, ui32ExecCycles);
+			pui8Reply = protocolPut32(pui8Reply, ui32SysClock);
+			USBSendPacket(g_pui8ReplyBuffer, pui8Reply - g_pui8ReplyBuffer);
+		}
+		return 9;
+    case LATENCY_CMD:
+    	// subsystem, clear after read
+    	if(ui32Available < 3)
+    		return 0;
+		RxBufferRead(&ui32ReadIndex);
+		{
+			uint8_t *pui8Reply = g_pui8ReplyBuffer;
+			uint8_t ui8Channel = RxBufferRead(&ui32ReadIndex);
+			struct latency_stats *psLatency;
+
+			*pui8Reply++ = LATENCY_CMD;
+			*pui8Reply++ = ui8Channel;
+			if(ui8Channel < LATENCY_CHANNEL_NBR)
+			{
+				// count, min, max, total (64-bit) microseconds, then
+				// the log2 histogram
+				psLatency = &latencyStats[ui8Channel];
+				pui8Reply = protocolPut32(pui8Reply, psLatency->count);
+				pui8Reply = protocolPut32(pui8Reply, psLatency->min);
+				pui8Reply = protocolPut32(pui8Reply, psLatency->max);
+				pui8Reply = protocolPut32(pui8Reply, (uint32_t)(psLatency->total >> 32));
+				pui8Reply = protocolPut32(pui8Reply, (uint32_t)psLatency->total);
+				for(i = 0; i < LATENCY_HIST_BINS; i++)
+				{
+					pui8Reply = protocolPut16(pui8Reply, psLatency->hist[i]);
+				}
+			}
+			USBSendPacket(g_pui8ReplyBuffer, pui8Reply - g_pui8ReplyBuffer);
+
+			if((RxBufferRead(&ui32ReadIndex) != 0) &&
+			   (ui8Channel < LATENCY_CHANNEL_NBR))
+				latencyClear(ui8Channel);
+		}
+		return 3;
+#ifdef BENCHMARK
+    case BENCH_CMD:
+    	// benchmark, param, iterations (2 bytes), the reply comes
+    	// from the main loop
+    	if(ui32Available < 5)
+    		return 0;
+		RxBufferRead(&ui32ReadIndex);
+		{
+			uint8_t ui8Bench = RxBufferRead(&ui32ReadIndex);
+			uint8_t ui8Param = RxBufferRead(&ui32ReadIndex);
+			uint32_t ui32Iterations = RxBufferRead(&ui32ReadIndex) << 8;
+
+			ui32Iterations |= RxBufferRead(&ui32ReadIndex);
+			benchStart(BENCH_CMD, ui8Bench, ui8Param, ui32Iterations);
+		}
+		return 5;
+#endif
+
+    case EVENT_CMD:
+    	// event mask, 0 stops the events
+    	if(ui32Available < 2)
+    		return 0;
+		RxBufferRead(&ui32ReadIndex);
+		setEventMask(RxBufferRead(&ui32ReadIndex));
+		return 2;
+    case TIME_CMD:
+    	// host time stamp (8 bytes), echoed with the device time sampled
+    	// together with the USB frame number shared by the boards of a bus
+    	if(ui32Available < 9)
+    		return 0;
+		{
+			uint8_t *pui8Reply = g_pui8ReplyBuffer;
+			uint32_t ui32Phase = DWT_CYCCNT_R - latencyTickCycles;
+			uint32_t ui32Frame = USBFrameNumberGet(USB0_BASE);
+			uint32_t ui32Time = milli_second;
+
+			RxBufferRead(&ui32ReadIndex);
+			*pui8Reply++ = TIME_CMD;
+			for(i = 0; i < 8; i++)
+				*pui8Reply++ = RxBufferRead(&ui32ReadIndex);
+			// time (ms), cycles since that tick, frame number, clock (Hz)
+			pui8Reply = protocolPut32(pui8Reply, ui32Time);
+			pui8Reply = protocolPut32(pui8Reply, ui32Phase);
+			pui8Reply = protocolPut16(pui8Reply, ui32Frame);
+			pui8Reply = protocolPut32(pui8Reply, ui32SysClock);
+			USBSendPacket(g_pui8ReplyBuffer, pui8Reply - g_pui8ReplyBuffer);
+		}
+		return 9;
+    case AT_CMD:
+    	// execution time (ms), length, then the commands to execute;
+    	// a length of 0 drops the commands waiting
+    	if(ui32Available < 6)
+    		return 0;
+		{
+			uint8_t pui8Cmd[SCHED_CMD_MAX];
+			uint32_t ui32Time;
+			uint32_t ui32Size = RxBufferPeek(ui32ReadIndex, 5);
+
+			// Too long to be kept, the commands are skipped with it
+			if(ui32Size > SCHED_CMD_MAX)
+				return CommandRefuse(6 + ui32Size);
+			if(ui32Available < 6 + ui32Size)
+				return 0;
+			RxBufferRead(&ui32ReadIndex);
+			ui32Time = RxBufferRead32(&ui32ReadIndex);
+			RxBufferRead(&ui32ReadIndex);
+			if(ui32Size == 0)
+			{
+				schedFlush();
+				return 6;
+			}
+			for(i = 0; i < ui32Size; i++)
+				pui8Cmd[i] = RxBufferRead(&ui32ReadIndex);
+			if(!schedAdd(ui32Time, pui8Cmd, ui32Size))
+				g_ui8CmdStatus = ACK_REFUSED;
+			return 6 + ui32Size;
+		}
+    case SEQ_CMD:
+    	// sequence number of the next command
+    	if(ui32Available < 2)
+    		return 0;
+		RxBufferRead(&ui32ReadIndex);
+		g_ui8CmdSeq = RxBufferRead(&ui32ReadIndex);
+		g_bCmdSequenced = true;
+		return 2;
+    default:
+    	metricsParseErrors++;
+    	g_ui8CmdStatus = ACK_UNKNOWN;
+    	break;
+    }
+
+    return 5;
+}
+
+//*****************************************************************************
+//
+// Acknowledges the sequenced commands up to the last one executed, with
+// the space the host may fill: the free bytes of the receive ring and the
+// free keyframe nodes.
+//
+//*****************************************************************************
+static void
+CommandAck(uint8_t ui8Status, uint32_t ui32RxFree)
+{
+    uint8_t pui8Ack[7];
+    uint8_t *pui8Msg = pui8Ack;
+
+    *pui8Msg++ = ACK_MSG;
+    *pui8Msg++ = g_ui8CmdSeq;
+    *pui8Msg++ = ui8Status;
+    pui8Msg = protocolPut16(pui8Msg, ui32RxFree);
+    pui8Msg = protocolPut16(pui8Msg, LIST_NODE_MAX - listNodesUsed);
+    USBSendPacket(pui8Ack, pui8Msg - pui8Ack);
+    g_bAckDue = false;
+}
+
+//*****************************************************************************
+//
+// Processes the commands of the received data.  A transfer may carry
+// several commands back to back: they are all executed, a command cut at
+// the end of the data is kept for the next call.  The commands preceded
+// by SEQ_CMD are acknowledged with ACK_MSG.
+//
+// \param pui8Ring is the receive ring of the transport.
+// \param ui32RingSize is the size of the ring.
+// \param ui32ReadIndex is the index of the first byte of the first command.
+// \param ui32Available is the number of bytes received from that index on.
+//
+// \return Returns the number of bytes used, 0 to wait for more data.
+//
+//*****************************************************************************
+uint32_t
+CommandProcess(const uint8_t *pui8Ring, uint32_t ui32RingSize,
+               uint32_t ui32ReadIndex, uint32_t ui32Available)
+{
+    uint8_t ui8Opcode;
+    uint32_t ui32Count;
+    uint32_t ui32Used = 0;
+
+    g_pui8CmdRing = pui8Ring;
+    g_ui32CmdRingSize = ui32RingSize;
+
+    while(ui32Used < ui32Available)
+    {
+        //
+        // Skip the rest of a refused command first.
+        //
+        if(g_ui32CmdDiscard != 0)
+        {
+            ui32Count = ui32Available - ui32Used;
+            if(ui32Count > g_ui32CmdDiscard)
+                ui32Count = g_ui32CmdDiscard;
+            g_ui32CmdDiscard -= ui32Count;
+            ui32Used += ui32Count;
+            ui32ReadIndex = (ui32ReadIndex + ui32Count) % ui32RingSize;
+            continue;
+        }
+
+        ui8Opcode = pui8Ring[ui32ReadIndex];
+        TRACE(TRACE_COMMAND, ui8Opcode, ui32Available - ui32Used);
+
+        g_ui8CmdStatus = ACK_OK;
+        ui32Count = CommandExecute(ui32ReadIndex, ui32Available - ui32Used);
+        if(ui32Count == 0)
+            break;
+
+        //
+        // Unknown opcodes skip a fixed length, never beyond the data.  The
+        // rest of a refused command is skipped from the next transfers.
+        //
+        if(ui32Count > ui32Available - ui32Used)
+            ui32Count = ui32Available - ui32Used;
+        g_ui32CmdDiscard = (g_ui32CmdDiscard > ui32Count) ?
+                           g_ui32CmdDiscard - ui32Count : 0;
+
+        //
+        // A command waiting for the rest of its bytes is counted once.
+        //
+        metricsCommand(ui8Opcode);
+        ui32Used += ui32Count;
+        ui32ReadIndex = (ui32ReadIndex + ui32Count) % ui32RingSize;
+
+        //
+        // A failed command is reported at once, the others together.
+        //
+        if(g_bCmdSequenced && (ui8Opcode != SEQ_CMD))
+        {
+            g_bCmdSequenced = false;
+            if(g_ui8CmdStatus != ACK_OK)
+                CommandAck(g_ui8CmdStatus,
+                           ui32RingSize - (ui32Available - ui32Used));
+            else
+                g_bAckDue = true;
+        }
+    }
+    if(g_bAckDue)
+        CommandAck(ACK_OK, ui32RingSize - (ui32Available - ui32Used));
+    return(ui32Used);
+}
+
+//*****************************************************************************
+//
+// Executes commands that waited for their execution time, from the
+// millisecond tick.  Their latency is counted from the start of that
+// tick and they do not take the sequence number of a command still
+// being received.
+//
+//*****************************************************************************
+void
+CommandDeferred(const uint8_t *pui8Cmd, uint32_t ui32Size)
+{
+    bool bSequenced = g_bCmdSequenced;
+    uint32_t ui32Discard = g_ui32CmdDiscard;
+
+    g_bCmdSequenced = false;
+    g_ui32CmdDiscard = 0;
+    commandRxCycles = latencyTickCycles;
+    if(CommandProcess(pui8Cmd, ui32Size, 0, ui32Size) != ui32Size)
+        metricsParseErrors++;		// last command cut
+    g_bCmdSequenced = bSequenced;
+    g_ui32CmdDiscard = ui32Discard;
+}
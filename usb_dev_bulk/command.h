@@ -0,0 +1,36 @@
+/*
+ * command.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+
+#ifndef COMMAND_H_
+#define COMMAND_H_
+
+//*****************************************************************************
+//
+// Acknowledgement of the commands preceded by SEQ_CMD:
+//   ACK_MSG, sequence number, status, free bytes of the receive ring
+//   (2 bytes), free keyframe nodes (2 bytes).
+// It is cumulative: every sequenced command up to that number has been
+// executed.  A command that fails is acknowledged at once with its
+// status, the others once per transfer.
+//
+//*****************************************************************************
+#define ACK_MSG					0x83
+#define ACK_OK					0x00
+#define ACK_UNKNOWN				0x01	// opcode not known, bytes skipped
+#define ACK_REFUSED				0x02	// store full or argument out of range,
+												// the command is skipped
+#define ACK_NO_ROOM				0x03	// reply not sent, the transmit ring
+												// is full; send the command again
+
+// Cycle counter when the transport got the data, set before CommandProcess()
+extern uint32_t commandRxCycles;
+
+uint32_t CommandProcess(const uint8_t *pui8Ring, uint32_t ui32RingSize,
+                        uint32_t ui32ReadIndex, uint32_t ui32Available);
+void CommandDeferred(const uint8_t *pui8Cmd, uint32_t ui32Size);
+
+#endif /* COMMAND_H_ */
@@ -0,0 +1,318 @@
+/*
+ * current_sense.c
+ *
+ * Purpose:  Continuous motor and servo current sampling with the ADC and
+ *           the uDMA, and over-current foldback from the ADC digital
+ *           comparators.
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_ints.h"
+#include "inc/hw_adc.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/gpio.h"
+#include "driverlib/adc.h"
+#include "driverlib/udma.h"
+#include "driverlib/timer.h"
+#include "driverlib/pwm.h"
+#include "driverlib/interrupt.h"
+
+#include "timer_handler.h"
+#include "servo.h"
+#include "dc_motor.h"
+#include "current_sense.h"
+#include "profile.h"
+#include "log.h"
+
+
+extern uint32_t ui32SysClock;
+
+//*****************************************************************************
+//
+// uDMA control table, it has to be aligned on 1024 bytes.
+//
+//*****************************************************************************
+#pragma DATA_ALIGN(dmaControlTable, 1024)
+static uint8_t dmaControlTable[1024];
+
+//*****************************************************************************
+//
+// Ping-pong sample buffers, one sample of every channel per sequence.
+//
+//*****************************************************************************
+#define CURRENT_BUFFER_SIZE		(CURRENT_BLOCK_SIZE * CURRENT_CHANNEL_NBR)
+static uint16_t sampleBuffer[2][CURRENT_BUFFER_SIZE];
+
+uint16_t currentMilliAmp[CURRENT_CHANNEL_NBR];
+uint16_t currentTrips[CURRENT_CHANNEL_NBR];
+
+static const uint32_t fullScale[CURRENT_CHANNEL_NBR] = {CURRENT_DC_FULL_SCALE_MA,
+														CURRENT_DC_FULL_SCALE_MA,
+														CURRENT_SERVO_FULL_SCALE_MA};
+static const uint32_t channelMotor[CURRENT_CHANNEL_NBR] = {DC_LEFT, DC_RIGHT, DC_MOTOR_NBR};
+static uint32_t lastTrip[CURRENT_CHANNEL_NBR];
+static bool servoCut = false;
+
+
+//*****************************************************************************
+//
+// Converts a current to an ADC code of a channel.
+//
+//*****************************************************************************
+static uint32_t milliAmpToCode(uint32_t channel, uint32_t milliAmp)
+{
+	uint32_t code = (milliAmp * 4095) / fullScale[channel];
+
+	return (code > 4095) ? 4095 : code;
+}
+
+
+//*****************************************************************************
+//
+// Sets the comparator of a channel: the high band starts at the limit, the
+// low band below CURRENT_HYSTERESIS percent of it.
+//
+//*****************************************************************************
+static void setComparator(uint32_t channel, uint32_t milliAmp)
+{
+	uint32_t high = milliAmpToCode(channel, milliAmp);
+
+	ADCComparatorRegionSet(ADC0_BASE, channel, (high * CURRENT_HYSTERESIS) / 100, high);
+	ADCComparatorReset(ADC0_BASE, channel, true, true);
+}
+
+
+//*****************************************************************************
+//
+// Starts a ping-pong half again once the uDMA has filled it.
+//
+//*****************************************************************************
+static void armBuffer(uint32_t select, uint16_t *buffer_p)
+{
+	uDMAChannelTransferSet(UDMA_CH14_ADC0_0 | select, UDMA_MODE_PINGPONG,
+						   (void *)(ADC0_BASE + ADC_O_SSFIFO0), buffer_p,
+						   CURRENT_BUFFER_SIZE);
+}
+
+
+//*****************************************************************************
+//
+// Averages a full buffer into currentMilliAmp.
+//
+//*****************************************************************************
+static void averageBuffer(const uint16_t *buffer_p)
+{
+	uint32_t sum[CURRENT_CHANNEL_NBR] = {0, 0, 0};
+	int i;
+
+	for(i = 0; i < CURRENT_BUFFER_SIZE; i += CURRENT_CHANNEL_NBR)
+	{
+		sum[CURRENT_DC_LEFT] += buffer_p[i + CURRENT_DC_LEFT];
+		sum[CURRENT_DC_RIGHT] += buffer_p[i + CURRENT_DC_RIGHT];
+		sum[CURRENT_SERVO] += buffer_p[i + CURRENT_SERVO];
+	}
+	for(i = 0; i < CURRENT_CHANNEL_NBR; i++)
+		currentMilliAmp[i] = (sum[i] / CURRENT_BLOCK_SIZE) * fullScale[i] / 4095;
+}
+
+
+//*****************************************************************************
+//
+// Over-current on a channel: halve the duty of a DC motor right away, or
+// switch the servo outputs off.
+//
+//*****************************************************************************
+static void foldback(uint32_t channel)
+{
+	uint32_t motor = channelMotor[channel];
+
+	currentTrips[channel]++;
+	lastTrip[channel] = milli_second;
+	LOG_WARN(LOG_OVER_CURRENT, channel, currentTrips[channel]);
+
+	if(motor < DC_MOTOR_NBR)
+	{
+		dcSpeedLimit[motor] = ((dcMotorSpeed[motor] < 0) ? -dcMotorSpeed[motor] : dcMotorSpeed[motor]) / 2;
+		setDCMotorSpeed(motor, dcMotorSpeed[motor]);
+	}
+	else
+	{
+		PWMOutputState(PWM0_BASE, PWM_ARM_BITS, false);
+		servoCut = true;
+	}
+}
+
+
+//*****************************************************************************
+//
+// Initialises the ADC sequence, the comparators, the uDMA channel and the
+// trigger timer.
+//
+//*****************************************************************************
+void currentSenseInit(void)
+{
+	int i;
+
+	SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOE);
+	SysCtlPeripheralEnable(SYSCTL_PERIPH_ADC0);
+	SysCtlPeripheralEnable(SYSCTL_PERIPH_UDMA);
+	SysCtlPeripheralEnable(SYSCTL_PERIPH_TIMER3);
+
+	GPIOPinTypeADC(GPIO_PORTE_BASE, GPIO_PIN_1 | GPIO_PIN_2 | GPIO_PIN_3);
+
+	//
+	// 32 MHz ADC clock from the 480 MHz PLL, 4 samples averaged in hardware.
+	//
+	ADCClockConfigSet(ADC0_BASE, ADC_CLOCK_SRC_PLL | ADC_CLOCK_RATE_FULL, 15);
+	ADCHardwareOversampleConfigure(ADC0_BASE, 4);
+
+	//
+	// Every channel is converted twice: once into the FIFO for the uDMA,
+	// once into its comparator, a step sent to a comparator does not reach
+	// the FIFO.
+	//
+	ADCSequenceConfigure(ADC0_BASE, 0, ADC_TRIGGER_TIMER, 0);
+	ADCSequenceStepConfigure(ADC0_BASE, 0, 0, ADC_CTL_CH0);
+	ADCSequenceStepConfigure(ADC0_BASE, 0, 1, ADC_CTL_CH0 | ADC_CTL_CMP0);
+	ADCSequenceStepConfigure(ADC0_BASE, 0, 2, ADC_CTL_CH1);
+	ADCSequenceStepConfigure(ADC0_BASE, 0, 3, ADC_CTL_CH1 | ADC_CTL_CMP1);
+	ADCSequenceStepConfigure(ADC0_BASE, 0, 4, ADC_CTL_CH2);
+	ADCSequenceStepConfigure(ADC0_BASE, 0, 5, ADC_CTL_CH2 | ADC_CTL_CMP2 | ADC_CTL_IE | ADC_CTL_END);
+
+	for(i = 0; i < CURRENT_CHANNEL_NBR; i++)
+	{
+		ADCComparatorConfigure(ADC0_BASE, i, ADC_COMP_TRIG_NONE | ADC_COMP_INT_HIGH_ONCE);
+	}
+	setCurrentLimit(CURRENT_DC_LIMIT_MA, CURRENT_SERVO_LIMIT_MA);
+
+	ADCSequenceEnable(ADC0_BASE, 0);
+	ADCSequenceDMAEnable(ADC0_BASE, 0);
+
+	//
+	// uDMA: FIFO to the ping-pong buffers, 16-bit samples.
+	//
+	uDMAEnable();
+	uDMAControlBaseSet(dmaControlTable);
+	uDMAChannelAssign(UDMA_CH14_ADC0_0);
+	uDMAChannelAttributeDisable(UDMA_CH14_ADC0_0, UDMA_ATTR_ALL);
+	uDMAChannelAttributeEnable(UDMA_CH14_ADC0_0, UDMA_ATTR_USEBURST);
+	uDMAChannelControlSet(UDMA_CH14_ADC0_0 | UDMA_PRI_SELECT, UDMA_SIZE_16 |
+						  UDMA_SRC_INC_NONE | UDMA_DST_INC_16 | UDMA_ARB_1);
+	uDMAChannelControlSet(UDMA_CH14_ADC0_0 | UDMA_ALT_SELECT, UDMA_SIZE_16 |
+						  UDMA_SRC_INC_NONE | UDMA_DST_INC_16 | UDMA_ARB_1);
+	armBuffer(UDMA_PRI_SELECT, sampleBuffer[0]);
+	armBuffer(UDMA_ALT_SELECT, sampleBuffer[1]);
+	uDMAChannelEnable(UDMA_CH14_ADC0_0);
+
+	//
+	// Only the buffer completion and the comparators interrupt the CPU.
+	//
+	ADCIntEnableEx(ADC0_BASE, ADC_INT_DMA_SS0 | ADC_INT_DCON_SS0);
+	ADCComparatorIntEnable(ADC0_BASE, 0);
+	IntEnable(INT_ADC0SS0);
+
+	//
+	// Timer3 triggers a sequence CURRENT_SAMPLE_RATE times per second.
+	//
+	TimerConfigure(TIMER3_BASE, TIMER_CFG_PERIODIC);
+	TimerLoadSet(TIMER3_BASE, TIMER_A, ui32SysClock / CURRENT_SAMPLE_RATE);
+	TimerControlTrigger(TIMER3_BASE, TIMER_A, true);
+	TimerADCEventSet(TIMER3_BASE, TIMER_ADC_TIMEOUT_A);
+	TimerEnable(TIMER3_BASE, TIMER_A);
+}
+
+
+//*****************************************************************************
+//
+// Sets the over-current limits in mA.
+//
+//*****************************************************************************
+void setCurrentLimit(uint32_t dc_limit, uint32_t servo_limit)
+{
+	setComparator(CURRENT_DC_LEFT, dc_limit);
+	setComparator(CURRENT_DC_RIGHT, dc_limit);
+	setComparator(CURRENT_SERVO, servo_limit);
+}
+
+
+//*****************************************************************************
+//
+// Lets the DC motors recover their duty and the servos their outputs once
+// the over-current is over, called every millisecond.
+//
+//*****************************************************************************
+void currentSenseUpdate(uint32_t ms_time)
+{
+	int i;
+	uint32_t motor;
+
+	for(i = 0; i < CURRENT_CHANNEL_NBR; i++)
+	{
+		motor = channelMotor[i];
+		if(motor < DC_MOTOR_NBR)
+		{
+			if((dcSpeedLimit[motor] < DC_SPEED_MAX) &&
+			   ((ms_time - lastTrip[i]) > CURRENT_RECOVERY_DELAY_MS))
+			{
+				dcSpeedLimit[motor] += DC_SPEED_MAX / CURRENT_RECOVERY_MS;
+				if(dcSpeedLimit[motor] > DC_SPEED_MAX)
+					dcSpeedLimit[motor] = DC_SPEED_MAX;
+				// The speed loop applies the set point by itself
+				if(!dcClosedLoop)
+					setDCMotorSpeed(motor, dcSpeedSetpoint[motor]);
+			}
+		}
+		else if(servoCut && ((ms_time - lastTrip[i]) > CURRENT_SERVO_HOLDOFF_MS))
+		{
+			servoCut = false;
+			PWMOutputState(PWM0_BASE, PWM_ARM_BITS, true);
+		}
+	}
+}
+
+
+//*****************************************************************************
+//
+// ADC0 sequence 0 interrupt: a comparator tripped or a buffer is full.
+//
+//*****************************************************************************
+void CurrentSenseIntHandler(void)
+{
+	uint32_t status;
+	uint32_t comparators;
+	int i;
+	PROFILE_ISR_ENTER();
+
+	status = ADCIntStatusEx(ADC0_BASE, true);
+	ADCIntClearEx(ADC0_BASE, status);
+
+	if(status & ADC_INT_DCON_SS0)
+	{
+		comparators = ADCComparatorIntStatus(ADC0_BASE);
+		ADCComparatorIntClear(ADC0_BASE, comparators);
+		for(i = 0; i < CURRENT_CHANNEL_NBR; i++)
+		{
+			if(comparators & (1 << i))
+				foldback(i);
+		}
+	}
+
+	if(status & ADC_INT_DMA_SS0)
+	{
+		if(uDMAChannelModeGet(UDMA_CH14_ADC0_0 | UDMA_PRI_SELECT) == UDMA_MODE_STOP)
+		{
+			averageBuffer(sampleBuffer[0]);
+			armBuffer(UDMA_PRI_SELECT, sampleBuffer[0]);
+		}
+		if(uDMAChannelModeGet(UDMA_CH14_ADC0_0 | UDMA_ALT_SELECT) == UDMA_MODE_STOP)
+		{
+			averageBuffer(sampleBuffer[1]);
+			armBuffer(UDMA_ALT_SELECT, sampleBuffer[1]);
+		}
+	}
+	PROFILE_ISR_EXIT(PROFILE_ADC0);
+}
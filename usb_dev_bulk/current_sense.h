@@ -0,0 +1,60 @@
+/*
+ * current_sense.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+
+#ifndef CURRENT_SENSE_H_
+#define CURRENT_SENSE_H_
+
+//*****************************************************************************
+//
+// Current channels: left and right DC motor and servo supply, on AIN0-2
+// (PE3, PE2, PE1).  The full scale values depend on the shunts and sense
+// amplifiers.
+//
+//*****************************************************************************
+#define CURRENT_DC_LEFT				0
+#define CURRENT_DC_RIGHT			1
+#define CURRENT_SERVO				2
+#define CURRENT_CHANNEL_NBR			3
+
+#define CURRENT_DC_FULL_SCALE_MA	5000		// mA at ADC code 4095
+#define CURRENT_SERVO_FULL_SCALE_MA	10000
+
+//*****************************************************************************
+//
+// Sampling: the ADC is triggered by Timer3 and the samples are moved by
+// the uDMA into two ping-pong buffers.  The CPU only sees the completion
+// of a buffer and the over-current comparators.
+//
+//*****************************************************************************
+#define CURRENT_SAMPLE_RATE			20000		// sequences per second
+#define CURRENT_BLOCK_SIZE			128			// sequences per buffer
+
+//*****************************************************************************
+//
+// Over-current foldback.  A DC motor over its limit has its duty halved at
+// once, then recovers after CURRENT_RECOVERY_DELAY_MS over
+// CURRENT_RECOVERY_MS.  The servos are switched off for
+// CURRENT_SERVO_HOLDOFF_MS, a position pulse cannot be reduced.
+//
+//*****************************************************************************
+#define CURRENT_DC_LIMIT_MA			2500
+#define CURRENT_SERVO_LIMIT_MA		6000
+#define CURRENT_HYSTERESIS			80			// percent of the limit to re-arm
+#define CURRENT_RECOVERY_DELAY_MS	100
+#define CURRENT_RECOVERY_MS			500
+#define CURRENT_SERVO_HOLDOFF_MS	500
+
+extern uint16_t currentMilliAmp[CURRENT_CHANNEL_NBR];		// average of the last buffer
+extern uint16_t currentTrips[CURRENT_CHANNEL_NBR];			// foldbacks since start-up
+
+
+void currentSenseInit(void);
+void setCurrentLimit(uint32_t dc_limit, uint32_t servo_limit);
+void currentSenseUpdate(uint32_t ms_time);
+void CurrentSenseIntHandler(void);
+
+#endif /* CURRENT_SENSE_H_ */
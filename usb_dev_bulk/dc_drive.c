@@ -0,0 +1,241 @@
+/*
+ * dc_drive.c
+ *
+ * Purpose:  Differential drive on top of the two DC motors: (v, omega)
+ *           velocity commands, odometry from the wheel encoders and a
+ *           turn - drive - turn controller reaching a relative pose.
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "dc_motor.h"
+#include "dc_drive.h"
+#include "event.h"
+
+
+#define PI							3.14159265f
+
+
+//*****************************************************************************
+//
+// Odometry and controller state.
+//
+//*****************************************************************************
+struct drive_pose drivePose;
+float driveVelocity;
+float driveOmega;
+uint8_t driveState = DRIVE_IDLE;
+
+static struct drive_pose driveTarget;
+static float driveVmax;
+static int32_t lastPosition[DC_MOTOR_NBR];
+
+
+//*****************************************************************************
+//
+// Brings an angle back to -pi .. pi.
+//
+//*****************************************************************************
+static float wrapAngle(float angle)
+{
+	while(angle > PI)
+		angle -= 2.0f * PI;
+	while(angle < -PI)
+		angle += 2.0f * PI;
+	return angle;
+}
+
+
+//*****************************************************************************
+//
+// Sends a velocity in mm/s and rad/s to the wheels, as DC speed set points.
+//
+//*****************************************************************************
+static void driveWheels(float v, float omega)
+{
+	float wheel[DC_MOTOR_NBR];
+	int i;
+
+	wheel[DC_LEFT] = v - omega * (DRIVE_TRACK_MM / 2.0f);
+	wheel[DC_RIGHT] = v + omega * (DRIVE_TRACK_MM / 2.0f);
+
+	for(i = 0; i < DC_MOTOR_NBR; i++)
+	{
+		// mm/s -> counts/s -> DC_SPEED_MAX at dcVelocityMax
+		setDCMotorSetpoint(i, (int32_t)(wheel[i] * (DRIVE_COUNTS_PER_M / 1000.0f) *
+										DC_SPEED_MAX / dcVelocityMax));
+	}
+}
+
+
+//*****************************************************************************
+//
+// Turns towards a heading at a speed proportional to the error.
+//
+//*****************************************************************************
+static float turnSpeed(float error)
+{
+	float omega = DRIVE_KW * error;
+
+	if(omega > DRIVE_OMEGA_MAX)
+		omega = DRIVE_OMEGA_MAX;
+	else if(omega < -DRIVE_OMEGA_MAX)
+		omega = -DRIVE_OMEGA_MAX;
+	else if(omega > 0.0f && omega < DRIVE_OMEGA_MIN)
+		omega = DRIVE_OMEGA_MIN;
+	else if(omega < 0.0f && omega > -DRIVE_OMEGA_MIN)
+		omega = -DRIVE_OMEGA_MIN;
+	return omega;
+}
+
+
+//*****************************************************************************
+//
+// Starts the odometry from the present wheel positions.
+//
+//*****************************************************************************
+void driveInit(void)
+{
+	lastPosition[DC_LEFT] = dcWheelPosition[DC_LEFT];
+	lastPosition[DC_RIGHT] = dcWheelPosition[DC_RIGHT];
+	driveResetOdometry();
+}
+
+
+//*****************************************************************************
+//
+// Sets the pose back to the origin.
+//
+//*****************************************************************************
+void driveResetOdometry(void)
+{
+	drivePose.x = 0.0f;
+	drivePose.y = 0.0f;
+	drivePose.theta = 0.0f;
+}
+
+
+//*****************************************************************************
+//
+// Drives at a linear velocity in mm/s and an angular velocity in mrad/s.
+//
+//*****************************************************************************
+void setDriveVelocity(int32_t v, int32_t omega)
+{
+	driveState = DRIVE_IDLE;
+	driveWheels((float)v, omega / 1000.0f);
+}
+
+
+//*****************************************************************************
+//
+// Drives to a pose given in mm and mrad relative to the present pose, at
+// most at vmax mm/s.
+//
+//*****************************************************************************
+void setDriveTarget(int32_t dx, int32_t dy, int32_t dtheta, int32_t vmax)
+{
+	float c = cosf(drivePose.theta);
+	float s = sinf(drivePose.theta);
+
+	driveTarget.x = drivePose.x + dx * c - dy * s;
+	driveTarget.y = drivePose.y + dx * s + dy * c;
+	driveTarget.theta = wrapAngle(drivePose.theta + dtheta / 1000.0f);
+	driveVmax = (float)vmax;
+
+	if((dx * dx + dy * dy) <= DRIVE_POS_TOLERANCE_MM * DRIVE_POS_TOLERANCE_MM)
+		driveState = DRIVE_FINAL_TURN;
+	else
+		driveState = DRIVE_TURN_TO_POINT;
+}
+
+
+//*****************************************************************************
+//
+// Drops the pose target, the wheels keep their last set point.
+//
+//*****************************************************************************
+void driveCancel(void)
+{
+	driveState = DRIVE_IDLE;
+}
+
+
+//*****************************************************************************
+//
+// Integrates the odometry and runs the pose controller, called every
+// millisecond after the speed loops.
+//
+//*****************************************************************************
+void driveUpdate(uint32_t ms_time)
+{
+	float left, right;
+	float ds, dtheta;
+	float dx, dy, distance, error;
+
+	if((ms_time % DC_PID_PERIOD_MS) != 0)
+		return;
+
+	//
+	// Odometry: wheel travel in mm since the last period.
+	//
+	left = (dcWheelPosition[DC_LEFT] - lastPosition[DC_LEFT]) * (1000.0f / DRIVE_COUNTS_PER_M);
+	right = (dcWheelPosition[DC_RIGHT] - lastPosition[DC_RIGHT]) * (1000.0f / DRIVE_COUNTS_PER_M);
+	lastPosition[DC_LEFT] = dcWheelPosition[DC_LEFT];
+	lastPosition[DC_RIGHT] = dcWheelPosition[DC_RIGHT];
+
+	ds = (left + right) / 2.0f;
+	dtheta = (right - left) / DRIVE_TRACK_MM;
+	drivePose.x += ds * cosf(drivePose.theta + dtheta / 2.0f);
+	drivePose.y += ds * sinf(drivePose.theta + dtheta / 2.0f);
+	drivePose.theta = wrapAngle(drivePose.theta + dtheta);
+	driveVelocity = ds * (1000.0f / DC_PID_PERIOD_MS);
+	driveOmega = dtheta * (1000.0f / DC_PID_PERIOD_MS);
+
+	if(driveState == DRIVE_IDLE)
+		return;
+
+	//
+	// Turn - drive - turn towards the target.
+	//
+	dx = driveTarget.x - drivePose.x;
+	dy = driveTarget.y - drivePose.y;
+	distance = sqrtf(dx * dx + dy * dy);
+	error = wrapAngle(atan2f(dy, dx) - drivePose.theta);
+
+	if(driveState != DRIVE_FINAL_TURN &&
+	   (distance < DRIVE_POS_TOLERANCE_MM ||
+	    (driveState == DRIVE_STRAIGHT && fabsf(error) > PI / 2.0f)))	// passed the target
+		driveState = DRIVE_FINAL_TURN;
+
+	switch(driveState)
+	{
+	case DRIVE_TURN_TO_POINT:
+		if(fabsf(error) < DRIVE_HEADING_TOLERANCE)
+		{
+			driveState = DRIVE_STRAIGHT;
+		}
+		driveWheels(0.0f, turnSpeed(error));
+		break;
+	case DRIVE_STRAIGHT:
+		driveWheels(fminf(driveVmax, DRIVE_KV * distance), DRIVE_KW * error);
+		break;
+	case DRIVE_FINAL_TURN:
+		error = wrapAngle(driveTarget.theta - drivePose.theta);
+		if(fabsf(error) < DRIVE_HEADING_TOLERANCE)
+		{
+			driveState = DRIVE_IDLE;
+			driveWheels(0.0f, 0.0f);
+			EVENT(EVENT_DRIVE_DONE, 0, 0);
+		}
+		else
+			driveWheels(0.0f, turnSpeed(error));
+		break;
+	default:
+		break;
+	}
+}
@@ -0,0 +1,55 @@
+/*
+ * dc_drive.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+
+#ifndef DC_DRIVE_H_
+#define DC_DRIVE_H_
+
+//*****************************************************************************
+//
+// Drive geometry, to be measured on the robot.
+//
+//*****************************************************************************
+#define DRIVE_TRACK_MM				200			// distance between the wheels
+#define DRIVE_COUNTS_PER_M			10000		// encoder counts per metre of wheel travel
+
+//*****************************************************************************
+//
+// Drive to pose controller.
+//
+//*****************************************************************************
+#define DRIVE_POS_TOLERANCE_MM		10			// target reached
+#define DRIVE_HEADING_TOLERANCE		0.03f		// rad
+#define DRIVE_KV					2.0f		// mm/s per mm of distance
+#define DRIVE_KW					3.0f		// rad/s per rad of heading error
+#define DRIVE_OMEGA_MAX				2.0f		// rad/s
+#define DRIVE_OMEGA_MIN				0.2f		// rad/s, below it the robot does not turn
+
+#define DRIVE_IDLE					0
+#define DRIVE_TURN_TO_POINT			1
+#define DRIVE_STRAIGHT				2
+#define DRIVE_FINAL_TURN			3
+
+struct drive_pose {
+   float x;					// mm
+   float y;					// mm
+   float theta;				// rad, -pi .. pi
+};
+
+extern struct drive_pose drivePose;			// odometry since the last reset
+extern float driveVelocity;					// measured, mm/s
+extern float driveOmega;					// measured, rad/s
+extern uint8_t driveState;
+
+
+void driveInit(void);
+void driveResetOdometry(void);
+void setDriveVelocity(int32_t v, int32_t omega);
+void setDriveTarget(int32_t dx, int32_t dy, int32_t dtheta, int32_t vmax);
+void driveCancel(void);
+void driveUpdate(uint32_t ms_time);
+
+#endif /* DC_DRIVE_H_ */
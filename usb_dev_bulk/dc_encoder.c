@@ -0,0 +1,115 @@
+/*
+ * dc_encoder.c
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include "inc/hw_memmap.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/pin_map.h"
+#include "driverlib/gpio.h"
+#include "driverlib/qei.h"
+
+#include "dc_motor.h"
+#include "dc_encoder.h"
+#include "profile.h"
+
+
+//*****************************************************************************
+//
+// Software quadrature decoder of the right wheel.  The table is indexed by
+// the previous and the present A/B state and gives the step, 0 for no move
+// or for a missed edge.
+//
+//*****************************************************************************
+static const int8_t quadratureStep[16] = { 0,  1, -1,  0,
+										  -1,  0,  0,  1,
+										   1,  0,  0, -1,
+										   0, -1,  1,  0};
+static volatile int32_t rightPosition = 0;
+static uint8_t rightState;
+
+
+//*****************************************************************************
+//
+// Reads the A/B state of the right encoder, A in bit 1 and B in bit 0.
+//
+//*****************************************************************************
+static uint8_t readRightState(void)
+{
+	uint8_t pins = GPIOPinRead(ENCODER_RIGHT_BASE, ENCODER_RIGHT_PIN_A | ENCODER_RIGHT_PIN_B);
+
+	return ((pins & ENCODER_RIGHT_PIN_A) ? 2 : 0) | ((pins & ENCODER_RIGHT_PIN_B) ? 1 : 0);
+}
+
+
+//*****************************************************************************
+//
+// Interrupt handler of the right encoder edges.
+//
+//*****************************************************************************
+void onRightEncoderEdge(void)
+{
+	uint8_t state;
+	PROFILE_ISR_ENTER();
+
+	GPIOIntClear(ENCODER_RIGHT_BASE, GPIOIntStatus(ENCODER_RIGHT_BASE, true));
+
+	state = readRightState();
+	rightPosition += quadratureStep[(rightState << 2) | state];
+	rightState = state;
+	PROFILE_ISR_EXIT(PROFILE_ENCODER);
+}
+
+
+//*****************************************************************************
+//
+// Initialises the QEI module of the left wheel and the edge interrupts of
+// the right wheel.
+//
+//*****************************************************************************
+void dcEncoderInit(void)
+{
+	SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOL);
+	SysCtlPeripheralEnable(SYSCTL_PERIPH_QEI0);
+
+	//
+	// Left wheel: QEI0 counts every edge of both phases.
+	//
+	GPIOPinConfigure(GPIO_PL1_PHA0);
+	GPIOPinConfigure(GPIO_PL2_PHB0);
+	GPIOPinTypeQEI(ENCODER_LEFT_BASE, ENCODER_LEFT_PINS);
+	QEIConfigure(QEI0_BASE, QEI_CONFIG_CAPTURE_A_B | QEI_CONFIG_NO_RESET |
+				 QEI_CONFIG_QUADRATURE | QEI_CONFIG_NO_SWAP, 0xFFFFFFFF);
+	QEIPositionSet(QEI0_BASE, 0);
+	QEIEnable(QEI0_BASE);
+
+	//
+	// Right wheel: both edges of both phases interrupt.
+	//
+	GPIOPinTypeGPIOInput(ENCODER_RIGHT_BASE, ENCODER_RIGHT_PIN_A | ENCODER_RIGHT_PIN_B);
+	GPIOPadConfigSet(ENCODER_RIGHT_BASE, ENCODER_RIGHT_PIN_A | ENCODER_RIGHT_PIN_B,
+					 GPIO_STRENGTH_2MA, GPIO_PIN_TYPE_STD_WPU);
+	rightPosition = 0;
+	rightState = readRightState();
+	GPIOIntTypeSet(ENCODER_RIGHT_BASE, ENCODER_RIGHT_PIN_A | ENCODER_RIGHT_PIN_B, GPIO_BOTH_EDGES);
+	GPIOIntRegister(ENCODER_RIGHT_BASE, onRightEncoderEdge);
+	GPIOIntClear(ENCODER_RIGHT_BASE, ENCODER_RIGHT_PIN_A | ENCODER_RIGHT_PIN_B);
+	GPIOIntEnable(ENCODER_RIGHT_BASE, ENCODER_RIGHT_PIN_A | ENCODER_RIGHT_PIN_B);
+}
+
+
+//*****************************************************************************
+//
+// Returns the position of a wheel in encoder counts.  The value wraps
+// around, differences between two readings stay right.
+//
+//*****************************************************************************
+int32_t dcEncoderPosition(uint32_t motor)
+{
+	if(motor == DC_LEFT)
+		return (int32_t)QEIPositionGet(QEI0_BASE);
+	return rightPosition;
+}
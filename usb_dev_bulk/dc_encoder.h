@@ -0,0 +1,30 @@
+/*
+ * dc_encoder.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+
+#ifndef DC_ENCODER_H_
+#define DC_ENCODER_H_
+
+//*****************************************************************************
+//
+// Wheel encoder inputs.  The left wheel uses the QEI0 module, the
+// TM4C1294 has a single one, so the right wheel is decoded in software
+// from GPIO edge interrupts.  Both count the four edges of every
+// quadrature cycle and count up when the wheel moves forward; swap the
+// A and B wires of a wheel that counts the other way.
+//
+//*****************************************************************************
+#define ENCODER_LEFT_BASE			GPIO_PORTL_BASE
+#define ENCODER_LEFT_PINS			(GPIO_PIN_1 | GPIO_PIN_2)		// PhA0, PhB0
+#define ENCODER_RIGHT_BASE			GPIO_PORTL_BASE
+#define ENCODER_RIGHT_PIN_A			GPIO_PIN_4
+#define ENCODER_RIGHT_PIN_B			GPIO_PIN_5
+
+
+void dcEncoderInit(void);
+int32_t dcEncoderPosition(uint32_t motor);
+
+#endif /* DC_ENCODER_H_ */
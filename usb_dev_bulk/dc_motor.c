@@ -1,108 +1,418 @@
-/*
- * dc_motor.c
- *
- *  Created on: 16 dc. 2017
- *      Author: macload1
- */
-#include <stdbool.h>
-#include <stdint.h>
-#include "inc/hw_memmap.h"
-#include "inc/hw_timer.h"
-#include "driverlib/sysctl.h"
-#include "driverlib/pin_map.h"
-#include "driverlib/gpio.h"
-#include "driverlib/timer.h"
-
-#include "dc_motor.h"
-
-
-
-//*****************************************************************************
-//
-// Global variable to hold the system clock speed.
-//
-//*****************************************************************************
-extern uint32_t ui32SysClock;
-
-
-//*****************************************************************************
-//
-// Initialises the timer PWM peripheral.
-//
-//*****************************************************************************
-void initDCMotor(void)
-{
-	/**************************************************************************
-	 *
-	 * DC Motor Control
-	 * Period: 1900 Hz <=> 526 microseconds
-	 * Pulse width range: 0 ms - 0,526 ms
-	 *
-	 *************************************************************************/
-	//
-	// The Timer1 and Timer2 peripheral must be enabled.
-	//
-	SysCtlPeripheralEnable(SYSCTL_PERIPH_TIMER1);
-	SysCtlPeripheralEnable(SYSCTL_PERIPH_TIMER2);
-
-	//
-	// GPIO port A needs to be enabled so their pins can be used.
-	//
-	SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOA);
-
-	//
-	// Configure the GPIO pin muxing for the Timer/CCP function.
-	// This is only necessary if your part supports GPIO pin function muxing.
-	// Study the data sheet to see which functions are allocated per pin.
-	//
-	GPIOPinConfigure(GPIO_PA2_T1CCP0);
-	GPIOPinConfigure(GPIO_PA3_T1CCP1);
-	GPIOPinConfigure(GPIO_PA4_T2CCP0);
-	GPIOPinConfigure(GPIO_PA5_T2CCP1);
-
-	//
-	// Configure the ccp settings for CCP pin. This function also gives
-	// control of these pins to the timer hardware. Consult the data sheet to
-	// see which functions are allocated per pin.
-	//
-	GPIOPinTypeTimer(GPIO_PORTA_BASE, GPIO_PIN_2 | GPIO_PIN_3 | GPIO_PIN_4 | GPIO_PIN_5);
-
-	//
-	// Configure Timer as a 32-bit periodic timer.
-	//
-	TimerConfigure(TIMER1_BASE, TIMER_CFG_SPLIT_PAIR |
-				   TIMER_CFG_A_PWM | TIMER_CFG_B_PWM);
-	TimerConfigure(TIMER2_BASE, TIMER_CFG_SPLIT_PAIR |
-				   TIMER_CFG_A_PWM | TIMER_CFG_B_PWM);
-
-	//
-	// Set the Timers load value to 100000 (for 500 Hz period). From the
-	// load value (i.e. 100000) down to match value (set below) the signal
-	// will be high.  From the match value to 0 the timer will be low.
-	//
-	TimerLoadSet(TIMER1_BASE, TIMER_A, (SYS_CLOCK/SWITCHING_FREQ));
-	TimerLoadSet(TIMER1_BASE, TIMER_B, (SYS_CLOCK/SWITCHING_FREQ));
-	TimerLoadSet(TIMER2_BASE, TIMER_A, (SYS_CLOCK/SWITCHING_FREQ));
-	TimerLoadSet(TIMER2_BASE, TIMER_B, (SYS_CLOCK/SWITCHING_FREQ));
-
-	//
-	// Set the WTimers match value to maximum (pulse width = 0).
-	//
-	TimerMatchSet(TIMER1_BASE, TIMER_A, MOTOR_SPEED_ZERO);
-	TimerMatchSet(TIMER1_BASE, TIMER_B, MOTOR_SPEED_ZERO);
-	TimerMatchSet(TIMER2_BASE, TIMER_A, MOTOR_SPEED_ZERO);
-	TimerMatchSet(TIMER2_BASE, TIMER_B, MOTOR_SPEED_ZERO);
-
-	//
-	// Enable Timers.
-	//
-	TimerEnable(TIMER1_BASE, TIMER_A | TIMER_B);
-	TimerEnable(TIMER2_BASE, TIMER_A | TIMER_B);
-
-//	LEFT_B(MOTOR_SPEED_MAX/2);
-//	LEFT_F(MOTOR_SPEED_ZERO);
-//	RIGHT_B(MOTOR_SPEED_MAX/2);
-//	RIGHT_F(MOTOR_SPEED_ZERO);
-
-	return;
-}
+/*
+ * dc_motor.c
+ *
+ *  Created on: 16 dc. 2017
+ *      Author: macload1
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_timer.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/pin_map.h"
+#include "driverlib/gpio.h"
+#include "driverlib/timer.h"
+
+#include "dc_motor.h"
+#include "dc_encoder.h"
+#include "hal.h"
+#include "trace.h"
+#include "metrics.h"
+#include "latency.h"
+#include "event.h"
+
+
+
+//*****************************************************************************
+//
+// Global variable to hold the system clock speed.
+//
+//*****************************************************************************
+extern uint32_t ui32SysClock;
+
+//*****************************************************************************
+//
+// DC motor movement variables.
+//
+//*****************************************************************************
+bool dc_is_moving = false;
+uint32_t dc_mvmt_start_time;
+int32_t dc_actual_speed[DC_MOTOR_NBR];
+int32_t dcMotorSpeed[DC_MOTOR_NBR];
+int32_t dcSpeedSetpoint[DC_MOTOR_NBR];
+int32_t dcSpeedLimit[DC_MOTOR_NBR] = {DC_SPEED_MAX, DC_SPEED_MAX};
+
+//*****************************************************************************
+//
+// Closed-loop speed control variables.
+//
+//*****************************************************************************
+bool dcClosedLoop = false;
+int32_t dcVelocityMax = DC_VELOCITY_MAX_DEFAULT;
+int32_t dcWheelPosition[DC_MOTOR_NBR];
+int32_t dcWheelVelocity[DC_MOTOR_NBR];
+struct dc_pid dcPid[DC_MOTOR_NBR];
+
+//*****************************************************************************
+//
+// PWM configuration.
+//
+//*****************************************************************************
+uint32_t dcPwmLoad;
+uint32_t dcPwmStep = 1;
+uint8_t dcDecayMode = DC_DECAY_COAST;
+
+// Timer of the forward and backward leg of every motor
+static const uint32_t legBase[DC_MOTOR_NBR][2] = {{LEFT_F_BASE, LEFT_B_BASE},
+												  {RIGHT_F_BASE, RIGHT_B_BASE}};
+static const uint32_t legTimer[DC_MOTOR_NBR][2] = {{LEFT_F_TIMER, LEFT_B_TIMER},
+												   {RIGHT_F_TIMER, RIGHT_B_TIMER}};
+
+
+//*****************************************************************************
+//
+// Sets the time a leg is high during a PWM period, in timer counts.  The
+// output is high from the load value down to the match value, the
+// prescaler holds bits 16 to 23 of both.
+//
+//*****************************************************************************
+static void dcPwmSet(uint32_t motor, uint32_t leg, uint32_t high)
+{
+	uint32_t match;
+
+	if(high >= dcPwmLoad)
+		match = 0;
+	else if(high == 0)
+		match = dcPwmLoad - 1;
+	else
+		match = dcPwmLoad - high;
+
+	halTimerMatchSet(legBase[motor][leg], legTimer[motor][leg], match);
+}
+
+
+//*****************************************************************************
+//
+// Initialises the timer PWM peripheral.
+//
+//*****************************************************************************
+void initDCMotor(void)
+{
+	int i;
+
+	/**************************************************************************
+	 *
+	 * DC Motor Control
+	 * Period: 1900 Hz <=> 526 microseconds at power-up, see setDCPwmConfig()
+	 * Pulse width range: 0 ms - 0,526 ms
+	 *
+	 *************************************************************************/
+	//
+	// The Timer1 and Timer2 peripheral must be enabled.
+	//
+	SysCtlPeripheralEnable(SYSCTL_PERIPH_TIMER1);
+	SysCtlPeripheralEnable(SYSCTL_PERIPH_TIMER2);
+
+	//
+	// GPIO port A needs to be enabled so their pins can be used.
+	//
+	SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOA);
+
+	//
+	// Configure the GPIO pin muxing for the Timer/CCP function.
+	// This is only necessary if your part supports GPIO pin function muxing.
+	// Study the data sheet to see which functions are allocated per pin.
+	//
+	GPIOPinConfigure(GPIO_PA2_T1CCP0);
+	GPIOPinConfigure(GPIO_PA3_T1CCP1);
+	GPIOPinConfigure(GPIO_PA4_T2CCP0);
+	GPIOPinConfigure(GPIO_PA5_T2CCP1);
+
+	//
+	// Configure the ccp settings for CCP pin. This function also gives
+	// control of these pins to the timer hardware. Consult the data sheet to
+	// see which functions are allocated per pin.
+	//
+	GPIOPinTypeTimer(GPIO_PORTA_BASE, GPIO_PIN_2 | GPIO_PIN_3 | GPIO_PIN_4 | GPIO_PIN_5);
+
+	//
+	// Configure Timer as a 32-bit periodic timer.
+	//
+	TimerConfigure(TIMER1_BASE, TIMER_CFG_SPLIT_PAIR |
+				   TIMER_CFG_A_PWM | TIMER_CFG_B_PWM);
+	TimerConfigure(TIMER2_BASE, TIMER_CFG_SPLIT_PAIR |
+				   TIMER_CFG_A_PWM | TIMER_CFG_B_PWM);
+
+	//
+	// Start at rest in open loop, also when started again without a reset.
+	//
+	for(i = 0; i < DC_MOTOR_NBR; i++)
+	{
+		dcMotorSpeed[i] = 0;
+		dcSpeedSetpoint[i] = 0;
+		dcSpeedLimit[i] = DC_SPEED_MAX;
+		dcWheelPosition[i] = 0;
+		dcWheelVelocity[i] = 0;
+	}
+	dcClosedLoop = false;
+	dcVelocityMax = DC_VELOCITY_MAX_DEFAULT;
+
+	//
+	// Set the load values from the real system clock, with the motors
+	// stopped.
+	//
+	setDCPwmConfig(SWITCHING_FREQ, DC_PWM_BITS_DEFAULT, DC_DECAY_COAST);
+
+	//
+	// Enable Timers.
+	//
+	TimerEnable(TIMER1_BASE, TIMER_A | TIMER_B);
+	TimerEnable(TIMER2_BASE, TIMER_A | TIMER_B);
+
+	pidInit(&dcPid[DC_LEFT], DC_PID_KP_DEFAULT, DC_PID_KI_DEFAULT, DC_PID_KD_DEFAULT, DC_SPEED_MAX);
+	pidInit(&dcPid[DC_RIGHT], DC_PID_KP_DEFAULT, DC_PID_KI_DEFAULT, DC_PID_KD_DEFAULT, DC_SPEED_MAX);
+
+	return;
+}
+
+
+//*****************************************************************************
+//
+// Configures the PWM of both motors: frequency in Hz, duty resolution in
+// bits and decay mode during the off time.  The resolution is limited by
+// the timer counts of a period, ultrasonic frequencies have fewer steps.
+// The motors keep their speed.
+//
+// Returns the frequency actually set.
+//
+//*****************************************************************************
+uint32_t setDCPwmConfig(uint32_t frequency, uint32_t bits, uint8_t decay)
+{
+	int i;
+	uint32_t load;
+
+	if(frequency < DC_PWM_FREQ_MIN)
+		frequency = DC_PWM_FREQ_MIN;
+	load = ui32SysClock / frequency;
+	if(load > 0xFFFFFF)
+		load = 0xFFFFFF;
+	else if(load < 2)
+		load = 2;
+	if(bits > 24)
+		bits = 24;
+
+	dcPwmLoad = load;
+	dcPwmStep = load >> bits;
+	if(dcPwmStep == 0)
+		dcPwmStep = 1;
+	dcDecayMode = decay;
+
+	for(i = 0; i < DC_MOTOR_NBR; i++)
+	{
+		TimerPrescaleSet(legBase[i][0], legTimer[i][0], load >> 16);
+		TimerLoadSet(legBase[i][0], legTimer[i][0], load & 0xFFFF);
+		TimerPrescaleSet(legBase[i][1], legTimer[i][1], load >> 16);
+		TimerLoadSet(legBase[i][1], legTimer[i][1], load & 0xFFFF);
+		setDCMotorSpeed(i, dcMotorSpeed[i]);
+	}
+
+	return ui32SysClock / load;
+}
+
+
+//*****************************************************************************
+//
+// Drives a motor at a signed speed, DC_SPEED_MAX being the full duty cycle,
+// within the over-current limit of the motor.  In coast mode the leg that is not driven stays low; in brake mode the
+// driven leg stays high and the other one is low during the on time.
+//
+//*****************************************************************************
+void setDCMotorSpeed(uint32_t motor, int32_t speed)
+{
+	uint32_t high;
+	uint32_t drive, other;
+
+	if(motor >= DC_MOTOR_NBR)
+		return;
+
+	if(speed > dcSpeedLimit[motor])
+		speed = dcSpeedLimit[motor];
+	else if(speed < -dcSpeedLimit[motor])
+		speed = -dcSpeedLimit[motor];
+
+	high = (uint32_t)(((uint64_t)(speed < 0 ? -speed : speed) * dcPwmLoad) / DC_SPEED_MAX);
+	high -= high % dcPwmStep;
+
+	drive = (speed >= 0) ? 0 : 1;
+	other = 1 - drive;
+	if(dcDecayMode == DC_DECAY_BRAKE)
+	{
+		dcPwmSet(motor, drive, dcPwmLoad);
+		dcPwmSet(motor, other, dcPwmLoad - high);
+	}
+	else
+	{
+		dcPwmSet(motor, other, 0);
+		dcPwmSet(motor, drive, high);
+	}
+
+	dcMotorSpeed[motor] = speed;
+	metricsPwmCommits++;
+	TRACE(TRACE_PWM_COMMIT, TRACE_DC_MOTOR | motor, (uint16_t)speed);
+	latencyApply(LATENCY_DC);
+}
+
+
+//*****************************************************************************
+//
+// Asks a motor for a signed speed.  In open loop the duty is applied at
+// once, in closed loop the PID drives the motor to the matching velocity.
+//
+//*****************************************************************************
+void setDCMotorSetpoint(uint32_t motor, int32_t speed)
+{
+	if(motor >= DC_MOTOR_NBR)
+		return;
+
+	if(speed > DC_SPEED_MAX)
+		speed = DC_SPEED_MAX;
+	else if(speed < -DC_SPEED_MAX)
+		speed = -DC_SPEED_MAX;
+
+	dcSpeedSetpoint[motor] = speed;
+	if(!dcClosedLoop)
+		setDCMotorSpeed(motor, speed);
+}
+
+
+//*****************************************************************************
+//
+// Switches between open-loop duty and closed-loop speed control.
+//
+//*****************************************************************************
+void setDCClosedLoop(bool enable)
+{
+	int i;
+
+	for(i = 0; i < DC_MOTOR_NBR; i++)
+	{
+		pidReset(&dcPid[i]);
+		if(!enable)
+			setDCMotorSpeed(i, dcSpeedSetpoint[i]);
+	}
+	dcClosedLoop = enable;
+}
+
+
+//*****************************************************************************
+//
+// Samples the wheel encoders and runs the speed loops, called every
+// millisecond.  The velocity is the count difference over the loop period.
+//
+//*****************************************************************************
+void dcControlUpdate(uint32_t ms_time)
+{
+	int i;
+	int32_t position;
+	int32_t setpoint;
+
+	if((ms_time % DC_PID_PERIOD_MS) != 0)
+		return;
+
+	for(i = 0; i < DC_MOTOR_NBR; i++)
+	{
+		position = dcEncoderPosition(i);
+		dcWheelVelocity[i] = (position - dcWheelPosition[i]) * (1000 / DC_PID_PERIOD_MS);
+		dcWheelPosition[i] = position;
+
+		if(dcClosedLoop)
+		{
+			setpoint = (dcSpeedSetpoint[i] * dcVelocityMax) / DC_SPEED_MAX;
+			setDCMotorSpeed(i, pidUpdate(&dcPid[i], setpoint - dcWheelVelocity[i], dcSpeedSetpoint[i]));
+		}
+	}
+}
+
+
+//*****************************************************************************
+//
+// Converts a raw match value, as sent by DC_DIRECT_CMD, to a signed speed.
+//
+//*****************************************************************************
+// The ends of the DC_DIRECT_CMD range have to land on the ends of the scale
+typedef char dcMatchFullCheck[(DC_MATCH_TO_SPEED(MOTOR_SPEED_MAX) == DC_SPEED_MAX) ? 1 : -1];
+typedef char dcMatchZeroCheck[(DC_MATCH_TO_SPEED(MOTOR_SPEED_ZERO) == 0) ? 1 : -1];
+
+int32_t dcMatchToSpeed(uint32_t match, bool forward)
+{
+	int32_t speed;
+
+	if(match > MOTOR_SPEED_ZERO)
+		match = MOTOR_SPEED_ZERO;
+	speed = DC_MATCH_TO_SPEED(match);
+
+	return forward ? speed : -speed;
+}
+
+
+//*****************************************************************************
+//
+// Advances the DC motor timelines, called every millisecond.  Every action
+// ramps the motor linearly from the speed it had when the action started to
+// the speed of the action, so that a manoeuvre is a list of accelerations,
+// cruises and decelerations.
+//
+//*****************************************************************************
+void dcMotorUpdate(uint32_t ms_time)
+{
+	int i;
+	bool dc_empty = true;
+
+	if(!dc_is_moving)
+		return;
+
+	for(i = 0; i < DC_MOTOR_NBR; i++)
+	{
+		if(!listIsEmpty(&dc_motor_list[i]))
+		{
+			dc_empty = false;
+			if((dc_mvmt_start_time + dc_motor_list[i].h_p->ms_time_start) <= ms_time)
+			{
+				uint32_t duration;
+				uint32_t elapsed;
+				int32_t target = (int32_t)dc_motor_list[i].h_p->position;
+
+				duration = dc_motor_list[i].h_p->ms_time_stop - dc_motor_list[i].h_p->ms_time_start;
+				elapsed = ms_time - (dc_mvmt_start_time + dc_motor_list[i].h_p->ms_time_start);
+				if(dc_motor_list[i].h_p->arrival != 0)
+				{
+					// First application
+					TRACE(TRACE_KEYFRAME_START, TRACE_DC_MOTOR | i, (uint16_t)target);
+					latencyMark(LATENCY_DC, latencyDue(LATENCY_DC,
+							dc_motor_list[i].h_p->arrival, elapsed));
+					dc_motor_list[i].h_p->arrival = 0;
+				}
+				if(elapsed >= duration)
+				{
+					// A zero length action is a step
+					setDCMotorSetpoint(i, target);
+					dc_actual_speed[i] = dcSpeedSetpoint[i];
+					TRACE(TRACE_KEYFRAME_RETIRE, TRACE_DC_MOTOR | i, (uint16_t)target);
+					listDelete(&dc_motor_list[i], true);
+					TRACE(TRACE_QUEUE_DEPTH, TRACE_DC_MOTOR | i, listLength(&dc_motor_list[i]));
+					EVENT(EVENT_KEYFRAME, TRACE_DC_MOTOR | i, listLength(&dc_motor_list[i]));
+				}
+				else
+				{
+					setDCMotorSetpoint(i, dc_actual_speed[i] +
+							(int32_t)(((int64_t)(target - dc_actual_speed[i]) * elapsed) / duration));
+				}
+			}
+		}
+	}
+	if(dc_empty)
+	{
+		dc_is_moving = false;
+		EVENT(EVENT_GROUP_DONE, 0x10, 0);
+	}
+}
@@ -1,48 +1,128 @@
-/*
- * dc_motor.h
- *
- *  Created on: 16 dc. 2017
- *      Author: macload1
- */
-
-#ifndef DC_MOTOR_H_
-#define DC_MOTOR_H_
-
-#include <stdbool.h>
-#include <stdint.h>
-#include "inc/hw_memmap.h"
-#include "inc/hw_timer.h"
-#include "driverlib/sysctl.h"
-#include "driverlib/pin_map.h"
-#include "driverlib/gpio.h"
-#include "driverlib/timer.h"
-
-//*****************************************************************************
-//
-// Switching frequency.
-//
-//*****************************************************************************
-#define	SWITCHING_FREQ			(unsigned long) 1900		// in Hz (1832 minimum)
-#define SYS_CLOCK				(unsigned long) 120000000	// in Hz
-
-
-#define MOTOR_SPEED_ZERO			SYS_CLOCK/SWITCHING_FREQ-1
-#define MOTOR_SPEED_MAX				0
-
-
-//*****************************************************************************
-//
-// Motor corresponding timers.
-//
-//*****************************************************************************
-#define	LEFT_B(x)					TimerMatchSet(TIMER1_BASE, TIMER_B, x);
-#define	LEFT_F(x)					TimerMatchSet(TIMER1_BASE, TIMER_A, x);
-#define	RIGHT_B(x)					TimerMatchSet(TIMER2_BASE, TIMER_A, x);
-#define	RIGHT_F(x)					TimerMatchSet(TIMER2_BASE, TIMER_B, x);
-
-
-
-// Initialise PWM peripheral
-void initDCMotor(void);
-
-#endif /* DC_MOTOR_H_ */
+/*
+ * dc_motor.h
+ *
+ *  Created on: 16 dc. 2017
+ *      Author: macload1
+ */
+
+#ifndef DC_MOTOR_H_
+#define DC_MOTOR_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_timer.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/pin_map.h"
+#include "driverlib/gpio.h"
+#include "driverlib/timer.h"
+
+#include "linked_list_dbl.h"
+#include "dc_pid.h"
+
+//*****************************************************************************
+//
+// Switching frequency.  The PWM is configured at runtime from the real
+// system clock, these are the power-up settings.
+//
+//*****************************************************************************
+#define	SWITCHING_FREQ			(unsigned long) 1900		// in Hz
+#define DC_PWM_FREQ_MIN			(unsigned long) 10			// 24-bit timer at 120 MHz
+#define DC_PWM_BITS_DEFAULT		16							// duty resolution
+
+#define DC_DECAY_COAST			0			// off time: both legs low, the motor freewheels
+#define DC_DECAY_BRAKE			1			// off time: both legs high, the motor brakes
+
+//*****************************************************************************
+//
+// Raw match values of DC_DIRECT_CMD, kept for the hosts that still send
+// them.  They are relative to a 1900 Hz PWM on a 120 MHz clock, whatever
+// the PWM configuration.
+//
+//*****************************************************************************
+#define SYS_CLOCK				(unsigned long) 120000000	// in Hz
+#define MOTOR_SPEED_ZERO			((SYS_CLOCK/SWITCHING_FREQ)-1)
+#define MOTOR_SPEED_MAX				0
+
+// Unsigned speed of a match value within 0 - MOTOR_SPEED_ZERO
+#define DC_MATCH_TO_SPEED(match)	(((MOTOR_SPEED_ZERO - (match)) * DC_SPEED_MAX) / MOTOR_SPEED_ZERO)
+
+
+//*****************************************************************************
+//
+// Motor corresponding timers.
+//
+//*****************************************************************************
+#define	LEFT_B_BASE					TIMER1_BASE
+#define	LEFT_B_TIMER				TIMER_B
+#define	LEFT_F_BASE					TIMER1_BASE
+#define	LEFT_F_TIMER				TIMER_A
+#define	RIGHT_B_BASE				TIMER2_BASE
+#define	RIGHT_B_TIMER				TIMER_A
+#define	RIGHT_F_BASE				TIMER2_BASE
+#define	RIGHT_F_TIMER				TIMER_B
+
+
+//*****************************************************************************
+//
+// Signed motor speeds, normalised to the full duty cycle whatever the PWM
+// frequency and resolution.  Positive speeds move forward.
+//
+//*****************************************************************************
+#define DC_LEFT						0
+#define DC_RIGHT					1
+#define DC_MOTOR_NBR				2
+
+#define DC_SPEED_MAX				32767
+
+
+//*****************************************************************************
+//
+// Closed-loop speed control.  In closed loop the speeds are set points:
+// DC_SPEED_MAX asks for dcVelocityMax encoder counts per second, and the
+// PID corrects the feedforward duty every DC_PID_PERIOD_MS.
+//
+//*****************************************************************************
+#define DC_PID_PERIOD_MS			10
+#define DC_VELOCITY_MAX_DEFAULT		3000		// counts/s at full duty
+#define DC_PID_KP_DEFAULT			2048		// Q8 gains
+#define DC_PID_KI_DEFAULT			256
+#define DC_PID_KD_DEFAULT			0
+
+extern bool dcClosedLoop;
+extern int32_t dcVelocityMax;
+extern int32_t dcWheelPosition[DC_MOTOR_NBR];		// encoder counts
+extern int32_t dcWheelVelocity[DC_MOTOR_NBR];		// encoder counts per second
+extern struct dc_pid dcPid[DC_MOTOR_NBR];
+
+
+//*****************************************************************************
+//
+// DC motor movement variables.
+//
+//*****************************************************************************
+extern bool dc_is_moving;
+extern uint32_t dc_mvmt_start_time;
+extern int32_t dc_actual_speed[DC_MOTOR_NBR];		// speed the running ramp started from
+extern int32_t dcMotorSpeed[DC_MOTOR_NBR];			// speed applied to the motors
+extern int32_t dcSpeedSetpoint[DC_MOTOR_NBR];		// speed asked for
+extern int32_t dcSpeedLimit[DC_MOTOR_NBR];			// lowered by the over-current foldback
+extern struct list_s dc_motor_list[DC_MOTOR_NBR];	// list contains the different actions
+
+
+extern uint32_t dcPwmLoad;							// timer counts per PWM period
+extern uint32_t dcPwmStep;							// timer counts per duty step
+extern uint8_t dcDecayMode;
+
+
+// Initialise PWM peripheral
+void initDCMotor(void);
+uint32_t setDCPwmConfig(uint32_t frequency, uint32_t bits, uint8_t decay);
+void setDCMotorSpeed(uint32_t motor, int32_t speed);
+void setDCMotorSetpoint(uint32_t motor, int32_t speed);
+void setDCClosedLoop(bool enable);
+void dcControlUpdate(uint32_t ms_time);
+int32_t dcMatchToSpeed(uint32_t match, bool forward);
+void dcMotorUpdate(uint32_t ms_time);
+
+#endif /* DC_MOTOR_H_ */
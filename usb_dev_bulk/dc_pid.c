@@ -0,0 +1,87 @@
+/*
+ * dc_pid.c
+ *
+ * Purpose:  Fixed-point PID controller.  It is called at a fixed rate, so
+ *           the sample time is folded into the integral and derivative
+ *           gains.
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "dc_pid.h"
+
+
+/*-----------------------------------------------------------------*/
+/* Function:   pidInit
+ * Purpose:    Set the gains and the output range of a controller and
+ *             clear its state
+ * In/out arg: pid_p = controller
+ * Input arg:  kp, ki, kd = Q8 gains
+ *             outMax = limit of the output magnitude
+ */
+void pidInit(struct dc_pid* pid_p, int32_t kp, int32_t ki, int32_t kd, int32_t outMax)
+{
+    pid_p->kp = kp;
+    pid_p->ki = ki;
+    pid_p->kd = kd;
+    pid_p->outMax = outMax;
+    pidReset(pid_p);
+}
+
+
+/*-----------------------------------------------------------------*/
+/* Function:   pidReset
+ * Purpose:    Clear the integral and derivative state
+ * In/out arg: pid_p = controller
+ */
+void pidReset(struct dc_pid* pid_p)
+{
+    pid_p->integral = 0;
+    pid_p->prevError = 0;
+}
+
+
+/*-----------------------------------------------------------------*/
+/* Function:   pidUpdate
+ * Purpose:    Run one step of the controller.  The integral is only
+ *             accumulated while the output is not saturated, so it does
+ *             not wind up while the motor cannot follow.
+ * In/out arg: pid_p = controller
+ * Input arg:  error = set point - measure
+ *             feedforward = output expected without any error
+ * Return val: output, limited to -outMax .. outMax
+ */
+int32_t pidUpdate(struct dc_pid* pid_p, int32_t error, int32_t feedforward)
+{
+    int32_t integral;
+    int64_t acc;
+    int32_t out;
+
+    integral = pid_p->integral + pid_p->ki * error;
+
+    acc = (int64_t)pid_p->kp * error + integral +
+          (int64_t)pid_p->kd * (error - pid_p->prevError);
+    out = feedforward + (int32_t)(acc >> PID_GAIN_SHIFT);
+    pid_p->prevError = error;
+
+    if(out > pid_p->outMax)
+    {
+        out = pid_p->outMax;
+        if(error < 0)
+            pid_p->integral = integral;     // still unwinding
+    }
+    else if(out < -pid_p->outMax)
+    {
+        out = -pid_p->outMax;
+        if(error > 0)
+            pid_p->integral = integral;
+    }
+    else
+    {
+        pid_p->integral = integral;
+    }
+    return out;
+}
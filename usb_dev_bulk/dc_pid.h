@@ -0,0 +1,36 @@
+/*
+ * dc_pid.h
+ *
+ * Purpose:  Fixed-point PID controller, free of any hardware access.
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+
+#ifndef DC_PID_H_
+#define DC_PID_H_
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#define PID_GAIN_SHIFT			8		// gains are Q8: 256 is a gain of 1
+
+struct dc_pid {
+   int32_t kp;				// Q8 gains
+   int32_t ki;
+   int32_t kd;
+   int32_t outMax;			// output range is -outMax .. outMax
+   int32_t integral;		// Q8 sum of ki * error
+   int32_t prevError;
+};
+
+void pidInit(struct dc_pid* pid_p, int32_t kp, int32_t ki, int32_t kd, int32_t outMax);
+void pidReset(struct dc_pid* pid_p);
+int32_t pidUpdate(struct dc_pid* pid_p, int32_t error, int32_t feedforward);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif /* DC_PID_H_ */
@@ -16,6 +16,7 @@
 #include "driverlib/interrupt.h"
 
 #include "delay.h"
+#include "profile.h"
 
 volatile uint32_t delayCounter;
 
@@ -35,12 +36,14 @@ extern uint32_t ui32SysClock;
 void
 Timer5AIntHandler(void)
 {
+    PROFILE_ISR_ENTER();
     //
     // Clear the timer interrupt.
     //
     ROM_TimerIntClear(TIMER5_BASE, TIMER_TIMA_TIMEOUT);
 
     delayCounter++;
+    PROFILE_ISR_EXIT(PROFILE_TIMER5);
 }
 
 void delay_init(void)
@@ -0,0 +1,92 @@
+/*
+ * event.c
+ *
+ * Purpose:  Notifications of the motion and of the Meccano chain, so that
+ *           the host does not have to poll or to time the movements
+ *           itself.  The handlers record the events in a ring and the
+ *           main loop sends them on the bulk IN endpoint.
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include "timer_handler.h"
+#include "protocol.h"
+#include "record_ring.h"
+#include "event.h"
+
+
+struct event_record {
+   uint32_t time;
+   uint16_t arg16;
+   uint8_t id;
+   uint8_t arg8;
+};
+
+uint32_t eventMask = 0;
+
+static struct event_record eventRecords[EVENT_SIZE];
+static struct record_ring eventRing = RECORD_RING(eventRecords, EVENT_SIZE);
+static uint8_t eventPacket[RECORD_HEADER_SIZE + 8 * EVENT_PER_PACKET];
+
+
+//*****************************************************************************
+//
+// Records an event, use the EVENT macro so that the disabled events cost
+// only the test of the mask.  The oldest event is dropped when the ring is
+// full.  Can be called from a handler.
+//
+//*****************************************************************************
+void eventWrite(uint8_t id, uint8_t arg8, uint16_t arg16)
+{
+	struct event_record record;
+
+	record.time = milli_second;
+	record.arg16 = arg16;
+	record.id = id;
+	record.arg8 = arg8;
+	recordRingWrite(&eventRing, &record);
+}
+
+
+//*****************************************************************************
+//
+// Sets the events sent to the host, 0 stops them.  The events still in
+// the ring are dropped.
+//
+//*****************************************************************************
+void setEventMask(uint32_t mask)
+{
+	eventMask = mask;
+	recordRingFlush(&eventRing);
+}
+
+
+//*****************************************************************************
+//
+// Writes an event into an event packet.
+//
+//*****************************************************************************
+static uint8_t *eventEncode(uint8_t *p, const void *record)
+{
+	const struct event_record *record_p = record;
+
+	*p++ = record_p->id;
+	*p++ = record_p->arg8;
+	p = protocolPut16(p, record_p->arg16);
+	return protocolPut32(p, record_p->time);
+}
+
+
+//*****************************************************************************
+//
+// Sends the events while the USB buffer has room, called from the main
+// loop.
+//
+//*****************************************************************************
+void eventProcess(void)
+{
+	recordRingSend(&eventRing, EVENT_MSG, eventPacket, EVENT_PER_PACKET,
+				   eventEncode);
+}
@@ -0,0 +1,45 @@
+/*
+ * event.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+
+#ifndef EVENT_H_
+#define EVENT_H_
+
+//*****************************************************************************
+//
+// Events pushed to the host.  Event n is enabled by bit (n - 1) of the
+// event mask.
+//
+//*****************************************************************************
+									// arg8, arg16
+#define EVENT_GROUP_DONE			0x01	// group (start mask bit), 0
+#define EVENT_KEYFRAME				0x02	// actuator (trace ID), actions left
+#define EVENT_MODULE_FOUND			0x03	// Meccano module, type
+#define EVENT_MODULE_LOST			0x04	// Meccano module, type it had
+#define EVENT_DRIVE_DONE			0x05	// 0, 0: pose target reached
+
+//*****************************************************************************
+//
+// Event packets sent to the host while the events are enabled:
+//   EVENT_MSG, event count, events lost (2 bytes), then per event the ID,
+//   arg8, arg16 (2 bytes) and the time (ms, 4 bytes).
+//
+//*****************************************************************************
+#define EVENT_MSG					0x84
+#define EVENT_SIZE					32		// events, power of 2
+#define EVENT_PER_PACKET			7
+
+extern uint32_t eventMask;					// events recorded, 0 if off
+
+#define EVENT(id, arg8, arg16)		do { if(eventMask & (1 << ((id) - 1))) \
+										eventWrite((id), (arg8), (arg16)); } while(0)
+
+
+void eventWrite(uint8_t id, uint8_t arg8, uint16_t arg16);
+void setEventMask(uint32_t mask);
+void eventProcess(void);
+
+#endif /* EVENT_H_ */
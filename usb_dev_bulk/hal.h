@@ -0,0 +1,43 @@
+/*
+ * hal.h
+ *
+ * Purpose:  Peripheral accesses of the run-time paths: servo PWM, DC
+ *           motor PWM, Meccano line and the interrupt flags of the timers.
+ *           They are macros over the driverlib calls, so the generated
+ *           code is the same as with the calls written out.  The host
+ *           build in host/ resolves the same calls to the simulated
+ *           peripherals of host/sim.
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+
+#ifndef HAL_H_
+#define HAL_H_
+
+#include "inc/hw_memmap.h"
+#include "driverlib/gpio.h"
+#include "driverlib/pwm.h"
+#include "driverlib/timer.h"
+#include "driverlib/rom.h"
+
+// Servo outputs are all on PWM0
+#define halPwmWidthSet(output, width)		PWMPulseWidthSet(PWM0_BASE, (output), (width))
+
+// The DC motor legs use 24-bit matches, prescaler included
+#define halTimerLoadSet(base, timer, value)	TimerLoadSet((base), (timer), (value))
+#define halTimerMatchSet(base, timer, match)	do { TimerPrescaleMatchSet((base), (timer), (match) >> 16); \
+												 TimerMatchSet((base), (timer), (match) & 0xFFFF); } while(0)
+#define halTimerIntClear(base, flags)		ROM_TimerIntClear((base), (flags))
+#define halTimerIntStatus(base)				ROM_TimerIntStatus((base), false)
+
+#define halPinWrite(base, pins, value)		GPIOPinWrite((base), (pins), (value))
+#define halPinRead(base, pins)				GPIOPinRead((base), (pins))
+#define halPinOutput(base, pins)			GPIOPinTypeGPIOOutput((base), (pins))
+#define halPinInput(base, pins)				GPIOPinTypeGPIOInput((base), (pins))
+#define halPinIntEnable(base, pins)			GPIOIntEnable((base), (pins))
+#define halPinIntDisable(base, pins)		GPIOIntDisable((base), (pins))
+#define halPinIntClear(base, pins)			GPIOIntClear((base), (pins))
+#define halPinIntStatus(base)				GPIOIntStatus((base), false)
+
+#endif /* HAL_H_ */
@@ -0,0 +1,143 @@
+/*
+ * latency.c
+ *
+ * Purpose:  Time from the arrival of a command to the moment the
+ *           actuator output changes, per actuator subsystem.  A command
+ *           or a keyframe marks its subsystem with the cycle count at
+ *           which it should take effect, the output commit samples it.
+ *           A keyframe should take effect at the tick it is due, or at
+ *           its arrival when it was sent late, so only the delay added
+ *           by the device is counted.
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "profile.h"
+#include "latency.h"
+
+extern uint32_t ui32SysClock;
+
+struct latency_stats latencyStats[LATENCY_CHANNEL_NBR];
+uint32_t latencyTickCycles;
+
+static uint32_t pending[LATENCY_CHANNEL_NBR];	// oldest unapplied stamp
+static uint32_t groupStart[LATENCY_CHANNEL_NBR];	// last start of a movement
+
+
+//*****************************************************************************
+//
+// Marks an action of the subsystem that takes effect at the next output
+// commit.  When an older action is still pending, its stamp is kept.
+//
+//*****************************************************************************
+void latencyMark(uint32_t channel, uint32_t stamp)
+{
+	if(pending[channel] == 0)
+		pending[channel] = LATENCY_STAMP(stamp);
+}
+
+
+//*****************************************************************************
+//
+// Called when the output of the subsystem is committed, accounts the
+// pending action if there is one.
+//
+//*****************************************************************************
+void latencyApply(uint32_t channel)
+{
+	struct latency_stats *p;
+	uint32_t us;
+	uint32_t bin;
+
+	if(pending[channel] == 0)
+		return;
+	us = (DWT_CYCCNT_R - pending[channel]) / (ui32SysClock / 1000000);
+	pending[channel] = 0;
+
+	p = &latencyStats[channel];
+	p->count++;
+	if(us < p->min)
+		p->min = us;
+	if(us > p->max)
+		p->max = us;
+	p->total += us;
+
+	bin = profileLog2(us);
+	if(bin >= LATENCY_HIST_BINS)
+		bin = LATENCY_HIST_BINS - 1;
+	if(p->hist[bin] != 0xFFFF)
+		p->hist[bin]++;
+}
+
+
+//*****************************************************************************
+//
+// Records the arrival of the command that started a movement of the
+// subsystem, its keyframes cannot take effect before.
+//
+//*****************************************************************************
+void latencyStart(uint32_t channel, uint32_t stamp)
+{
+	groupStart[channel] = stamp;
+}
+
+
+/*-----------------------------------------------------------------*/
+/* Function:   latencyDue
+ * Purpose:    Cycle count at which a keyframe applied in the current
+ *             tick should have taken effect
+ * Input arg:  channel = subsystem of the keyframe
+ *             arrival = cycle count at the arrival of the keyframe
+ *             late_ms = ticks since the keyframe was due, 0 on time
+ * Return val: start of the tick at which it was due, or the arrival
+ *             of the keyframe or of the start command when later
+ */
+uint32_t latencyDue(uint32_t channel, uint32_t arrival, uint32_t late_ms)
+{
+	uint32_t now = DWT_CYCCNT_R;
+	uint32_t due = latencyTickCycles - late_ms * (ui32SysClock / 1000);
+
+	// Compare the ages, the counter wraps every 35 s at 120 MHz
+	if((now - arrival) < (now - due))
+		due = arrival;
+	if((now - groupStart[channel]) < (now - due))
+		due = groupStart[channel];
+	return due;
+}
+
+
+//*****************************************************************************
+//
+// Clears the statistics of every subsystem.
+//
+//*****************************************************************************
+void latencyInit(void)
+{
+	uint32_t i;
+
+	for(i = 0; i < LATENCY_CHANNEL_NBR; i++)
+		latencyClear(i);
+}
+
+
+//*****************************************************************************
+//
+// Clears the statistics of a subsystem.
+//
+//*****************************************************************************
+void latencyClear(uint32_t channel)
+{
+	int i;
+	struct latency_stats *p = &latencyStats[channel];
+
+	p->count = 0;
+	p->min = 0xFFFFFFFF;
+	p->max = 0;
+	p->total = 0;
+	for(i = 0; i < LATENCY_HIST_BINS; i++)
+		p->hist[i] = 0;
+	pending[channel] = 0;
+}
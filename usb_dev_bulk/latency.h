@@ -0,0 +1,49 @@
+/*
+ * latency.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+
+#ifndef LATENCY_H_
+#define LATENCY_H_
+
+//*****************************************************************************
+//
+// Actuator subsystems whose latency is measured.
+//
+//*****************************************************************************
+#define LATENCY_SERVO			0		// arm servos, PWM write
+#define LATENCY_MECCANO			1		// Meccano chain, frame sent
+#define LATENCY_DC				2		// DC motors, PWM write
+#define LATENCY_CHANNEL_NBR		3
+
+#define LATENCY_HIST_BINS		20		// bin n counts 2^n to 2^(n+1)-1 us
+
+//*****************************************************************************
+//
+// Cycle count stamp kept with a pending action, 0 is "none".
+//
+//*****************************************************************************
+#define LATENCY_STAMP(cycles)	((cycles) | 1)
+
+struct latency_stats {
+   uint32_t count;
+   uint32_t min;							// us
+   uint32_t max;
+   uint64_t total;
+   uint16_t hist[LATENCY_HIST_BINS];		// log2 histogram, saturates
+};
+
+extern struct latency_stats latencyStats[LATENCY_CHANNEL_NBR];
+extern uint32_t latencyTickCycles;			// start of the current ms tick
+
+
+void latencyInit(void);
+void latencyMark(uint32_t channel, uint32_t stamp);
+void latencyApply(uint32_t channel);
+void latencyStart(uint32_t channel, uint32_t stamp);
+uint32_t latencyDue(uint32_t channel, uint32_t arrival, uint32_t late_ms);
+void latencyClear(uint32_t channel);
+
+#endif /* LATENCY_H_ */
@@ -1,48 +1,62 @@
-/*
- * File:   linked_list_dbl.h
- * Author: macload1
- *
- * Created on 17. Mai 2015, 17:38
- */
-
-#ifndef LINKED_LIST_DBL_H
-#define	LINKED_LIST_DBL_H
-
-#ifdef	__cplusplus
-extern "C" {
-#endif
-
-struct list_node_s {
-   uint32_t ms_time_start;
-   uint32_t ms_time_stop;
-   uint32_t position;
-   struct list_node_s* prev_p;
-   struct list_node_s* next_p;
-};
-
-struct list_s {
-   struct list_node_s* h_p;
-   struct list_node_s* t_p;
-};
-
-
-struct list_node_s* Allocate_node(void);
-void Insert(struct list_s* list_p,
-            uint32_t ms_time_start,
-            uint32_t ms_time_stop,
-			uint32_t position);
-void Print(struct list_s* list_p);
-int Member(struct list_s* list_p, uint32_t ms_time_stamp);
-void Free_node(struct list_node_s* node_p);
-void listDelete(struct list_s* list_p, bool first);
-void Free_list(struct list_s* list_p);
-void Print_node(struct list_node_s* node_p);
-bool listIsEmpty(struct list_s* list_p);
-
-
-#ifdef	__cplusplus
-}
-#endif
-
-#endif	/* LINKED_LIST_DBL_H */
-
+/*
+ * File:   linked_list_dbl.h
+ * Author: macload1
+ *
+ * Created on 17. Mai 2015, 17:38
+ */
+
+#ifndef LINKED_LIST_DBL_H
+#define	LINKED_LIST_DBL_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+struct list_node_s {
+   uint32_t ms_time_start;
+   uint32_t ms_time_stop;
+   uint32_t position;
+   uint32_t arrival;              /* cycle count at arrival, 0 once applied */
+   struct list_node_s* prev_p;
+   struct list_node_s* next_p;
+};
+
+/* Nodes the 1 KB heap holds with the allocator overhead, the host
+   gets the free ones as credits */
+#define LIST_NODE_MAX   30
+
+struct list_s {
+   struct list_node_s* h_p;
+   struct list_node_s* t_p;
+};
+
+extern uint32_t listNodesUsed;
+extern uint32_t listNodesPeak;
+extern uint32_t listAllocFailures;
+extern uint32_t listInserted;
+extern uint32_t listRetired;
+extern uint32_t listFlushed;
+
+
+struct list_node_s* Allocate_node(void);
+bool Insert(struct list_s* list_p,
+            uint32_t ms_time_start,
+            uint32_t ms_time_stop,
+			uint32_t position,
+			uint32_t arrival);
+void Print(struct list_s* list_p);
+int Member(struct list_s* list_p, uint32_t ms_time_stamp);
+void Free_node(struct list_node_s* node_p);
+void listDelete(struct list_s* list_p, bool first);
+void Free_list(struct list_s* list_p);
+void Print_node(struct list_node_s* node_p);
+bool listIsEmpty(struct list_s* list_p);
+uint32_t listLength(struct list_s* list_p);
+
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* LINKED_LIST_DBL_H */
+
@@ -0,0 +1,97 @@
+/*
+ * log.c
+ *
+ * Purpose:  Deferred logging.  Messages are recorded as an ID and two
+ *           arguments in a ring, and the main loop sends them to the host
+ *           which does the formatting.  Records are kept until the host
+ *           asks for them, so the boot messages are not lost.
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include "timer_handler.h"
+#include "protocol.h"
+#include "record_ring.h"
+#include "log.h"
+
+
+struct log_record {
+   uint32_t time;
+   uint32_t arg0;
+   uint32_t arg1;
+   uint8_t level;
+   uint8_t id;
+};
+
+static struct log_record logRecords[LOG_SIZE];
+static struct record_ring logRing = RECORD_RING(logRecords, LOG_SIZE);
+static uint32_t logSendLevel = LOG_LEVEL_OFF;	// records sent up to this level
+static uint8_t logPacket[RECORD_HEADER_SIZE + 14 * LOG_RECORDS_PER_PACKET];
+
+
+//*****************************************************************************
+//
+// Records a message, use the LOG_ macros so that the levels above
+// LOG_LEVEL cost nothing.  The oldest record is dropped when the ring is
+// full.  Can be called from a handler.
+//
+//*****************************************************************************
+void logWrite(uint8_t level, uint8_t id, uint32_t arg0, uint32_t arg1)
+{
+	struct log_record record;
+
+	record.time = milli_second;
+	record.arg0 = arg0;
+	record.arg1 = arg1;
+	record.level = level;
+	record.id = id;
+	recordRingWrite(&logRing, &record);
+}
+
+
+//*****************************************************************************
+//
+// Sets the level up to which the records are sent to the host, 0 stops.
+//
+//*****************************************************************************
+void setLogLevel(uint32_t level)
+{
+	logSendLevel = level;
+}
+
+
+//*****************************************************************************
+//
+// Writes a record into a log packet, the records above the level asked
+// for by the host are skipped.
+//
+//*****************************************************************************
+static uint8_t *logEncode(uint8_t *p, const void *record)
+{
+	const struct log_record *record_p = record;
+
+	if(record_p->level > logSendLevel)
+		return p;
+	*p++ = record_p->level;
+	*p++ = record_p->id;
+	p = protocolPut32(p, record_p->time);
+	p = protocolPut32(p, record_p->arg0);
+	p = protocolPut32(p, record_p->arg1);
+	return p;
+}
+
+
+//*****************************************************************************
+//
+// Sends the records while the USB buffer has room, called from the main
+// loop.  The records above the level asked for by the host are dropped.
+//
+//*****************************************************************************
+void logProcess(void)
+{
+	if(logSendLevel != LOG_LEVEL_OFF)
+		recordRingSend(&logRing, LOG_MSG, logPacket, LOG_RECORDS_PER_PACKET,
+					   logEncode);
+}
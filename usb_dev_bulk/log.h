@@ -0,0 +1,82 @@
+/*
+ * log.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+
+#ifndef LOG_H_
+#define LOG_H_
+
+//*****************************************************************************
+//
+// Log levels.  Calls above LOG_LEVEL are removed by the preprocessor, the
+// level can be set from the project build options.
+//
+//*****************************************************************************
+#define LOG_LEVEL_OFF				0
+#define LOG_LEVEL_ERROR				1
+#define LOG_LEVEL_WARN				2
+#define LOG_LEVEL_INFO				3
+#define LOG_LEVEL_DEBUG				4
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL					LOG_LEVEL_INFO
+#endif
+
+//*****************************************************************************
+//
+// Log messages.  Only the ID and the two arguments are recorded, the host
+// prints them with the format string given here.
+//
+//*****************************************************************************
+#define LOG_BOOT					0x01	// "Boot, clock %u Hz"
+#define LOG_HOST_CONNECTED			0x02	// "Host connected"
+#define LOG_HOST_DISCONNECTED		0x03	// "Host disconnected"
+#define LOG_USB_TRAFFIC				0x04	// "TX: %u  RX: %u"
+#define LOG_OVER_CURRENT			0x05	// "Over-current on channel %u, %u trips"
+#define LOG_STACK_LOW				0x06	// "Stack used %u of %u bytes"
+#define LOG_REPLY_DROPPED			0x07	// "Reply to 0x%02x dropped, %u bytes"
+
+//*****************************************************************************
+//
+// Log packets are sent to the host while it asks for them:
+//   LOG_MSG, record count, records lost (2 bytes), then per record the
+//   level and message ID, the time (ms, 4 bytes) and the two arguments
+//   (4 bytes each).
+//
+//*****************************************************************************
+#define LOG_MSG						0x82
+#define LOG_SIZE					32		// records, power of 2
+#define LOG_RECORDS_PER_PACKET		4
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(id, arg0, arg1)	logWrite(LOG_LEVEL_ERROR, (id), (arg0), (arg1))
+#else
+#define LOG_ERROR(id, arg0, arg1)	((void)0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(id, arg0, arg1)	logWrite(LOG_LEVEL_WARN, (id), (arg0), (arg1))
+#else
+#define LOG_WARN(id, arg0, arg1)	((void)0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(id, arg0, arg1)	logWrite(LOG_LEVEL_INFO, (id), (arg0), (arg1))
+#else
+#define LOG_INFO(id, arg0, arg1)	((void)0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(id, arg0, arg1)	logWrite(LOG_LEVEL_DEBUG, (id), (arg0), (arg1))
+#else
+#define LOG_DEBUG(id, arg0, arg1)	((void)0)
+#endif
+
+
+void logWrite(uint8_t level, uint8_t id, uint32_t arg0, uint32_t arg1);
+void setLogLevel(uint32_t level);
+void logProcess(void);
+
+#endif /* LOG_H_ */
@@ -0,0 +1,272 @@
+/*
+ * meccano_protocol.c
+ *
+ * Purpose:  Build the frames sent to a chain of Meccano smart modules and
+ *           decode their replies.  The bit timing on the wire is handled
+ *           by Meccano.c, this file only deals with bytes so that it can
+ *           be driven by anything that moves bytes.
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "meccano_protocol.h"
+
+
+/*    Frame format
+
+  The datastream consists of 6 output bytes sent to the Smart modules and one return input byte from the Smart modules.
+  Since there can be a maximum of 4 Smart modules in a chain, each module takes turns replying along the single data wire.
+
+  Output bytes:
+      0xFF - the first byte is always a header byte of 0xFF
+      Data 1 -  the second byte is the data for the Smart module at the 1st position in the chain
+      Data 2 -  the third byte is the data for the Smart module at the 2nd position in the chain
+      Data 3 -  the fourth byte is the data for the Smart module at the 3rd position in the chain
+      Data 4 -  the fifth byte is the data for the Smart module at the 4th position in the chain
+      Checksum  -  the sixth byte is part checksum, part module ID.  The module ID tells which of the modules in the chain should reply
+   end  */
+
+
+/*-----------------------------------------------------------------*/
+/* Function:   meccanoChainInit
+ * Purpose:    Reset a chain to its power-up state: every module unknown
+ *             and asked to announce itself
+ * In/out arg: chain_p = chain to reset
+ */
+void meccanoChainInit(struct meccano_chain* chain_p)
+{
+    int i;
+
+    for(i = 0; i < MECCANO_MODULE_NBR; i++)
+    {
+        chain_p->type[i] = MECCANO_TYPE_UNKNOWN;
+        chain_p->outputByte[i] = MECCANO_DISCOVER;
+        chain_p->servoColor[i] = 0;
+        chain_p->moduleInput[i] = 0;
+        chain_p->noneCount[i] = 0;
+    }
+    chain_p->moduleNum = 0;
+    chain_p->pollMask = MECCANO_POLL_ALL;
+    chain_p->inputModule = 0;
+    chain_p->inputByte = 0;
+    chain_p->ledByte1 = 0x03;
+    chain_p->ledByte2 = 0x07;
+    chain_p->ledFrameByte2 = chain_p->ledByte2;
+    chain_p->ledOrder = 0;
+    chain_p->retry = 0;
+    chain_p->frames = 0;
+    meccanoErrorsClear(chain_p);
+}
+
+
+/*-----------------------------------------------------------------*/
+/* Function:   meccanoErrorsClear
+ * Purpose:    Reset the error counters of a chain, the frame count
+ *             is a metric and keeps running
+ * In/out arg: chain_p = chain to reset
+ */
+void meccanoErrorsClear(struct meccano_chain* chain_p)
+{
+    int i;
+
+    for(i = 0; i < MECCANO_MODULE_NBR; i++)
+    {
+        chain_p->timeouts[i] = 0;
+        chain_p->badReplies[i] = 0;
+        chain_p->rediscoveries[i] = 0;
+    }
+}
+
+
+/*-----------------------------------------------------------------*/
+/* Function:   meccanoCheckSum
+ * Purpose:    Compute the last byte of a frame, which is part checksum
+ *             and part ID of the module that should reply
+ * Input arg:  data_p = the 4 data bytes of the frame
+ *             moduleNum = module that should reply
+ * Return val: checksum byte
+ */
+uint8_t meccanoCheckSum(const uint8_t* data_p, uint8_t moduleNum)
+{
+    int CS;
+    CS =  data_p[0] + data_p[1] + data_p[2] + data_p[3];  // ignore overflow
+    CS = CS + (CS >> 8);                  // right shift 8 places
+    CS = CS + (CS << 4);                  // left shift 4 places
+    CS = CS & 0xF0;                       // mask off top nibble
+    CS = CS | moduleNum;
+    return CS;
+}
+
+
+/*-----------------------------------------------------------------*/
+/* Function:   meccanoFrameEncode
+ * Purpose:    Latch the output bytes into the next frame so that a set
+ *             point changed while the frame is on the wire cannot
+ *             desynchronise the checksum.  A one-shot servo colour
+ *             replaces the servo position for this frame only.  A retry
+ *             sends the previous frame again unchanged.
+ * In/out arg: chain_p = chain to encode, result in chain_p->frame
+ */
+void meccanoFrameEncode(struct meccano_chain* chain_p)
+{
+    int i;
+
+    chain_p->frames++;
+    if(chain_p->retry)
+        return;
+
+    chain_p->frame[0] = MECCANO_HEADER;
+    for(i = 0; i < MECCANO_MODULE_NBR; i++)
+    {
+        chain_p->frame[i + 1] = chain_p->outputByte[i];
+        if(chain_p->servoColor[i] != 0)
+        {
+            if(chain_p->type[i] == MECCANO_TYPE_SERVO)
+                chain_p->frame[i + 1] = chain_p->servoColor[i];
+            chain_p->servoColor[i] = 0;
+        }
+    }
+    chain_p->frame[5] = meccanoCheckSum(&chain_p->frame[1], chain_p->moduleNum);
+}
+
+
+/*-----------------------------------------------------------------*/
+/* Function:   meccanoNextModule
+ * Purpose:    Select the module that has to reply to the next frame,
+ *             skipping the modules that are not in the poll mask
+ */
+static void meccanoNextModule(struct meccano_chain* chain_p)
+{
+    int i;
+
+    for(i = 0; i < MECCANO_MODULE_NBR; i++)
+    {
+        chain_p->moduleNum++;                             // increment to next module ID
+        if (chain_p->moduleNum >= MECCANO_MODULE_NBR)
+        {
+            chain_p->moduleNum = 0;
+        }
+        if((chain_p->pollMask == 0) || (chain_p->pollMask & (1 << chain_p->moduleNum)))
+            break;
+    }
+}
+
+
+/*-----------------------------------------------------------------*/
+/* Function:   meccanoReplyDecode
+ * Purpose:    Handle the reply of the addressed module: discovery, type
+ *             detection and LED colour alternation
+ * Input arg:  reply = byte received from the module
+ * In/out arg: chain_p = chain the reply belongs to
+ */
+void meccanoReplyDecode(struct meccano_chain* chain_p, uint8_t reply)
+{
+    uint8_t num = chain_p->moduleNum;
+
+    chain_p->retry = 0;
+
+    // The reply carries no checksum: during discovery only a few values
+    // make sense, anything else is a corrupted byte and is ignored below
+    if (chain_p->type[num] == MECCANO_TYPE_UNKNOWN &&
+        reply != MECCANO_REPLY_NONE && reply != MECCANO_REPLY_SERVO &&
+        reply != MECCANO_REPLY_LED && reply != MECCANO_REPLY_PRESENT)
+    {
+        chain_p->badReplies[num]++;
+    }
+
+    chain_p->inputModule = num;
+    chain_p->inputByte = reply;
+    chain_p->moduleInput[num] = reply;
+
+    // if received back 0xFE, then the module exists so get ID number
+    if (reply == MECCANO_REPLY_PRESENT)
+    {
+        chain_p->outputByte[num] = MECCANO_IDENTIFY;
+    }
+
+    // if received back 0x01 (module ID is a servo), then change servo color to Blue
+    if (reply == MECCANO_REPLY_SERVO && chain_p->type[num] == MECCANO_TYPE_UNKNOWN)
+    {
+        chain_p->outputByte[num] = MECCANO_SERVO_BLUE;
+        chain_p->type[num] = MECCANO_TYPE_SERVO;
+    }
+
+    if (chain_p->type[num] == MECCANO_TYPE_LED)
+    {
+        if(chain_p->ledOrder == 0)
+        {
+            // Take both bytes together so that a colour change never
+            // mixes the halves of two different colours
+            chain_p->outputByte[num] = chain_p->ledByte1;
+            chain_p->ledFrameByte2 = chain_p->ledByte2;
+            chain_p->ledOrder = 1;
+        }else
+        {
+            chain_p->outputByte[num] = chain_p->ledFrameByte2;
+            chain_p->ledOrder = 0;
+        }
+    }
+
+    // if received back 0x02 (module ID is a LED), then change LED color to Blue
+    if (reply == MECCANO_REPLY_LED && chain_p->type[num] == MECCANO_TYPE_UNKNOWN)
+    {
+        chain_p->ledByte1 = 0x04;
+        chain_p->ledByte2 = 0x47;
+        chain_p->outputByte[num] = chain_p->ledByte1;
+        chain_p->ledFrameByte2 = chain_p->ledByte2;
+        chain_p->ledOrder = 1;
+        chain_p->type[num] = MECCANO_TYPE_LED;
+    }
+
+    // if received back 0x00, the module and all following ones are gone.
+    // A known module has to say so MECCANO_RESET_DEBOUNCE times in a row,
+    // so that a single glitch does not force a rediscovery of the chain.
+    if(reply == MECCANO_REPLY_NONE)
+    {
+        int x;
+        if(chain_p->type[num] == MECCANO_TYPE_UNKNOWN ||
+           ++chain_p->noneCount[num] >= MECCANO_RESET_DEBOUNCE)
+        {
+            for(x = num; x < MECCANO_MODULE_NBR; x++)
+            {
+                if(chain_p->type[x] != MECCANO_TYPE_UNKNOWN)
+                    chain_p->rediscoveries[x]++;
+                chain_p->outputByte[x] = MECCANO_DISCOVER;
+                chain_p->type[x] = MECCANO_TYPE_UNKNOWN;
+                chain_p->noneCount[x] = 0;
+            }
+        }
+    }
+    else
+    {
+        chain_p->noneCount[num] = 0;
+    }
+
+    meccanoNextModule(chain_p);
+}
+
+
+/*-----------------------------------------------------------------*/
+/* Function:   meccanoReplyTimeout
+ * Purpose:    Handle a missing reply of the addressed module.  A known
+ *             module is asked once more with the same frame before the
+ *             chain moves on, a module still being discovered is not.
+ * In/out arg: chain_p = chain that timed out
+ * Return val: true if the frame has to be sent again right away
+ */
+bool meccanoReplyTimeout(struct meccano_chain* chain_p)
+{
+    /* Error: no Meccano response */
+    chain_p->timeouts[chain_p->moduleNum]++;
+    if(!chain_p->retry && chain_p->type[chain_p->moduleNum] != MECCANO_TYPE_UNKNOWN)
+    {
+        chain_p->retry = 1;
+        return true;
+    }
+    chain_p->retry = 0;
+    meccanoNextModule(chain_p);
+    return false;
+}
@@ -0,0 +1,76 @@
+/*
+ * meccano_protocol.h
+ *
+ * Purpose:  Encoder/decoder of the Meccano smart module protocol, free of
+ *           any GPIO or timer access.
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+
+#ifndef MECCANO_PROTOCOL_H_
+#define MECCANO_PROTOCOL_H_
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+/* Frame Definitions */
+#define MECCANO_MODULE_NBR		4		// maximum number of modules in a chain
+#define MECCANO_FRAME_SIZE		6		// header, 4 data bytes, checksum
+#define MECCANO_POLL_ALL		0x0F	// every module is asked to reply in turn
+#define MECCANO_RESET_DEBOUNCE	2		// 0x00 replies before a known module is dropped
+
+/* Output Byte Definitions */
+#define MECCANO_HEADER			0xFF	// first byte of every frame
+#define MECCANO_DISCOVER		0xFE	// asks an unknown module to answer
+#define MECCANO_IDENTIFY		0xFC	// asks a present module for its type
+#define MECCANO_LIM				0xFA	// sets a servo to LIM mode
+#define MECCANO_SERVO_BLUE		0xF4	// servo colour set once identified
+
+/* Reply Definitions */
+#define MECCANO_REPLY_NONE		0x00	// module left the chain
+#define MECCANO_REPLY_SERVO		0x01
+#define MECCANO_REPLY_LED		0x02
+#define MECCANO_REPLY_PRESENT	0xFE
+
+/* Module Type Definitions */
+#define MECCANO_TYPE_UNKNOWN	'_'
+#define MECCANO_TYPE_SERVO		'S'
+#define MECCANO_TYPE_LED		'L'
+
+struct meccano_chain {
+   uint8_t type[MECCANO_MODULE_NBR];			// MECCANO_TYPE_x of every module
+   uint8_t outputByte[MECCANO_MODULE_NBR];		// data sent to every module
+   uint8_t servoColor[MECCANO_MODULE_NBR];		// one-shot servo colours, 0 if none
+   uint8_t frame[MECCANO_FRAME_SIZE];			// frame being sent
+   uint8_t moduleInput[MECCANO_MODULE_NBR];		// last reply of every module
+   uint8_t moduleNum;							// module asked to reply
+   uint8_t pollMask;							// modules asked to reply in turn
+   uint8_t inputModule;							// module of the last reply
+   uint8_t inputByte;							// last reply
+   uint8_t ledByte1;							// requested LED colour
+   uint8_t ledByte2;
+   uint8_t ledFrameByte2;						// second byte of the colour being sent
+   uint8_t ledOrder;
+   uint8_t retry;								// the current frame is a retry
+   uint8_t noneCount[MECCANO_MODULE_NBR];		// consecutive 0x00 replies
+   uint32_t frames;								// frames sent, free running
+   // Error accounting, cleared by meccanoErrorsClear()
+   uint32_t timeouts[MECCANO_MODULE_NBR];		// frames without reply
+   uint32_t badReplies[MECCANO_MODULE_NBR];		// replies that do not fit the byte sent
+   uint32_t rediscoveries[MECCANO_MODULE_NBR];	// known modules dropped from the chain
+};
+
+void meccanoChainInit(struct meccano_chain* chain_p);
+uint8_t meccanoCheckSum(const uint8_t* data_p, uint8_t moduleNum);
+void meccanoFrameEncode(struct meccano_chain* chain_p);
+void meccanoReplyDecode(struct meccano_chain* chain_p, uint8_t reply);
+bool meccanoReplyTimeout(struct meccano_chain* chain_p);
+void meccanoErrorsClear(struct meccano_chain* chain_p);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif /* MECCANO_PROTOCOL_H_ */
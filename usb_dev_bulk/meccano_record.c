@@ -0,0 +1,283 @@
+/*
+ * meccano_record.c
+ *
+ * Purpose:  Teach-and-replay of the Meccano smart servos.  The recorded
+ *           servos are put in LIM mode and polled as fast as the wire
+ *           allows, their positions are stored with a time stamp and then
+ *           reduced to the keyframes of the movement timeline.
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "linked_list_dbl.h"
+#include "timer_handler.h"
+#include "Meccano.h"
+#include "meccano_record.h"
+
+//*****************************************************************************
+//
+// Record buffers.
+//
+//*****************************************************************************
+uint8_t meccanoRecordMask = 0;
+
+struct lim_sample lim_sample[RECORD_SAMPLE_MAX];
+uint32_t lim_sample_nbr = 0;
+struct lim_keyframe lim_keyframe[RECORD_KEYFRAME_MAX];
+uint32_t lim_keyframe_nbr = 0;
+
+static uint32_t record_start_time;
+static uint8_t record_last_pos[MECCANO_MODULE_NBR];
+static uint8_t record_tolerance;
+static volatile bool record_compress = false;
+
+
+/*-----------------------------------------------------------------*/
+/* Function:   meccanoRecordStart
+ * Purpose:    Put the selected servos in LIM mode and start sampling
+ *             their positions at the maximum frame rate
+ * Input arg:  servoMask = bit n set to record servo n of the head chain
+ */
+void meccanoRecordStart(uint8_t servoMask)
+{
+	int i;
+
+	servoMask &= MECCANO_POLL_ALL;
+	for(i = 0; i < MECCANO_MODULE_NBR; i++)
+	{
+		if(meccanoChain[MECCANO_HEAD].type[i] != MECCANO_TYPE_SERVO)
+			servoMask &= ~(1 << i);
+	}
+	if(servoMask == 0)
+		return;
+
+	lim_sample_nbr = 0;
+	lim_keyframe_nbr = 0;
+	record_start_time = milli_second;
+	for(i = 0; i < MECCANO_MODULE_NBR; i++)
+	{
+		record_last_pos[i] = meccanoServoSetpoint[i];
+		if(servoMask & (1 << i))
+			setMeccanoServotoLIM(i);
+	}
+	meccanoRecordMask = servoMask;
+
+	// Only the recorded servos are polled, as fast as they can answer
+	meccanoChain[MECCANO_HEAD].pollMask = servoMask;
+	meccanoFrameGap = TIMER_LOADVALUE_3000US;
+}
+
+
+/*-----------------------------------------------------------------*/
+/* Function:   meccanoRecordStop
+ * Purpose:    Stop recording, hold the servos where they were left and
+ *             ask the main loop to compress the record
+ * Input arg:  tolerance = maximum position error of the keyframes
+ */
+void meccanoRecordStop(uint8_t tolerance)
+{
+	int i;
+	uint8_t servoMask = meccanoRecordMask;
+
+	if(servoMask == 0)
+		return;
+
+	meccanoRecordMask = 0;
+	meccanoChain[MECCANO_HEAD].pollMask = MECCANO_POLL_ALL;
+	meccanoFrameGap = TIMER_LOADVALUE_10MS;
+	for(i = 0; i < MECCANO_MODULE_NBR; i++)
+	{
+		if(servoMask & (1 << i))
+			setMeccanoServoPosition(i, record_last_pos[i]);
+	}
+	record_tolerance = tolerance;
+	record_compress = true;
+}
+
+
+/*-----------------------------------------------------------------*/
+/* Function:   meccanoRecordSample
+ * Purpose:    Store the reply of a recorded servo, called by the Meccano
+ *             handler after each reply
+ * Input arg:  chain_p = chain that has just been decoded
+ */
+void meccanoRecordSample(struct meccano_chain* chain_p)
+{
+	uint8_t num = chain_p->inputModule;
+
+	if((meccanoRecordMask & (1 << num)) == 0)
+		return;
+	// The reply is a position only if the servo was sent the LIM byte
+	if(chain_p->frame[num + 1] != MECCANO_LIM)
+		return;
+	if((chain_p->inputByte == MECCANO_REPLY_NONE) || (chain_p->inputByte > 0xEF))
+		return;
+
+	lim_sample[lim_sample_nbr].ms_time = milli_second - record_start_time;
+	lim_sample[lim_sample_nbr].servo = num;
+	lim_sample[lim_sample_nbr].position = chain_p->inputByte;
+	record_last_pos[num] = chain_p->inputByte;
+	lim_sample_nbr++;
+	if(lim_sample_nbr >= RECORD_SAMPLE_MAX)
+		meccanoRecordStop(record_tolerance);
+}
+
+
+/*-----------------------------------------------------------------*/
+/* Function:   nextSample
+ * Purpose:    Find the next sample of a servo in the record
+ * Input arg:  index = sample to start after, -1 to start at the beginning
+ *             servo = servo to look for
+ * Return val: index of the sample, -1 if there is none
+ */
+static int32_t nextSample(int32_t index, uint8_t servo)
+{
+	for(index++; index < (int32_t)lim_sample_nbr; index++)
+	{
+		if(lim_sample[index].servo == servo)
+			return index;
+	}
+	return -1;
+}
+
+
+/*-----------------------------------------------------------------*/
+/* Function:   segmentFits
+ * Purpose:    Check that every sample between two samples of a servo is
+ *             within the tolerance of the straight line joining them
+ * Input args: first, last = samples at both ends of the segment
+ *             servo = servo of the segment
+ * Return val: true if the segment can replace the samples
+ */
+static bool segmentFits(int32_t first, int32_t last, uint8_t servo)
+{
+	int32_t k;
+	int32_t t0 = lim_sample[first].ms_time;
+	int32_t p0 = lim_sample[first].position;
+	int32_t dt = lim_sample[last].ms_time - t0;
+	int32_t dp = lim_sample[last].position - p0;
+
+	for(k = nextSample(first, servo); (k >= 0) && (k < last); k = nextSample(k, servo))
+	{
+		int32_t p = p0 + dp * ((int32_t)lim_sample[k].ms_time - t0) / dt;
+		if(abs(p - lim_sample[k].position) > record_tolerance)
+			return false;
+	}
+	return true;
+}
+
+
+/*-----------------------------------------------------------------*/
+/* Function:   addKeyframe
+ * Purpose:    Append a keyframe to the compressed record, the times are
+ *             relative to the start of the replay
+ */
+static void addKeyframe(uint8_t servo, uint32_t start, uint32_t stop, uint8_t position)
+{
+	if(lim_keyframe_nbr >= RECORD_KEYFRAME_MAX)
+		return;
+	lim_keyframe[lim_keyframe_nbr].servo = servo;
+	lim_keyframe[lim_keyframe_nbr].ms_time_start = start;
+	lim_keyframe[lim_keyframe_nbr].ms_time_stop = stop;
+	lim_keyframe[lim_keyframe_nbr].position = position;
+	lim_keyframe_nbr++;
+}
+
+
+/*-----------------------------------------------------------------*/
+/* Function:   compressServo
+ * Purpose:    Reduce the samples of one servo to the smallest set of
+ *             linear segments staying within the tolerance
+ * Input arg:  servo = servo to compress
+ */
+static void compressServo(uint8_t servo)
+{
+	int32_t anchor;
+	int32_t last_ok;
+	int32_t end;
+
+	anchor = nextSample(-1, servo);
+	if(anchor < 0)
+		return;
+
+	// Reach the first recorded pose during the lead-in time
+	addKeyframe(servo,
+				0,
+				RECORD_LEAD_IN_MS + lim_sample[anchor].ms_time,
+				lim_sample[anchor].position);
+
+	last_ok = anchor;
+	end = nextSample(anchor, servo);
+	while(end >= 0)
+	{
+		if(segmentFits(anchor, end, servo))
+		{
+			last_ok = end;
+			end = nextSample(end, servo);
+		}
+		else
+		{
+			addKeyframe(servo,
+						RECORD_LEAD_IN_MS + lim_sample[anchor].ms_time,
+						RECORD_LEAD_IN_MS + lim_sample[last_ok].ms_time,
+						lim_sample[last_ok].position);
+			anchor = last_ok;
+		}
+	}
+	if(last_ok != anchor)
+	{
+		addKeyframe(servo,
+					RECORD_LEAD_IN_MS + lim_sample[anchor].ms_time,
+					RECORD_LEAD_IN_MS + lim_sample[last_ok].ms_time,
+					lim_sample[last_ok].position);
+	}
+}
+
+
+/*-----------------------------------------------------------------*/
+/* Function:   meccanoRecordProcess
+ * Purpose:    Compress a finished record, called from the main loop as
+ *             it is too long for an interrupt handler
+ */
+void meccanoRecordProcess(void)
+{
+	int i;
+
+	if(!record_compress)
+		return;
+	record_compress = false;
+
+	lim_keyframe_nbr = 0;
+	for(i = 0; i < MECCANO_MODULE_NBR; i++)
+		compressServo(i);
+}
+
+
+/*-----------------------------------------------------------------*/
+/* Function:   meccanoRecordReplay
+ * Purpose:    Charge the compressed record into the Meccano servo
+ *             lists, it is then started like any other movement
+ * Return val: false when the lists are full, the keyframes charged
+ *             until then are kept
+ */
+bool meccanoRecordReplay(void)
+{
+	uint32_t k;
+
+	for(k = 0; k < lim_keyframe_nbr; k++)
+		Free_list(&meccano_servo_list[lim_keyframe[k].servo]);
+	for(k = 0; k < lim_keyframe_nbr; k++)
+	{
+		if(!Insert(&meccano_servo_list[lim_keyframe[k].servo],
+				   lim_keyframe[k].ms_time_start,
+				   lim_keyframe[k].ms_time_stop,
+				   lim_keyframe[k].position,
+				   0))
+			return false;
+	}
+	return true;
+}
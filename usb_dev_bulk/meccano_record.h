@@ -0,0 +1,46 @@
+/*
+ * meccano_record.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+
+#ifndef MECCANO_RECORD_H_
+#define MECCANO_RECORD_H_
+
+//*****************************************************************************
+//
+// Record buffer sizes.
+//
+//*****************************************************************************
+#define RECORD_SAMPLE_MAX			1024	// LIM samples of all servos
+#define RECORD_KEYFRAME_MAX			128		// keyframes after compression
+#define RECORD_LEAD_IN_MS			1000	// time to reach the first recorded pose
+
+struct lim_sample {
+   uint32_t ms_time;		// time since the start of the record
+   uint8_t servo;
+   uint8_t position;
+};
+
+struct lim_keyframe {
+   uint32_t ms_time_start;
+   uint32_t ms_time_stop;
+   uint8_t servo;
+   uint8_t position;
+};
+
+extern uint8_t meccanoRecordMask;			// servos being recorded, 0 if none
+
+extern struct lim_sample lim_sample[RECORD_SAMPLE_MAX];
+extern uint32_t lim_sample_nbr;
+extern struct lim_keyframe lim_keyframe[RECORD_KEYFRAME_MAX];
+extern uint32_t lim_keyframe_nbr;
+
+void meccanoRecordStart(uint8_t servoMask);
+void meccanoRecordStop(uint8_t tolerance);
+void meccanoRecordSample(struct meccano_chain* chain_p);
+void meccanoRecordProcess(void);
+bool meccanoRecordReplay(void);
+
+#endif /* MECCANO_RECORD_H_ */
@@ -0,0 +1,230 @@
+/*
+ * meccano_sequence.c
+ *
+ * Purpose:  Play colour sequences on the Meccano smart LED and on the LEDs of
+ *           the Meccano smart servos without any further host traffic.
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "linked_list_dbl.h"
+#include "timer_handler.h"
+#include "Meccano.h"
+#include "meccano_sequence.h"
+
+//*****************************************************************************
+//
+// Meccano LED fade codes 0 - 7 expressed in ms.
+//
+//*****************************************************************************
+const uint16_t meccanoFadeTime[8] = {0, 200, 500, 800, 1000, 2000, 3000, 4000};
+
+//*****************************************************************************
+//
+// Sequence storage: one sequence for the smart LED and one per smart servo.
+//
+//*****************************************************************************
+static struct colour_keyframe led_keyframe[LED_SEQ_KEYFRAME_MAX];
+static struct colour_keyframe servo_keyframe[MECCANO_MODULE_NBR][SERVO_SEQ_KEYFRAME_MAX];
+
+static struct colour_sequence led_sequence;
+static struct colour_sequence servo_sequence[MECCANO_MODULE_NBR];
+
+
+/*-----------------------------------------------------------------*/
+/* Function:   sequenceApply
+ * Purpose:    Send the current keyframe of a sequence to its module
+ * Input arg:  seq = sequence to apply
+ *             servoNum = servo position in the chain or MECCANO_MODULE_NBR
+ *                        for the smart LED
+ */
+static void sequenceApply(struct colour_sequence* seq, uint8_t servoNum)
+{
+	struct colour_keyframe* kf = &seq->keyframe[seq->index];
+
+	if(servoNum < MECCANO_MODULE_NBR)
+	{
+		setMeccanoServoColorOnce(servoNum, kf->byte1);
+	}
+	else
+	{
+		// Both LED bytes are picked up together by the Meccano handler
+		meccanoChain[MECCANO_HEAD].ledByte1 = kf->byte1;
+		meccanoChain[MECCANO_HEAD].ledByte2 = kf->byte2;
+	}
+}
+
+
+/*-----------------------------------------------------------------*/
+/* Function:   sequenceStep
+ * Purpose:    Advance a sequence when its current keyframe has elapsed
+ * Input arg:  seq = sequence to advance
+ *             servoNum = see sequenceApply
+ *             ms_time = actual millisecond tick
+ */
+static void sequenceStep(struct colour_sequence* seq, uint8_t servoNum, uint32_t ms_time)
+{
+	if(!seq->running || ((int32_t)(ms_time - seq->next_time) < 0))
+		return;
+
+	seq->index++;
+	if(seq->index >= seq->keyframe_nbr)
+	{
+		seq->index = 0;
+		if(seq->loops != SEQ_LOOP_FOREVER)
+		{
+			seq->loop_count++;
+			if(seq->loop_count >= seq->loops)
+			{
+				// Keep the colour of the last keyframe
+				seq->running = false;
+				return;
+			}
+		}
+	}
+	sequenceApply(seq, servoNum);
+	seq->next_time += seq->keyframe[seq->index].ms_duration;
+}
+
+
+/*-----------------------------------------------------------------*/
+/* Function:   sequenceStart
+ * Purpose:    Start a sequence from its first keyframe
+ */
+static void sequenceStart(struct colour_sequence* seq, uint8_t servoNum, uint32_t ms_time)
+{
+	if(seq->keyframe_nbr == 0)
+		return;
+	seq->index = 0;
+	seq->loop_count = 0;
+	seq->next_time = ms_time + seq->keyframe[0].ms_duration;
+	sequenceApply(seq, servoNum);
+	seq->running = true;
+}
+
+
+void meccanoSequenceInit(void)
+{
+	int i;
+
+	led_sequence.keyframe = led_keyframe;
+	led_sequence.keyframe_max = LED_SEQ_KEYFRAME_MAX;
+	led_sequence.keyframe_nbr = 0;
+	led_sequence.running = false;
+	for(i = 0; i < MECCANO_MODULE_NBR; i++)
+	{
+		servo_sequence[i].keyframe = servo_keyframe[i];
+		servo_sequence[i].keyframe_max = SERVO_SEQ_KEYFRAME_MAX;
+		servo_sequence[i].keyframe_nbr = 0;
+		servo_sequence[i].running = false;
+	}
+}
+
+
+/* setMeccanoLEDSequence(byte loops)  ->  stops the smart LED sequence and clears its keyframes
+LOOPS is the number of times the sequence is played, 0 plays it forever.
+Keyframes are then added with addMeccanoLEDKeyframe() and the sequence is started with startMeccanoSequence().
+
+   end  */
+
+void setMeccanoLEDSequence(uint8_t loops)
+{
+	led_sequence.running = false;
+	led_sequence.keyframe_nbr = 0;
+	led_sequence.loops = loops;
+}
+
+
+/* addMeccanoLEDKeyframe(byte red, byte green, byte blue, byte fadetime, int hold)  ->  appends a colour to the smart LED sequence
+RED, GREEN, BLUE and FADETIME are the same as for setMeccanoLEDColor().
+The next keyframe is applied once the fade time of this one plus HOLD ms have elapsed.
+
+   end  */
+
+void addMeccanoLEDKeyframe(uint8_t red, uint8_t green, uint8_t blue,
+						   uint8_t fadetime, uint16_t ms_hold)
+{
+	struct colour_keyframe* kf;
+
+	if(led_sequence.keyframe_nbr >= led_sequence.keyframe_max)
+		return;
+	kf = &led_sequence.keyframe[led_sequence.keyframe_nbr];
+	kf->byte1 = 0x3F & (((green << 3) & 0x38) | (red & 0x07));
+	kf->byte2 = 0x40 | (((fadetime << 3) & 0x38) | (blue & 0x07));
+	kf->ms_duration = meccanoFadeTime[fadetime & 0x07] + ms_hold;
+	led_sequence.keyframe_nbr++;
+}
+
+
+/* setMeccanoServoColorSequence(int servoNum, byte loops)  ->  stops the colour sequence of a smart servo and clears its keyframes
+
+   end  */
+
+void setMeccanoServoColorSequence(uint8_t servoNum, uint8_t loops)
+{
+	if(servoNum >= MECCANO_MODULE_NBR)
+		return;
+	servo_sequence[servoNum].running = false;
+	servo_sequence[servoNum].keyframe_nbr = 0;
+	servo_sequence[servoNum].loops = loops;
+}
+
+
+/* addMeccanoServoColorKeyframe(int servoNum, byte color, int hold)  ->  appends a colour to the sequence of a smart servo
+COLOR is a value 0xF0 - 0xF7 as for setMeccanoServoColor(), held for HOLD ms.
+
+   end  */
+
+void addMeccanoServoColorKeyframe(uint8_t servoNum, uint8_t color, uint16_t ms_hold)
+{
+	struct colour_sequence* seq;
+
+	if(servoNum >= MECCANO_MODULE_NBR)
+		return;
+	seq = &servo_sequence[servoNum];
+	if(seq->keyframe_nbr >= seq->keyframe_max)
+		return;
+	seq->keyframe[seq->keyframe_nbr].byte1 = 0xF0 | (color & 0x07);
+	seq->keyframe[seq->keyframe_nbr].byte2 = 0;
+	seq->keyframe[seq->keyframe_nbr].ms_duration = ms_hold;
+	seq->keyframe_nbr++;
+}
+
+
+/*-----------------------------------------------------------------*/
+/* Function:   startMeccanoSequence
+ * Purpose:    Start the selected sequences at the same tick
+ * Input arg:  mask = bit 0 for the smart LED, bits 1 - 4 for the
+ *                    smart servos 0 - 3
+ */
+void startMeccanoSequence(uint8_t mask)
+{
+	int i;
+	uint32_t ms_time = milli_second;
+
+	if(mask & 0x01)
+		sequenceStart(&led_sequence, MECCANO_MODULE_NBR, ms_time);
+	for(i = 0; i < MECCANO_MODULE_NBR; i++)
+	{
+		if(mask & (0x02 << i))
+			sequenceStart(&servo_sequence[i], i, ms_time);
+	}
+}
+
+
+/*-----------------------------------------------------------------*/
+/* Function:   meccanoSequenceUpdate
+ * Purpose:    Advance all running sequences, called every millisecond
+ * Input arg:  ms_time = actual millisecond tick
+ */
+void meccanoSequenceUpdate(uint32_t ms_time)
+{
+	int i;
+
+	sequenceStep(&led_sequence, MECCANO_MODULE_NBR, ms_time);
+	for(i = 0; i < MECCANO_MODULE_NBR; i++)
+		sequenceStep(&servo_sequence[i], i, ms_time);
+}
@@ -0,0 +1,49 @@
+/*
+ * meccano_sequence.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+
+#ifndef MECCANO_SEQUENCE_H_
+#define MECCANO_SEQUENCE_H_
+
+//*****************************************************************************
+//
+// Sequence sizes.
+//
+//*****************************************************************************
+#define LED_SEQ_KEYFRAME_MAX		16		// colour keyframes of the Meccano LED
+#define SERVO_SEQ_KEYFRAME_MAX		8		// colour keyframes per Meccano servo
+#define SEQ_LOOP_FOREVER			0		// loop count of an endless sequence
+
+struct colour_keyframe {
+   uint8_t byte1;			// LED: green/red byte, servo: colour 0xF0 - 0xF7
+   uint8_t byte2;			// LED: fade/blue byte, servo: unused
+   uint16_t ms_duration;	// time until the next keyframe is applied
+};
+
+struct colour_sequence {
+   struct colour_keyframe* keyframe;
+   uint8_t keyframe_max;
+   uint8_t keyframe_nbr;
+   uint8_t index;
+   uint8_t loops;			// SEQ_LOOP_FOREVER or number of runs
+   uint8_t loop_count;
+   bool running;
+   uint32_t next_time;
+};
+
+// Meccano LED fade codes 0 - 7 expressed in ms
+extern const uint16_t meccanoFadeTime[8];
+
+void meccanoSequenceInit(void);
+void setMeccanoLEDSequence(uint8_t loops);
+void addMeccanoLEDKeyframe(uint8_t red, uint8_t green, uint8_t blue,
+						   uint8_t fadetime, uint16_t ms_hold);
+void setMeccanoServoColorSequence(uint8_t servoNum, uint8_t loops);
+void addMeccanoServoColorKeyframe(uint8_t servoNum, uint8_t color, uint16_t ms_hold);
+void startMeccanoSequence(uint8_t mask);
+void meccanoSequenceUpdate(uint32_t ms_time);
+
+#endif /* MECCANO_SEQUENCE_H_ */
@@ -0,0 +1,83 @@
+/*
+ * memory.c
+ *
+ * Purpose:  Stack and heap usage.  The free part of the stack is painted
+ *           at start-up and the main loop looks for the lowest word that
+ *           was overwritten, which gives the deepest use of the stack by
+ *           the main loop and the interrupt handlers together.
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "timer_handler.h"
+#include "log.h"
+#include "memory.h"
+
+//*****************************************************************************
+//
+// Symbols of the linker: bottom and top of the stack, size of the heap.
+//
+//*****************************************************************************
+extern uint32_t __stack;
+extern uint32_t __STACK_TOP;
+extern uint32_t __SYSMEM_SIZE;
+
+uint32_t stackSize;
+uint32_t stackPeak = 0;
+uint32_t heapSize;
+
+static uint32_t lastScan;
+static bool stackWarned = false;
+
+
+//*****************************************************************************
+//
+// Paints the stack below the current frame, to be called first in main()
+// before any interrupt is enabled.
+//
+//*****************************************************************************
+void memoryInit(void)
+{
+	volatile uint32_t marker;
+	volatile uint32_t *p;
+
+	stackSize = (uint32_t)&__STACK_TOP - (uint32_t)&__stack;
+	heapSize = (uint32_t)&__SYSMEM_SIZE;
+
+	// Keep a few words of margin under the frame of this function
+	for(p = &__stack; p < &marker - 8; p++)
+		*p = MEMORY_STACK_PAINT;
+	lastScan = milli_second;
+}
+
+
+//*****************************************************************************
+//
+// Updates the stack high-water mark, called from the main loop.
+//
+//*****************************************************************************
+void memoryUpdate(void)
+{
+	volatile uint32_t *p;
+	uint32_t used;
+
+	if((milli_second - lastScan) < MEMORY_SCAN_PERIOD_MS)
+		return;
+	lastScan = milli_second;
+
+	for(p = &__stack; (p < &__STACK_TOP) && (*p == MEMORY_STACK_PAINT); p++)
+		;
+	used = (uint32_t)&__STACK_TOP - (uint32_t)p;
+	if(used > stackPeak)
+	{
+		stackPeak = used;
+		if(!stackWarned && (stackPeak > (stackSize * MEMORY_STACK_WARN) / 1024))
+		{
+			stackWarned = true;
+			LOG_WARN(LOG_STACK_LOW, stackPeak, stackSize);
+		}
+	}
+}
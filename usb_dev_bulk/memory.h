@@ -0,0 +1,23 @@
+/*
+ * memory.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+
+#ifndef MEMORY_H_
+#define MEMORY_H_
+
+#define MEMORY_STACK_PAINT			0xC5C5C5C5	// pattern of the stack never used
+#define MEMORY_SCAN_PERIOD_MS		100			// ms between two stack scans
+#define MEMORY_STACK_WARN			(7 * 128)	// per 1024 of the stack, logged once
+
+extern uint32_t stackSize;					// bytes
+extern uint32_t stackPeak;					// most bytes ever used
+extern uint32_t heapSize;					// bytes given to malloc
+
+
+void memoryInit(void);
+void memoryUpdate(void);
+
+#endif /* MEMORY_H_ */
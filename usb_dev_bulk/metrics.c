@@ -0,0 +1,121 @@
+/*
+ * metrics.c
+ *
+ * Purpose:  Counters of the whole firmware, read by the host in one
+ *           transfer.  The counters are plain increments where the events
+ *           happen, this module only knows where to find them.
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include "usblib/usblib.h"
+#include "usblib/device/usbdevice.h"
+#include "usblib/device/usbdbulk.h"
+
+#include "usb_bulk_structs.h"
+#include "protocol.h"
+#include "linked_list_dbl.h"
+#include "timer_handler.h"
+#include "dc_motor.h"
+#include "Meccano.h"
+#include "log.h"
+#include "metrics.h"
+
+
+extern volatile uint32_t g_ui32RxCount;
+extern volatile uint32_t g_ui32TxCount;
+extern struct list_s left_arm_list[4];
+extern struct list_s right_arm_list[4];
+
+uint32_t metricsParseErrors = 0;
+uint32_t metricsPwmCommits = 0;
+uint32_t metricsTickOverruns = 0;
+uint16_t metricsCommands[METRICS_OPCODE_NBR];
+
+struct metric {
+   uint8_t id;
+   const volatile uint32_t *value_p;
+};
+
+//*****************************************************************************
+//
+// The registry: new counters only need a line here.
+//
+//*****************************************************************************
+static const struct metric metricsTable[] = {
+	{METRIC_USB_RX_BYTES,		&g_ui32RxCount},
+	{METRIC_USB_TX_BYTES,		&g_ui32TxCount},
+	{METRIC_PARSE_ERRORS,		&metricsParseErrors},
+	{METRIC_KEYFRAMES_QUEUED,	&listInserted},
+	{METRIC_KEYFRAMES_EXECUTED,	&listRetired},
+	{METRIC_KEYFRAMES_REFUSED,	&listAllocFailures},
+	{METRIC_KEYFRAMES_FLUSHED,	&listFlushed},
+	{METRIC_MECCANO_FRAMES,		&meccanoChain[0].frames},
+	{METRIC_PWM_COMMITS,		&metricsPwmCommits},
+	{METRIC_TICK_OVERRUNS,		&metricsTickOverruns},
+};
+
+#define METRICS_NBR		(sizeof(metricsTable) / sizeof(metricsTable[0]))
+
+static uint8_t metricsBuffer[6 + 5 * METRICS_NBR + 8 + MECCANO_MODULE_NBR + DC_MOTOR_NBR +
+							 2 * METRICS_OPCODE_NBR];
+
+
+//*****************************************************************************
+//
+// Counts a command completely received.
+//
+//*****************************************************************************
+void metricsCommand(uint8_t opcode)
+{
+	if(opcode < METRICS_OPCODE_NBR)
+		metricsCommands[opcode]++;
+}
+
+
+//*****************************************************************************
+//
+// Sends every metric to the host, the reply starts with the opcode of the
+// command.
+//
+// Returns false when the transmit ring has no room for the whole reply,
+// nothing is sent then.
+//
+//*****************************************************************************
+bool metricsSend(uint8_t opcode)
+{
+	uint8_t *p = metricsBuffer;
+	uint32_t i;
+
+	*p++ = opcode;
+	p = protocolPut32(p, milli_second);
+	*p++ = METRICS_NBR;
+	for(i = 0; i < METRICS_NBR; i++)
+	{
+		*p++ = metricsTable[i].id;
+		p = protocolPut32(p, *metricsTable[i].value_p);
+	}
+
+	for(i = 0; i < 4; i++)
+		*p++ = (uint8_t)listLength(&left_arm_list[i]);
+	for(i = 0; i < 4; i++)
+		*p++ = (uint8_t)listLength(&right_arm_list[i]);
+	for(i = 0; i < MECCANO_MODULE_NBR; i++)
+		*p++ = (uint8_t)listLength(&meccano_servo_list[i]);
+	for(i = 0; i < DC_MOTOR_NBR; i++)
+		*p++ = (uint8_t)listLength(&dc_motor_list[i]);
+
+	for(i = 0; i < METRICS_OPCODE_NBR; i++)
+	{
+		p = protocolPut16(p, metricsCommands[i]);
+	}
+
+	if(USBSendPacket(metricsBuffer, p - metricsBuffer) == 0)
+	{
+		LOG_WARN(LOG_REPLY_DROPPED, opcode, p - metricsBuffer);
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,49 @@
+/*
+ * metrics.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+
+#ifndef METRICS_H_
+#define METRICS_H_
+
+//*****************************************************************************
+//
+// Metric IDs.  Every metric is a free running 32-bit counter, the host
+// gets the rates from two readings and their times.
+//
+//*****************************************************************************
+#define METRIC_USB_RX_BYTES			0x01
+#define METRIC_USB_TX_BYTES			0x02
+#define METRIC_PARSE_ERRORS			0x03	// unknown opcodes
+#define METRIC_KEYFRAMES_QUEUED		0x04
+#define METRIC_KEYFRAMES_EXECUTED	0x05
+#define METRIC_KEYFRAMES_REFUSED	0x06	// no memory left
+#define METRIC_KEYFRAMES_FLUSHED	0x07	// cleared before being executed
+#define METRIC_MECCANO_FRAMES		0x08
+#define METRIC_PWM_COMMITS			0x09
+#define METRIC_TICK_OVERRUNS		0x0A	// 1 ms ticks handled late
+
+//*****************************************************************************
+//
+// Reply to the metrics command, sent as one transfer of several packets:
+//   opcode, time (ms, 4 bytes), metric count, then per metric its ID and
+//   value (4 bytes), the action queue depths (1 byte each, left arm,
+//   right arm and Meccano servos 0 to 3, then left and right DC motors)
+//   and the commands completed per opcode (2 bytes each, opcodes 0x00 to
+//   METRICS_OPCODE_NBR - 1).
+//
+//*****************************************************************************
+#define METRICS_OPCODE_NBR			0x40
+
+extern uint32_t metricsParseErrors;
+extern uint32_t metricsPwmCommits;
+extern uint32_t metricsTickOverruns;
+extern uint16_t metricsCommands[METRICS_OPCODE_NBR];
+
+
+void metricsCommand(uint8_t opcode);
+bool metricsSend(uint8_t opcode);
+
+#endif /* METRICS_H_ */
@@ -0,0 +1,174 @@
+/*
+ * motion.c
+ *
+ * Purpose:  Keyframe interpolation of the arm servos and of the Meccano
+ *           smart servos.  The time is a parameter and the outputs go
+ *           through setServoPosition() and setMeccanoServoPosition(), so
+ *           a given list of actions and sequence of ticks always gives
+ *           the same positions.
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "linked_list_dbl.h"
+#include "servo.h"
+#include "Meccano.h"
+#include "trace.h"
+#include "latency.h"
+#include "event.h"
+#include "motion.h"
+
+//*****************************************************************************
+//
+// Linked list for servo motor movement.
+//
+//*****************************************************************************
+extern struct list_s left_arm_list[4];		// list contains the different actions
+extern struct list_s right_arm_list[4];		// list contains the different actions
+
+
+/*-----------------------------------------------------------------*/
+/* Function:   motionInterpolate
+ * Purpose:    Linear position between two positions
+ * Input arg:  initial = position at the start of the action
+ *             target = position at the end of the action
+ *             duration = length of the action (ms), not 0
+ *             remaining = time left until the end (ms), at most duration
+ * Return val: position
+ */
+uint32_t motionInterpolate(uint32_t initial, uint32_t target,
+						   uint32_t duration, uint32_t remaining)
+{
+	if(initial <= target)
+		return initial + (target - initial) * (duration - remaining) / duration;
+	else
+		return initial - (initial - target) * (duration - remaining) / duration;
+}
+
+
+/*-----------------------------------------------------------------*/
+/* Function:   motionStep
+ * Purpose:    Advances the first action of a list, and retires it once
+ *             its stop time is reached
+ * Input arg:  start_time = time at which the movement was started
+ *             now = current time (ms)
+ *             initial = position reached by the previous action
+ *             actuator = trace ID of the actuator
+ * In/out arg: list_p = action list of the actuator
+ * Output arg: pos_p = position to apply, for MOTION_MOVE and MOTION_DONE
+ * Return val: MOTION_IDLE, MOTION_WAIT, MOTION_MOVE or MOTION_DONE
+ */
+uint32_t motionStep(struct list_s* list_p, uint32_t start_time, uint32_t now,
+					uint32_t initial, uint8_t actuator, uint32_t *pos_p)
+{
+	struct list_node_s* node_p = list_p->h_p;
+	uint32_t duration;
+	uint32_t remaining;
+	uint32_t channel;
+
+	if(listIsEmpty(list_p))
+		return MOTION_IDLE;
+	if((start_time + node_p->ms_time_start) > now)
+		return MOTION_WAIT;
+
+	if(node_p->arrival != 0)
+	{
+		// First application, sampled at the output commit.  A keyframe
+		// due at the start of the movement is first applied on the next
+		// tick
+		TRACE(TRACE_KEYFRAME_START, actuator, node_p->position);
+		channel = ((actuator & 0xF0) == TRACE_MECCANO_SERVO) ?
+				  LATENCY_MECCANO : LATENCY_SERVO;
+		latencyMark(channel, latencyDue(channel, node_p->arrival,
+										now - (start_time + node_p->ms_time_start)));
+		node_p->arrival = 0;
+	}
+
+	if((start_time + node_p->ms_time_stop) <= now)
+	{
+		// Also when a tick was missed: the target is never skipped
+		*pos_p = node_p->position;
+		TRACE(TRACE_KEYFRAME_RETIRE, actuator, node_p->position);
+		listDelete(list_p, true);
+		TRACE(TRACE_QUEUE_DEPTH, actuator, listLength(list_p));
+		EVENT(EVENT_KEYFRAME, actuator, listLength(list_p));
+		return MOTION_DONE;
+	}
+
+	duration = node_p->ms_time_stop - node_p->ms_time_start;
+	remaining = start_time + node_p->ms_time_stop - now;
+	*pos_p = motionInterpolate(initial, node_p->position, duration, remaining);
+	return MOTION_MOVE;
+}
+
+
+//*****************************************************************************
+//
+// Advances every started servo movement to the given time, called every
+// millisecond.
+//
+//*****************************************************************************
+void motionTick(uint32_t now)
+{
+	int i;
+	uint32_t state;
+	uint32_t pos;
+	bool left_empty = true;
+	bool right_empty = true;
+	bool meccano_empty = true;
+
+	for(i = 0; i < 4; i++)
+	{
+		if(left_is_moving)
+		{
+			state = motionStep(&left_arm_list[i], left_mvmt_start_time, now,
+							   actual_pos[left_servo_not[i]], TRACE_LEFT_ARM | i, &pos);
+			if(state != MOTION_IDLE)
+				left_empty = false;
+			if(state == MOTION_DONE)
+				actual_pos[left_servo_not[i]] = pos;
+			if(state >= MOTION_MOVE)
+				setServoPosition(left_arm_servos[i], pos);
+		}
+		if(right_is_moving)
+		{
+			state = motionStep(&right_arm_list[i], right_mvmt_start_time, now,
+							   actual_pos[right_servo_not[i]], TRACE_RIGHT_ARM | i, &pos);
+			if(state != MOTION_IDLE)
+				right_empty = false;
+			if(state == MOTION_DONE)
+				actual_pos[right_servo_not[i]] = pos;
+			if(state >= MOTION_MOVE)
+				setServoPosition(right_arm_servos[i], pos);
+		}
+		if(meccano_is_moving)
+		{
+			state = motionStep(&meccano_servo_list[i], meccano_mvmt_start_time, now,
+							   meccano_actual_pos[i], TRACE_MECCANO_SERVO | i, &pos);
+			if(state != MOTION_IDLE)
+				meccano_empty = false;
+			if(state >= MOTION_MOVE)
+				setMeccanoServoPosition(i, pos);
+			if(state == MOTION_DONE)
+				meccano_actual_pos[i] = meccanoServoSetpoint[i];
+		}
+	}
+	if(left_is_moving && left_empty)
+	{
+		left_is_moving = false;
+		EVENT(EVENT_GROUP_DONE, 0x01, 0);
+	}
+	if(right_is_moving && right_empty)
+	{
+		right_is_moving = false;
+		EVENT(EVENT_GROUP_DONE, 0x02, 0);
+	}
+	if(meccano_is_moving && meccano_empty)
+	{
+		meccano_is_moving = false;
+		EVENT(EVENT_GROUP_DONE, 0x04, 0);
+	}
+}
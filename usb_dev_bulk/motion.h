@@ -0,0 +1,28 @@
+/*
+ * motion.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+
+#ifndef MOTION_H_
+#define MOTION_H_
+
+//*****************************************************************************
+//
+// State of an action list after a step.
+//
+//*****************************************************************************
+#define MOTION_IDLE					0		// no action left
+#define MOTION_WAIT					1		// first action not started yet
+#define MOTION_MOVE					2		// position on the way to the target
+#define MOTION_DONE					3		// target reached, action retired
+
+
+uint32_t motionInterpolate(uint32_t initial, uint32_t target,
+						   uint32_t duration, uint32_t remaining);
+uint32_t motionStep(struct list_s* list_p, uint32_t start_time, uint32_t now,
+					uint32_t initial, uint8_t actuator, uint32_t *pos_p);
+void motionTick(uint32_t now);
+
+#endif /* MOTION_H_ */
@@ -0,0 +1,131 @@
+/*
+ * profile.c
+ *
+ * Purpose:  Execution time of the interrupt handlers, measured with the
+ *           DWT cycle counter, and the share of the CPU they take.  The
+ *           main loop only polls, so the rest of the time is idle.
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "profile.h"
+
+
+struct isr_profile isrProfile[PROFILE_ISR_NBR];
+uint16_t profileLoad;
+uint16_t profileLoadPeak;
+
+static uint32_t busyCycles;			// spent in handlers in this window
+static uint32_t windowStart;
+
+
+//*****************************************************************************
+//
+// Integer base 2 logarithm.
+//
+//*****************************************************************************
+uint32_t profileLog2(uint32_t value)
+{
+	uint32_t result = 0;
+
+	if(value >= (1 << 16)) { value >>= 16; result += 16; }
+	if(value >= (1 << 8))  { value >>= 8;  result += 8; }
+	if(value >= (1 << 4))  { value >>= 4;  result += 4; }
+	if(value >= (1 << 2))  { value >>= 2;  result += 2; }
+	if(value >= (1 << 1))  { result += 1; }
+	return result;
+}
+
+
+//*****************************************************************************
+//
+// Starts the cycle counter.
+//
+//*****************************************************************************
+void profileInit(void)
+{
+	DEMCR_R |= DEMCR_TRCENA;
+	DWT_CYCCNT_R = 0;
+	DWT_CTRL_R |= DWT_CTRL_CYCCNTENA;
+	profileClear();
+}
+
+
+//*****************************************************************************
+//
+// Accounts one run of a handler that started at the cycle count start.
+//
+//*****************************************************************************
+void profileRecord(uint32_t id, uint32_t start)
+{
+	uint32_t cycles = DWT_CYCCNT_R - start;
+	struct isr_profile *p = &isrProfile[id];
+	uint32_t bin = profileLog2(cycles);
+
+	p->count++;
+	if(cycles < p->min)
+		p->min = cycles;
+	if(cycles > p->max)
+		p->max = cycles;
+	p->total += cycles;
+
+	bin = (bin < PROFILE_HIST_SHIFT) ? 0 : bin - PROFILE_HIST_SHIFT;
+	if(bin >= PROFILE_HIST_BINS)
+		bin = PROFILE_HIST_BINS - 1;
+	if(p->hist[bin] != 0xFFFF)
+		p->hist[bin]++;
+
+	busyCycles += cycles;
+}
+
+
+//*****************************************************************************
+//
+// Clears the statistics of every handler and the load peak.
+//
+//*****************************************************************************
+void profileClear(void)
+{
+	int i, j;
+
+	for(i = 0; i < PROFILE_ISR_NBR; i++)
+	{
+		isrProfile[i].count = 0;
+		isrProfile[i].min = 0xFFFFFFFF;
+		isrProfile[i].max = 0;
+		isrProfile[i].total = 0;
+		for(j = 0; j < PROFILE_HIST_BINS; j++)
+			isrProfile[i].hist[j] = 0;
+	}
+	profileLoadPeak = 0;
+}
+
+
+//*****************************************************************************
+//
+// Closes a load window every PROFILE_LOAD_WINDOW_MS, called every
+// millisecond.
+//
+//*****************************************************************************
+void profileUpdate(uint32_t ms_time)
+{
+	uint32_t now;
+	uint32_t elapsed;
+
+	if((ms_time % PROFILE_LOAD_WINDOW_MS) != 0)
+		return;
+
+	now = DWT_CYCCNT_R;
+	elapsed = now - windowStart;
+	if(elapsed != 0)
+	{
+		profileLoad = (uint16_t)(((uint64_t)busyCycles * 1000) / elapsed);
+		if(profileLoad > profileLoadPeak)
+			profileLoadPeak = profileLoad;
+	}
+	busyCycles = 0;
+	windowStart = now;
+}
@@ -0,0 +1,78 @@
+/*
+ * profile.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+//*****************************************************************************
+//
+// DWT cycle counter of the Cortex-M4, the host simulation counts its own
+// clock.
+//
+//*****************************************************************************
+#if defined(HAL_SIMULATION)
+extern volatile uint32_t simDwtCtrl;
+extern volatile uint32_t simDwtCyccnt;
+extern volatile uint32_t simDemcr;
+#define DWT_CTRL_R				simDwtCtrl
+#define DWT_CYCCNT_R			simDwtCyccnt
+#define DEMCR_R					simDemcr
+#else
+#define DWT_CTRL_R				(*((volatile uint32_t *)0xE0001000))
+#define DWT_CYCCNT_R			(*((volatile uint32_t *)0xE0001004))
+#define DEMCR_R					(*((volatile uint32_t *)0xE000EDFC))
+#endif
+#define DEMCR_TRCENA			0x01000000
+#define DWT_CTRL_CYCCNTENA		0x00000001
+
+//*****************************************************************************
+//
+// Profiled interrupt handlers.
+//
+//*****************************************************************************
+#define PROFILE_TIMER0			0		// millisecond tick and motion
+#define PROFILE_TIMER4			1		// Meccano bit timing
+#define PROFILE_MECCANO_PIN		2		// Meccano reply start bit
+#define PROFILE_TIMER5			3		// delay
+#define PROFILE_USB0			4		// USB and command processing
+#define PROFILE_ADC0			5		// current sensing
+#define PROFILE_ENCODER			6		// right wheel encoder
+#define PROFILE_ISR_NBR			7
+
+#define PROFILE_HIST_BINS		16		// bin n counts 2^(n+4) to 2^(n+5)-1 cycles
+#define PROFILE_HIST_SHIFT		4
+#define PROFILE_LOAD_WINDOW_MS	1000
+
+struct isr_profile {
+   uint32_t count;
+   uint32_t min;							// cycles
+   uint32_t max;
+   uint64_t total;
+   uint16_t hist[PROFILE_HIST_BINS];		// log2 histogram, saturates
+};
+
+extern struct isr_profile isrProfile[PROFILE_ISR_NBR];
+extern uint16_t profileLoad;				// interrupt load of the last window, per mille
+extern uint16_t profileLoadPeak;
+
+//*****************************************************************************
+//
+// Put PROFILE_ISR_ENTER() after the declarations of a handler and
+// PROFILE_ISR_EXIT() at its end.
+//
+//*****************************************************************************
+#define PROFILE_ISR_ENTER()		uint32_t ui32ProfileStart = DWT_CYCCNT_R
+#define PROFILE_ISR_EXIT(id)	profileRecord((id), ui32ProfileStart)
+
+
+void profileInit(void);
+void profileRecord(uint32_t id, uint32_t start);
+uint32_t profileLog2(uint32_t value);
+void profileClear(void);
+void profileUpdate(uint32_t ms_time);
+
+#endif /* PROFILE_H_ */
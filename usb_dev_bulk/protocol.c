@@ -0,0 +1,70 @@
+/*
+ * protocol.c
+ *
+ * Purpose:  Encoding of the values of the host protocol, most
+ *           significant byte first.
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+
+#include <stdint.h>
+
+#include "protocol.h"
+
+
+/*-----------------------------------------------------------------*/
+/* Function:   protocolPut16
+ * Purpose:    Writes a 16-bit value
+ * Input arg:  value = value to write
+ * In/out arg: p = position in the packet
+ * Return val: position after the value
+ */
+uint8_t* protocolPut16(uint8_t* p, uint16_t value)
+{
+    *p++ = (uint8_t)(value >> 8);
+    *p++ = (uint8_t)value;
+    return p;
+}
+
+
+/*-----------------------------------------------------------------*/
+/* Function:   protocolPut32
+ * Purpose:    Writes a 32-bit value
+ * Input arg:  value = value to write
+ * In/out arg: p = position in the packet
+ * Return val: position after the value
+ */
+uint8_t* protocolPut32(uint8_t* p, uint32_t value)
+{
+    *p++ = (uint8_t)(value >> 24);
+    *p++ = (uint8_t)(value >> 16);
+    *p++ = (uint8_t)(value >> 8);
+    *p++ = (uint8_t)value;
+    return p;
+}
+
+
+/*-----------------------------------------------------------------*/
+/* Function:   protocolGet16
+ * Purpose:    Reads a 16-bit value
+ * Input arg:  p = position of the value in the packet
+ * Return val: value
+ */
+uint16_t protocolGet16(const uint8_t* p)
+{
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+
+/*-----------------------------------------------------------------*/
+/* Function:   protocolGet32
+ * Purpose:    Reads a 32-bit value
+ * Input arg:  p = position of the value in the packet
+ * Return val: value
+ */
+uint32_t protocolGet32(const uint8_t* p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+           ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
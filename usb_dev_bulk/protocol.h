@@ -0,0 +1,87 @@
+/*
+ * protocol.h
+ *
+ * Purpose:  Opcodes of the host protocol and the encoding of its values,
+ *           shared by the firmware and the host programs.
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+
+#ifndef PROTOCOL_H_
+#define PROTOCOL_H_
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+//*****************************************************************************
+//
+// Command opcodes, the replies start with the opcode they answer.
+//
+//*****************************************************************************
+#define	DC_DIRECT_CMD			0x00
+#define	DC_MVMT_CMD				0x01
+#define	DC_START_MVMT_CMD		0x02
+#define	DC_CHARGE_MVMT_CMD		0x03
+#define	DC_GET_POSITION_CMD		0x04
+#define	DC_PID_CMD				0x05
+#define	DRIVE_VELOCITY_CMD		0x06
+#define	DRIVE_POSE_CMD			0x07
+#define	DRIVE_ODOMETRY_RESET_CMD	0x08
+#define	DC_SPEED_CMD			0x09
+#define	DC_PWM_CMD				0x0A
+#define	SERVO_DIRECT_CMD		0x10
+#define	SERVO_MVMT_CMD			0x11
+#define	SERVO_START_MVMT_CMD	0x12
+#define	SERVO_CHARGE_MVMT_CMD	0x13
+#define	SERVO_GET_POSITION_CMD	0x14
+#define	MECCANO_SERVO_POS_CMD	0x20
+#define	MECCANO_SERVO_LED_CMD	0x21
+#define	MECCANO_LED_CMD			0x22
+#define	MECCANO_LED_SEQ_CMD		0x23
+#define	MECCANO_SERVO_LED_SEQ_CMD	0x24
+#define	MECCANO_RECORD_CMD		0x25
+#define	MECCANO_GET_RECORD_CMD	0x26
+#define	MECCANO_REPLAY_CMD		0x27
+#define	MECCANO_GET_ERRORS_CMD	0x28
+#define	TELEMETRY_CMD			0x30
+#define	CURRENT_LIMIT_CMD		0x31
+#define	PROFILE_CMD				0x32
+#define	TRACE_CMD				0x33
+#define	LOG_CMD					0x34
+#define	METRICS_CMD				0x35
+#define	BENCH_CMD				0x36
+#define	PING_CMD				0x37
+#define	LATENCY_CMD				0x38
+#define	SEQ_CMD					0x39
+#define	EVENT_CMD				0x3A
+#define	TIME_CMD				0x3B
+#define	AT_CMD					0x3C
+
+//*****************************************************************************
+//
+// Messages sent without being asked for, from 0x80 on.
+//
+//*****************************************************************************
+#define	PROTOCOL_ASYNC_FIRST	0x80	// TELEMETRY_MSG, TRACE_MSG, LOG_MSG...
+
+//*****************************************************************************
+//
+// A transfer may carry several commands back to back, they are executed
+// in order.  Multi-byte values are sent most significant byte first.
+// A command preceded by SEQ_CMD [number] is acknowledged with ACK_MSG,
+// which also gives the room left for the next ones.
+//
+//*****************************************************************************
+
+uint8_t* protocolPut16(uint8_t* p, uint16_t value);
+uint8_t* protocolPut32(uint8_t* p, uint32_t value);
+uint16_t protocolGet16(const uint8_t* p);
+uint32_t protocolGet32(const uint8_t* p);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif /* PROTOCOL_H_ */
@@ -0,0 +1,135 @@
+/*
+ * record_ring.c
+ *
+ * Purpose:  Rings of records kept until the host has them, shared by the
+ *           log and the events.  Any handler can write a record, the
+ *           oldest one is dropped when the ring is full.  The main loop
+ *           sends them in packets while the USB buffer has room.
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "driverlib/interrupt.h"
+#include "usblib/usblib.h"
+#include "usblib/device/usbdevice.h"
+#include "usblib/device/usbdbulk.h"
+
+#include "usb_bulk_structs.h"
+#include "protocol.h"
+#include "record_ring.h"
+
+
+//*****************************************************************************
+//
+// Copies a record into the ring.  Can be called from a handler.
+//
+//*****************************************************************************
+void recordRingWrite(struct record_ring *ring_p, const void *record)
+{
+	bool masked;
+
+	masked = IntMasterDisable();
+	if((ring_p->head - ring_p->tail) == ring_p->size)
+	{
+		ring_p->tail++;
+		ring_p->lost++;
+	}
+	memcpy(&ring_p->records[(ring_p->head & (ring_p->size - 1)) * ring_p->recordSize],
+		   record, ring_p->recordSize);
+	ring_p->head++;
+	if(!masked)
+		IntMasterEnable();
+}
+
+
+//*****************************************************************************
+//
+// Drops the records not sent yet.
+//
+//*****************************************************************************
+void recordRingFlush(struct record_ring *ring_p)
+{
+	bool masked;
+
+	masked = IntMasterDisable();
+	ring_p->tail = ring_p->head;
+	ring_p->lost = 0;
+	if(!masked)
+		IntMasterEnable();
+}
+
+
+//*****************************************************************************
+//
+// Writes the header of a message in front of its records and queues it.
+// Returns the number of bytes queued, 0 when the USB buffer has no room.
+//
+//*****************************************************************************
+uint32_t recordPacketSend(uint8_t *packet, uint8_t msg, uint32_t count,
+						  uint32_t lost, uint8_t *end)
+{
+	packet[0] = msg;
+	packet[1] = (uint8_t)count;
+	protocolPut16(&packet[2], (lost > 0xFFFF) ? 0xFFFF : lost);
+	return USBSendPacket(packet, end - packet);
+}
+
+
+//*****************************************************************************
+//
+// Sends the records while the USB buffer has room, called from the main
+// loop.  The packet holds the header and perPacket records, the encoder
+// writes each record or skips it.
+//
+//*****************************************************************************
+void recordRingSend(struct record_ring *ring_p, uint8_t msg, uint8_t *packet,
+					uint32_t perPacket, record_encoder encode)
+{
+	bool masked;
+	uint32_t count;
+	uint32_t tail;
+	uint32_t lost;
+	uint8_t *p;
+	uint8_t *next;
+
+	while(ring_p->head != ring_p->tail)
+	{
+		p = &packet[RECORD_HEADER_SIZE];
+		count = 0;
+
+		masked = IntMasterDisable();
+		tail = ring_p->tail;
+		while((count < perPacket) && (tail != ring_p->head))
+		{
+			next = encode(p, &ring_p->records[(tail & (ring_p->size - 1)) *
+											  ring_p->recordSize]);
+			tail++;
+			if(next == p)
+				continue;
+			p = next;
+			count++;
+		}
+		lost = ring_p->lost;
+		if(count == 0)
+			ring_p->tail = tail;		// only skipped records were left
+		if(!masked)
+			IntMasterEnable();
+
+		if(count == 0)
+			return;
+
+		if(recordPacketSend(packet, msg, count, lost, p) == 0)
+			return;			// sent again on the next pass
+
+		// A writer may have dropped some of the records just sent
+		masked = IntMasterDisable();
+		if((int32_t)(tail - ring_p->tail) > 0)
+			ring_p->tail = tail;
+		ring_p->lost -= lost;
+		if(!masked)
+			IntMasterEnable();
+	}
+}
@@ -0,0 +1,46 @@
+/*
+ * record_ring.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+
+#ifndef RECORD_RING_H_
+#define RECORD_RING_H_
+
+//*****************************************************************************
+//
+// Ring of fixed-size records written by the handlers and sent to the host
+// by the main loop.  Messages built from a ring start with a 4-byte
+// header: message ID, record count, records lost (2 bytes).
+//
+//*****************************************************************************
+#define RECORD_HEADER_SIZE			4
+
+struct record_ring {
+   uint8_t *records;						// size * recordSize bytes
+   uint32_t size;							// records, power of 2
+   uint32_t recordSize;						// bytes
+   uint32_t head;							// next record written
+   uint32_t tail;							// next record sent
+   uint32_t lost;
+};
+
+#define RECORD_RING(records, size)	{(uint8_t *)(records), (size), sizeof((records)[0]), 0, 0, 0}
+
+//*****************************************************************************
+//
+// Writes a record into a message, returns the position after it, or p to
+// skip the record.
+//
+//*****************************************************************************
+typedef uint8_t *(*record_encoder)(uint8_t *p, const void *record);
+
+void recordRingWrite(struct record_ring *ring_p, const void *record);
+void recordRingFlush(struct record_ring *ring_p);
+void recordRingSend(struct record_ring *ring_p, uint8_t msg, uint8_t *packet,
+					uint32_t perPacket, record_encoder encode);
+uint32_t recordPacketSend(uint8_t *packet, uint8_t msg, uint32_t count,
+						  uint32_t lost, uint8_t *end);
+
+#endif /* RECORD_RING_H_ */
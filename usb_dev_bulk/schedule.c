@@ -0,0 +1,123 @@
+/*
+ * schedule.c
+ *
+ * Purpose:  Deferred execution of the commands sent with an execution
+ *           time.  They wait here, sorted by time, and the millisecond
+ *           tick runs them before the motion is advanced, so that the
+ *           USB jitter does not reach the actuators and several boards
+ *           synchronised on the host clock act together.
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "command.h"
+#include "schedule.h"
+
+
+struct sched_entry {
+   uint32_t time;					// ms
+   uint32_t size;					// 0 when the entry is free
+   uint8_t cmd[SCHED_CMD_MAX];
+};
+
+static struct sched_entry schedPool[SCHED_SIZE];
+static uint8_t schedOrder[SCHED_SIZE];		// pool indexes, by time
+static uint32_t schedCount = 0;
+static uint8_t schedRun[SCHED_CMD_MAX];	// command being executed
+
+
+/*-----------------------------------------------------------------*/
+/* Function:   schedAdd
+ * Purpose:    Queue commands to be executed at a given time, after the
+ *             ones already queued for the same time
+ * Input arg:  time = execution time (ms), a past time runs at the next tick
+ *             cmd_p = one or more commands, back to back
+ *             size = number of bytes, 1 to SCHED_CMD_MAX
+ * Return val: false if the queue is full
+ */
+bool schedAdd(uint32_t time, const uint8_t *cmd_p, uint32_t size)
+{
+	uint32_t i;
+	uint32_t slot;
+	uint32_t pos;
+
+	if(schedCount == SCHED_SIZE)
+		return false;
+	for(slot = 0; schedPool[slot].size != 0; slot++)
+		;
+	schedPool[slot].time = time;
+	schedPool[slot].size = size;
+	for(i = 0; i < size; i++)
+		schedPool[slot].cmd[i] = cmd_p[i];
+
+	pos = schedCount;
+	while((pos > 0) &&
+		  ((int32_t)(schedPool[schedOrder[pos - 1]].time - time) > 0))
+	{
+		schedOrder[pos] = schedOrder[pos - 1];
+		pos--;
+	}
+	schedOrder[pos] = slot;
+	schedCount++;
+	return true;
+}
+
+
+//*****************************************************************************
+//
+// Drops every queued command.
+//
+//*****************************************************************************
+void schedFlush(void)
+{
+	uint32_t i;
+
+	for(i = 0; i < SCHED_SIZE; i++)
+		schedPool[i].size = 0;
+	schedCount = 0;
+}
+
+
+//*****************************************************************************
+//
+// Number of commands that can still be queued.
+//
+//*****************************************************************************
+uint32_t schedFree(void)
+{
+	return SCHED_SIZE - schedCount;
+}
+
+
+//*****************************************************************************
+//
+// Executes the commands that are due, called every millisecond.  The entry
+// is released before its commands run, they may queue new ones.
+//
+//*****************************************************************************
+void schedTick(uint32_t now)
+{
+	uint32_t i;
+	uint32_t size;
+	struct sched_entry *entry_p;
+
+	while(schedCount != 0)
+	{
+		entry_p = &schedPool[schedOrder[0]];
+		if((int32_t)(now - entry_p->time) < 0)
+			return;
+
+		size = entry_p->size;
+		for(i = 0; i < size; i++)
+			schedRun[i] = entry_p->cmd[i];
+		entry_p->size = 0;
+		schedCount--;
+		for(i = 0; i < schedCount; i++)
+			schedOrder[i] = schedOrder[i + 1];
+
+		CommandDeferred(schedRun, size);
+	}
+}
@@ -0,0 +1,20 @@
+/*
+ * schedule.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+
+#ifndef SCHEDULE_H_
+#define SCHEDULE_H_
+
+#define SCHED_SIZE				8		// commands waiting at most
+#define SCHED_CMD_MAX			58		// bytes of a command, AT_CMD fits a packet
+
+
+bool schedAdd(uint32_t time, const uint8_t *cmd_p, uint32_t size);
+void schedFlush(void);
+uint32_t schedFree(void);
+void schedTick(uint32_t now);
+
+#endif /* SCHEDULE_H_ */
@@ -0,0 +1,113 @@
+/*
+ * telemetry.c
+ *
+ * Purpose:  Periodic telemetry packets, built and queued from the main
+ *           loop so that the interrupt handlers only update variables.
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include "driverlib/interrupt.h"
+#include "usblib/usblib.h"
+#include "usblib/device/usbdevice.h"
+#include "usblib/device/usbdbulk.h"
+
+#include "usb_bulk_structs.h"
+#include "protocol.h"
+#include "timer_handler.h"
+#include "dc_drive.h"
+#include "current_sense.h"
+#include "linked_list_dbl.h"
+#include "memory.h"
+#include "telemetry.h"
+
+
+uint32_t telemetryPeriod = 0;
+uint32_t telemetryChannels = 0;
+
+static uint32_t lastTelemetry;
+static uint8_t telemetryBuffer[64];
+
+
+//*****************************************************************************
+//
+// Sets the telemetry rate and channels.  A zero period stops it.
+//
+//*****************************************************************************
+void setTelemetry(uint32_t period, uint32_t channels)
+{
+	telemetryChannels = channels;
+	telemetryPeriod = period;
+	lastTelemetry = milli_second;
+}
+
+
+//*****************************************************************************
+//
+// Sends a telemetry packet when its period has elapsed, called from the
+// main loop.
+//
+//*****************************************************************************
+void telemetryProcess(void)
+{
+	uint8_t *p = telemetryBuffer;
+	struct drive_pose pose;
+	float v, omega;
+	bool masked;
+	int i;
+
+	if((telemetryPeriod == 0) || ((milli_second - lastTelemetry) < telemetryPeriod))
+		return;
+	lastTelemetry += telemetryPeriod;
+	if((milli_second - lastTelemetry) >= telemetryPeriod)
+		lastTelemetry = milli_second;	// fell behind, do not send a burst
+
+	*p++ = TELEMETRY_MSG;
+	p = protocolPut32(p, milli_second);
+
+	if(telemetryChannels & TELEMETRY_ODOMETRY)
+	{
+		// Take the pose of a single odometry step
+		masked = IntMasterDisable();
+		pose = drivePose;
+		v = driveVelocity;
+		omega = driveOmega;
+		if(!masked)
+			IntMasterEnable();
+
+		*p++ = TELEMETRY_ODOMETRY;
+		*p++ = 16;
+		p = protocolPut32(p, (uint32_t)(int32_t)pose.x);
+		p = protocolPut32(p, (uint32_t)(int32_t)pose.y);
+		p = protocolPut32(p, (uint32_t)(int32_t)(pose.theta * 1000.0f));
+		p = protocolPut16(p, (uint16_t)(int16_t)v);
+		p = protocolPut16(p, (uint16_t)(int16_t)(omega * 1000.0f));
+	}
+
+	if(telemetryChannels & TELEMETRY_CURRENT)
+	{
+		*p++ = TELEMETRY_CURRENT;
+		*p++ = 4 * CURRENT_CHANNEL_NBR;
+		for(i = 0; i < CURRENT_CHANNEL_NBR; i++)
+			p = protocolPut16(p, currentMilliAmp[i]);
+		for(i = 0; i < CURRENT_CHANNEL_NBR; i++)
+			p = protocolPut16(p, currentTrips[i]);
+	}
+
+	if(telemetryChannels & TELEMETRY_MEMORY)
+	{
+		*p++ = TELEMETRY_MEMORY;
+		*p++ = 14;
+		p = protocolPut16(p, stackSize);
+		p = protocolPut16(p, stackPeak);
+		p = protocolPut16(p, heapSize);
+		p = protocolPut16(p, listNodesUsed);
+		p = protocolPut16(p, listNodesPeak);
+		p = protocolPut16(p, listAllocFailures);
+		p = protocolPut16(p, sizeof(struct list_node_s));
+	}
+
+	USBSendPacket(telemetryBuffer, p - telemetryBuffer);
+}
@@ -0,0 +1,41 @@
+/*
+ * telemetry.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+//*****************************************************************************
+//
+// Telemetry packets are sent to the host without being asked for:
+//   TELEMETRY_MSG, time (ms, 4 bytes), then one block per channel made of
+//   the channel ID, the data length and the data.
+// Multi-byte values are sent most significant byte first.
+//
+//*****************************************************************************
+#define TELEMETRY_MSG				0x80
+
+//*****************************************************************************
+//
+// Channel IDs, also the bits of the channel mask.
+//
+//*****************************************************************************
+#define TELEMETRY_ODOMETRY			0x01	// x, y (mm), theta (mrad) 4 bytes each,
+											// v (mm/s), omega (mrad/s) 2 bytes each
+#define TELEMETRY_CURRENT			0x02	// left, right, servo current (mA),
+											// then their foldback counts, 2 bytes each
+#define TELEMETRY_MEMORY			0x04	// stack size, stack peak, heap size (bytes),
+											// list nodes used, peak and refused,
+											// node size (bytes), 2 bytes each
+
+extern uint32_t telemetryPeriod;			// ms between two packets, 0 if off
+extern uint32_t telemetryChannels;			// mask of the channels sent
+
+
+void setTelemetry(uint32_t period, uint32_t channels);
+void telemetryProcess(void);
+
+#endif /* TELEMETRY_H_ */
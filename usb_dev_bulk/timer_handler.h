@@ -1,17 +1,17 @@
-/*
- * timer_handler.h
- *
- *  Created on: 17 dc. 2017
- *      Author: macload1
- */
-
-#ifndef TIMER_HANDLER_H_
-#define TIMER_HANDLER_H_
-
-// millisecond tick since start-up
-extern uint32_t milli_second;
-
-void timerInit(void);
-
-
-#endif /* TIMER_HANDLER_H_ */
+/*
+ * timer_handler.h
+ *
+ *  Created on: 17 dc. 2017
+ *      Author: macload1
+ */
+
+#ifndef TIMER_HANDLER_H_
+#define TIMER_HANDLER_H_
+
+// millisecond tick since start-up
+extern uint32_t milli_second;
+
+void timerInit(void);
+
+
+#endif /* TIMER_HANDLER_H_ */
@@ -0,0 +1,160 @@
+/*
+ * trace.c
+ *
+ * Purpose:  Ring of binary trace events.  Any handler, or the main loop,
+ *           can add an event without masking interrupts: the slot is
+ *           reserved with an exclusive increment of the head and the
+ *           event is published by writing its sequence number last.  The
+ *           main loop is the only reader and sends the events to the host.
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include "profile.h"
+#include "protocol.h"
+#include "record_ring.h"
+#include "trace.h"
+
+
+struct trace_event {
+   uint32_t seq;				// index of the event plus one, written last
+   uint32_t cycles;
+   uint8_t id;
+   uint8_t arg8;
+   uint16_t arg16;
+};
+
+uint32_t traceMask = 0;
+
+static volatile struct trace_event traceRing[TRACE_SIZE];
+static volatile uint32_t traceHead = 0;		// next index to reserve
+static uint32_t traceTail = 0;				// next index to send
+static uint32_t traceLost = 0;
+static uint8_t tracePacket[RECORD_HEADER_SIZE + 8 * TRACE_EVENTS_PER_PACKET];
+
+
+//*****************************************************************************
+//
+// Reserves the next index of the ring.
+//
+//*****************************************************************************
+static uint32_t traceReserve(void)
+{
+	uint32_t index;
+
+#if defined(__TI_COMPILER_VERSION__)
+	do
+	{
+		index = __ldrex((void *)&traceHead);
+	} while(__strex(index + 1, (void *)&traceHead) != 0);
+#else
+	index = __sync_fetch_and_add(&traceHead, 1);
+#endif
+	return index;
+}
+
+
+//*****************************************************************************
+//
+// Records an event, use the TRACE() macro to honour the trace mask.
+//
+//*****************************************************************************
+void traceEvent(uint8_t id, uint8_t arg8, uint16_t arg16)
+{
+	uint32_t index = traceReserve();
+	volatile struct trace_event *event_p = &traceRing[index & (TRACE_SIZE - 1)];
+
+	event_p->cycles = DWT_CYCCNT_R;
+	event_p->id = id;
+	event_p->arg8 = arg8;
+	event_p->arg16 = arg16;
+	event_p->seq = index + 1;
+}
+
+
+//*****************************************************************************
+//
+// Selects the categories recorded.  Turning the trace on drops the events
+// recorded before.
+//
+//*****************************************************************************
+void setTraceMask(uint32_t mask)
+{
+	if(traceMask == 0)
+	{
+		traceTail = traceHead;
+		traceLost = 0;
+	}
+	traceMask = mask;
+}
+
+
+//*****************************************************************************
+//
+// Sends the recorded events while the USB buffer has room, called from the
+// main loop.
+//
+//*****************************************************************************
+void traceProcess(void)
+{
+	uint32_t head;
+	uint32_t tail;
+	uint32_t count;
+	uint8_t *p;
+	struct trace_event event;
+
+	while(traceMask != 0)
+	{
+		head = traceHead;
+		if((head - traceTail) > TRACE_SIZE)
+		{
+			// The writers went round the ring
+			traceLost += head - traceTail - TRACE_SIZE;
+			traceTail = head - TRACE_SIZE;
+		}
+		if(head == traceTail)
+			return;
+
+		p = &tracePacket[RECORD_HEADER_SIZE];
+		tail = traceTail;
+		count = 0;
+		while((count < TRACE_EVENTS_PER_PACKET) && (tail != head))
+		{
+			volatile struct trace_event *event_p = &traceRing[tail & (TRACE_SIZE - 1)];
+
+			event.seq = event_p->seq;
+			if(event.seq != tail + 1)
+				break;		// still being written
+			event.cycles = event_p->cycles;
+			event.id = event_p->id;
+			event.arg8 = event_p->arg8;
+			event.arg16 = event_p->arg16;
+			if((traceHead - tail) > TRACE_SIZE)
+			{
+				// A writer took the slot back while it was read
+				traceLost++;
+				tail++;
+				continue;
+			}
+
+			*p++ = event.id;
+			*p++ = event.arg8;
+			p = protocolPut16(p, event.arg16);
+			p = protocolPut32(p, event.cycles);
+			tail++;
+			count++;
+		}
+		if(count == 0)
+		{
+			traceTail = tail;
+			return;
+		}
+
+		if(recordPacketSend(tracePacket, TRACE_MSG, count, traceLost, p) == 0)
+			return;			// sent again on the next pass
+		traceTail = tail;
+		traceLost = 0;
+	}
+}
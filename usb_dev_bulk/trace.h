@@ -0,0 +1,65 @@
+/*
+ * trace.h
+ *
+ *  Created on: 19 oct. 2026
+ *      Author: macload1
+ */
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+//*****************************************************************************
+//
+// Trace events.  The high nibble of an ID is its category, bit
+// (nibble - 1) of the trace mask.
+//
+//*****************************************************************************
+#define TRACE_CAT_COMMAND			0x01
+#define TRACE_CAT_KEYFRAME			0x02
+#define TRACE_CAT_MECCANO			0x04
+#define TRACE_CAT_PWM				0x08
+#define TRACE_CAT_QUEUE				0x10
+
+									// arg8, arg16
+#define TRACE_COMMAND				0x10	// opcode, bytes available
+#define TRACE_KEYFRAME_START		0x20	// actuator, target
+#define TRACE_KEYFRAME_RETIRE		0x21	// actuator, target
+#define TRACE_MECCANO_FRAME			0x30	// module asked to reply, frame number
+#define TRACE_MECCANO_REPLY			0x31	// module, reply
+#define TRACE_MECCANO_TIMEOUT		0x32	// module, 1 if retried
+#define TRACE_PWM_COMMIT			0x40	// actuator, pulse width or speed
+#define TRACE_QUEUE_DEPTH			0x50	// actuator, actions left
+
+//*****************************************************************************
+//
+// Actuator IDs: group in the high nibble, index in the low one.
+//
+//*****************************************************************************
+#define TRACE_LEFT_ARM				0x00
+#define TRACE_RIGHT_ARM				0x10
+#define TRACE_MECCANO_SERVO			0x20
+#define TRACE_DC_MOTOR				0x30
+#define TRACE_SERVO_OUTPUT			0x40	// PWM0 output, for the pulse widths
+
+//*****************************************************************************
+//
+// Trace packets sent to the host while the trace is on:
+//   TRACE_MSG, event count, events lost (2 bytes), then per event the ID,
+//   arg8, arg16 (2 bytes) and the cycle counter (4 bytes).
+//
+//*****************************************************************************
+#define TRACE_MSG					0x81
+#define TRACE_SIZE					256		// events, power of 2
+#define TRACE_EVENTS_PER_PACKET		7
+
+extern uint32_t traceMask;					// categories recorded, 0 if off
+
+#define TRACE(id, arg8, arg16)		do { if(traceMask & (1 << (((id) >> 4) - 1))) \
+										traceEvent((id), (arg8), (arg16)); } while(0)
+
+
+void traceEvent(uint8_t id, uint8_t arg8, uint16_t arg16);
+void setTraceMask(uint32_t mask);
+void traceProcess(void);
+
+#endif /* TRACE_H_ */